@@ -0,0 +1,77 @@
+// Canvas XY to (output, LED index) for strip walls without a panel layout,
+// specialized per flip/scan-order/serpentine combination. The geometry comes
+// in as a template argument with static accessors, so the firmware reads its
+// globals directly and the native tests can supply their own.
+#pragma once
+
+#include <stdint.h>
+
+typedef bool (*MatrixMapXYFn)(uint16_t x, uint8_t y, uint8_t &output, uint16_t &index);
+
+// One instantiation per flip/scan-order combination, so the layout branches
+// fold away at compile time. FixedHeight is the row count of every output
+// when they all share it, 0 otherwise.
+//
+// Geometry provides: width(), height(), activeOutputs(), xOffset(output)
+// (first canvas column of output, with xOffset(activeOutputs()) the end),
+// outputWidth(output), outputHeight(output) and outputLeds(output).
+template <class Geometry, bool XFlip, bool YFlip, bool ColumnMajor, bool Serpentine, uint8_t FixedHeight>
+bool mapMatrixXYAs(uint16_t x, uint8_t y, uint8_t &output, uint16_t &index) {
+  const uint16_t canvasWidth = Geometry::width();
+  const uint8_t canvasHeight = FixedHeight != 0 ? FixedHeight : Geometry::height();
+  if (canvasWidth == 0 || x >= canvasWidth || y >= canvasHeight) {
+    return false;
+  }
+
+  uint16_t mappedX = XFlip ? (canvasWidth - 1 - x) : x;
+  const uint8_t mappedY = YFlip ? (canvasHeight - 1 - y) : y;
+
+  const uint8_t activeOutputs = Geometry::activeOutputs();
+  output = 0;
+  while (output < activeOutputs && mappedX >= Geometry::xOffset(output + 1)) {
+    output++;
+  }
+  if (output >= activeOutputs) {
+    return false;
+  }
+
+  uint16_t localX = static_cast<uint16_t>(mappedX - Geometry::xOffset(output));
+  const uint16_t outputWidth = Geometry::outputWidth(output);
+  if (outputWidth == 0 || localX >= outputWidth) {
+    return false;
+  }
+  const uint8_t outputHeight = FixedHeight != 0 ? FixedHeight : Geometry::outputHeight(output);
+  if (FixedHeight == 0 && mappedY >= outputHeight) {
+    return false;
+  }
+
+  uint8_t localY = mappedY;
+  if (ColumnMajor) {
+    if (Serpentine && ((localX & 0x01) != 0)) {
+      localY = outputHeight - 1 - localY;
+    }
+    index = static_cast<uint16_t>(localX) * outputHeight + localY;
+  } else {
+    if (Serpentine && ((localY & 0x01) != 0)) {
+      localX = outputWidth - 1 - localX;
+    }
+    index = static_cast<uint16_t>(localY) * outputWidth + localX;
+  }
+  return index < Geometry::outputLeds(output);
+}
+
+// Indexed by xFlip | yFlip << 1 | columnMajor << 2.
+template <class Geometry, bool Serpentine, uint8_t FixedHeight>
+MatrixMapXYFn matrixMapXYVariant(uint8_t variant) {
+  static const MatrixMapXYFn kVariants[8] = {
+    mapMatrixXYAs<Geometry, false, false, false, Serpentine, FixedHeight>,
+    mapMatrixXYAs<Geometry, true, false, false, Serpentine, FixedHeight>,
+    mapMatrixXYAs<Geometry, false, true, false, Serpentine, FixedHeight>,
+    mapMatrixXYAs<Geometry, true, true, false, Serpentine, FixedHeight>,
+    mapMatrixXYAs<Geometry, false, false, true, Serpentine, FixedHeight>,
+    mapMatrixXYAs<Geometry, true, false, true, Serpentine, FixedHeight>,
+    mapMatrixXYAs<Geometry, false, true, true, Serpentine, FixedHeight>,
+    mapMatrixXYAs<Geometry, true, true, true, Serpentine, FixedHeight>,
+  };
+  return kVariants[variant & 0x07];
+}
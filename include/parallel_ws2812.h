@@ -0,0 +1,67 @@
+// WS2812 encoder for the 8-lane i80 parallel output. Pure byte shuffling with
+// no hardware access, so the native test env can check it on the host.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// WS2812 bit = 3 slots of 1/2.4 MHz: high, data, low. One bus byte carries the
+// same slot for all 8 lanes, so each LED costs 24 bits * 3 slots = 72 bytes.
+static const uint8_t kParallelLaneCount = 8;
+static const uint8_t kParallelChannelsPerLed = 3;
+static const uint8_t kParallelSlotsPerBit = 3;
+static const size_t kParallelBytesPerLed = kParallelChannelsPerLed * 8 * kParallelSlotsPerBit;
+static const size_t kParallelResetBytes = 720;  // 300 us low latch at 2.4 MHz.
+
+static inline void encodeParallelWs2812Byte(uint64_t lanes, uint8_t laneMask, uint8_t *out) {
+  // 8x8 bit transpose: afterwards byte k holds bit k of every lane, with
+  // lane n in bit n, i.e. exactly one bus byte per WS2812 data slot.
+  uint64_t t = (lanes ^ (lanes >> 7)) & 0x00AA00AA00AA00AAULL;
+  lanes = lanes ^ t ^ (t << 7);
+  t = (lanes ^ (lanes >> 14)) & 0x0000CCCC0000CCCCULL;
+  lanes = lanes ^ t ^ (t << 14);
+  t = (lanes ^ (lanes >> 28)) & 0x00000000F0F0F0F0ULL;
+  lanes = lanes ^ t ^ (t << 28);
+
+  for (int8_t bit = 7; bit >= 0; bit--) {
+    out[0] = laneMask;
+    out[1] = static_cast<uint8_t>(lanes >> (bit * 8));
+    out[2] = 0;
+    out += kParallelSlotsPerBit;
+  }
+}
+
+// Encodes ledCount LEDs of up to 8 lanes plus the reset tail into out, which
+// must hold ledCount * kParallelBytesPerLed + kParallelResetBytes bytes.
+// Returns the number of bytes written.
+static inline size_t encodeParallelWs2812Frame(const uint8_t *const lanes[kParallelLaneCount],
+                                               const uint16_t counts[kParallelLaneCount],
+                                               uint16_t ledCount,
+                                               const uint8_t *const luts[kParallelLaneCount],
+                                               uint8_t *out) {
+  uint8_t *cursor = out;
+  for (uint16_t led = 0; led < ledCount; led++) {
+    uint8_t laneMask = 0;
+    uint64_t channels[kParallelChannelsPerLed] = {0};
+    const size_t offset = static_cast<size_t>(led) * kParallelChannelsPerLed;
+    for (uint8_t lane = 0; lane < kParallelLaneCount; lane++) {
+      // Shorter outputs stay idle low once their own LEDs are sent.
+      if (lanes[lane] == nullptr || led >= counts[lane]) {
+        continue;
+      }
+      laneMask |= static_cast<uint8_t>(1U << lane);
+      const uint8_t *lut = luts[lane];
+      for (uint8_t channel = 0; channel < kParallelChannelsPerLed; channel++) {
+        channels[channel] |= static_cast<uint64_t>(lut[lanes[lane][offset + channel]]) << (lane * 8);
+      }
+    }
+    for (uint8_t channel = 0; channel < kParallelChannelsPerLed; channel++) {
+      encodeParallelWs2812Byte(channels[channel], laneMask, cursor);
+      cursor += 8 * kParallelSlotsPerBit;
+    }
+  }
+  memset(cursor, 0, kParallelResetBytes);
+  cursor += kParallelResetBytes;
+  return static_cast<size_t>(cursor - out);
+}
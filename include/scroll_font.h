@@ -0,0 +1,98 @@
+// Generated by tools/build_scroll_font.py; edit the glyph art there.
+// 191 glyphs (ASCII + Latin-1), 39 kerning pairs, 1435 bytes.
+#pragma once
+
+#include <stdint.h>
+
+static const uint8_t kScrollFont[] = {
+  0x01, 0x08, 0x01, 0x02, 0xBF, 0x00, 0x27, 0x00, 0x1F, 0x00, 0x20, 0x00, 0x5F, 0x00, 0x00, 0x00,
+  0xA0, 0x00, 0x60, 0x00, 0x5F, 0x00, 0x00, 0x00, 0x02, 0x00, 0x03, 0x00, 0x06, 0x00, 0x0B, 0x00,
+  0x10, 0x00, 0x15, 0x00, 0x1A, 0x00, 0x1B, 0x00, 0x1D, 0x00, 0x1F, 0x00, 0x24, 0x00, 0x29, 0x00,
+  0x2B, 0x00, 0x30, 0x00, 0x31, 0x00, 0x36, 0x00, 0x3B, 0x00, 0x3E, 0x00, 0x43, 0x00, 0x48, 0x00,
+  0x4D, 0x00, 0x52, 0x00, 0x57, 0x00, 0x5C, 0x00, 0x61, 0x00, 0x66, 0x00, 0x67, 0x00, 0x69, 0x00,
+  0x6C, 0x00, 0x70, 0x00, 0x73, 0x00, 0x78, 0x00, 0x7D, 0x00, 0x82, 0x00, 0x87, 0x00, 0x8C, 0x00,
+  0x91, 0x00, 0x96, 0x00, 0x9B, 0x00, 0xA0, 0x00, 0xA5, 0x00, 0xAA, 0x00, 0xAF, 0x00, 0xB4, 0x00,
+  0xB9, 0x00, 0xBE, 0x00, 0xC3, 0x00, 0xC8, 0x00, 0xCD, 0x00, 0xD2, 0x00, 0xD7, 0x00, 0xDC, 0x00,
+  0xE1, 0x00, 0xE6, 0x00, 0xEB, 0x00, 0xF0, 0x00, 0xF5, 0x00, 0xFA, 0x00, 0xFF, 0x00, 0x02, 0x01,
+  0x07, 0x01, 0x0A, 0x01, 0x0D, 0x01, 0x12, 0x01, 0x14, 0x01, 0x19, 0x01, 0x1E, 0x01, 0x23, 0x01,
+  0x28, 0x01, 0x2D, 0x01, 0x31, 0x01, 0x36, 0x01, 0x3B, 0x01, 0x3E, 0x01, 0x42, 0x01, 0x46, 0x01,
+  0x49, 0x01, 0x4E, 0x01, 0x53, 0x01, 0x58, 0x01, 0x5D, 0x01, 0x62, 0x01, 0x67, 0x01, 0x6C, 0x01,
+  0x70, 0x01, 0x75, 0x01, 0x7A, 0x01, 0x7F, 0x01, 0x84, 0x01, 0x89, 0x01, 0x8E, 0x01, 0x91, 0x01,
+  0x92, 0x01, 0x95, 0x01, 0x9A, 0x01, 0x9C, 0x01, 0x9D, 0x01, 0xA1, 0x01, 0xA6, 0x01, 0xAB, 0x01,
+  0xB0, 0x01, 0xB1, 0x01, 0xB5, 0x01, 0xB8, 0x01, 0xBD, 0x01, 0xC0, 0x01, 0xC4, 0x01, 0xC8, 0x01,
+  0xCB, 0x01, 0xD0, 0x01, 0xD4, 0x01, 0xD7, 0x01, 0xDC, 0x01, 0xDF, 0x01, 0xE2, 0x01, 0xE4, 0x01,
+  0xE8, 0x01, 0xED, 0x01, 0xEE, 0x01, 0xF0, 0x01, 0xF2, 0x01, 0xF5, 0x01, 0xF9, 0x01, 0xFE, 0x01,
+  0x03, 0x02, 0x08, 0x02, 0x0D, 0x02, 0x12, 0x02, 0x17, 0x02, 0x1C, 0x02, 0x21, 0x02, 0x26, 0x02,
+  0x2B, 0x02, 0x30, 0x02, 0x35, 0x02, 0x3A, 0x02, 0x3F, 0x02, 0x44, 0x02, 0x49, 0x02, 0x4E, 0x02,
+  0x53, 0x02, 0x58, 0x02, 0x5D, 0x02, 0x62, 0x02, 0x67, 0x02, 0x6C, 0x02, 0x71, 0x02, 0x76, 0x02,
+  0x7B, 0x02, 0x80, 0x02, 0x83, 0x02, 0x88, 0x02, 0x8D, 0x02, 0x92, 0x02, 0x97, 0x02, 0x9C, 0x02,
+  0xA1, 0x02, 0xA6, 0x02, 0xAA, 0x02, 0xAF, 0x02, 0xB4, 0x02, 0xB9, 0x02, 0xBE, 0x02, 0xC3, 0x02,
+  0xC8, 0x02, 0xCD, 0x02, 0xD2, 0x02, 0xD7, 0x02, 0xDC, 0x02, 0xE1, 0x02, 0xE6, 0x02, 0xE9, 0x02,
+  0xEC, 0x02, 0xEF, 0x02, 0xF2, 0x02, 0xF7, 0x02, 0xFC, 0x02, 0x01, 0x03, 0x06, 0x03, 0x0B, 0x03,
+  0x10, 0x03, 0x15, 0x03, 0x1A, 0x03, 0x1F, 0x03, 0x24, 0x03, 0x29, 0x03, 0x2E, 0x03, 0x33, 0x03,
+  0x38, 0x03, 0x3D, 0x03, 0x42, 0x03, 0x21, 0x00, 0x34, 0x00, 0xFF, 0x21, 0x00, 0x36, 0x00, 0xFF,
+  0x21, 0x00, 0x37, 0x00, 0xFF, 0x21, 0x00, 0x39, 0x00, 0xFF, 0x26, 0x00, 0x0C, 0x00, 0xFE, 0x26,
+  0x00, 0x0E, 0x00, 0xFF, 0x2C, 0x00, 0x34, 0x00, 0xFE, 0x2C, 0x00, 0x36, 0x00, 0xFE, 0x2C, 0x00,
+  0x39, 0x00, 0xFE, 0x30, 0x00, 0x0C, 0x00, 0xFE, 0x30, 0x00, 0x0E, 0x00, 0xFF, 0x34, 0x00, 0x0C,
+  0x00, 0xFE, 0x34, 0x00, 0x0E, 0x00, 0xFF, 0x34, 0x00, 0x21, 0x00, 0xFF, 0x34, 0x00, 0x41, 0x00,
+  0xFE, 0x34, 0x00, 0x43, 0x00, 0xFE, 0x34, 0x00, 0x45, 0x00, 0xFE, 0x34, 0x00, 0x4F, 0x00, 0xFE,
+  0x34, 0x00, 0x53, 0x00, 0xFE, 0x34, 0x00, 0x55, 0x00, 0xFF, 0x34, 0x00, 0x59, 0x00, 0xFF, 0x36,
+  0x00, 0x0C, 0x00, 0xFE, 0x36, 0x00, 0x0E, 0x00, 0xFF, 0x36, 0x00, 0x21, 0x00, 0xFF, 0x36, 0x00,
+  0x41, 0x00, 0xFF, 0x36, 0x00, 0x45, 0x00, 0xFF, 0x36, 0x00, 0x4F, 0x00, 0xFF, 0x37, 0x00, 0x21,
+  0x00, 0xFF, 0x39, 0x00, 0x0C, 0x00, 0xFE, 0x39, 0x00, 0x0E, 0x00, 0xFF, 0x39, 0x00, 0x21, 0x00,
+  0xFF, 0x39, 0x00, 0x41, 0x00, 0xFE, 0x39, 0x00, 0x45, 0x00, 0xFE, 0x39, 0x00, 0x4F, 0x00, 0xFE,
+  0x46, 0x00, 0x41, 0x00, 0xFE, 0x46, 0x00, 0x45, 0x00, 0xFF, 0x46, 0x00, 0x4F, 0x00, 0xFF, 0x52,
+  0x00, 0x0C, 0x00, 0xFE, 0x52, 0x00, 0x0E, 0x00, 0xFF, 0x00, 0x00, 0x5E, 0x06, 0x00, 0x06, 0x14,
+  0x3E, 0x14, 0x3E, 0x14, 0x24, 0x2A, 0x7E, 0x2A, 0x12, 0x26, 0x16, 0x08, 0x34, 0x32, 0x34, 0x4A,
+  0x54, 0x20, 0x50, 0x06, 0x3C, 0x42, 0x42, 0x3C, 0x14, 0x08, 0x3E, 0x08, 0x14, 0x08, 0x08, 0x1C,
+  0x08, 0x08, 0x80, 0x40, 0x08, 0x08, 0x08, 0x08, 0x08, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x3C,
+  0x62, 0x52, 0x4A, 0x3C, 0x44, 0x7E, 0x40, 0x44, 0x62, 0x52, 0x52, 0x4C, 0x22, 0x42, 0x4A, 0x4A,
+  0x34, 0x30, 0x28, 0x24, 0x7E, 0x20, 0x2E, 0x4A, 0x4A, 0x4A, 0x32, 0x38, 0x4C, 0x4A, 0x4A, 0x32,
+  0x02, 0x62, 0x12, 0x0A, 0x06, 0x34, 0x4A, 0x4A, 0x4A, 0x34, 0x0C, 0x52, 0x52, 0x52, 0x3C, 0x24,
+  0x80, 0x64, 0x08, 0x14, 0x22, 0x14, 0x14, 0x14, 0x14, 0x22, 0x14, 0x08, 0x04, 0x02, 0x52, 0x0A,
+  0x04, 0x3C, 0x42, 0x7A, 0x2A, 0x1C, 0x7C, 0x0A, 0x0A, 0x0A, 0x7C, 0x7E, 0x4A, 0x4A, 0x4A, 0x34,
+  0x3C, 0x42, 0x42, 0x42, 0x24, 0x7E, 0x42, 0x42, 0x42, 0x3C, 0x7E, 0x4A, 0x4A, 0x4A, 0x42, 0x7E,
+  0x0A, 0x0A, 0x0A, 0x02, 0x3C, 0x42, 0x42, 0x52, 0x74, 0x7E, 0x08, 0x08, 0x08, 0x7E, 0x42, 0x42,
+  0x7E, 0x42, 0x42, 0x30, 0x40, 0x40, 0x40, 0x3E, 0x7E, 0x08, 0x08, 0x14, 0x62, 0x7E, 0x40, 0x40,
+  0x40, 0x40, 0x7E, 0x04, 0x08, 0x04, 0x7E, 0x7E, 0x04, 0x08, 0x10, 0x7E, 0x3C, 0x42, 0x42, 0x42,
+  0x3C, 0x7E, 0x0A, 0x0A, 0x0A, 0x04, 0x3C, 0x42, 0x52, 0x22, 0x5C, 0x7E, 0x0A, 0x0A, 0x1A, 0x64,
+  0x24, 0x4A, 0x4A, 0x4A, 0x32, 0x02, 0x02, 0x7E, 0x02, 0x02, 0x3E, 0x40, 0x40, 0x40, 0x3E, 0x1E,
+  0x20, 0x40, 0x20, 0x1E, 0x7E, 0x20, 0x10, 0x20, 0x7E, 0x42, 0x24, 0x18, 0x24, 0x42, 0x02, 0x04,
+  0x78, 0x04, 0x02, 0x62, 0x52, 0x4A, 0x46, 0x42, 0x3E, 0x22, 0x22, 0x02, 0x04, 0x08, 0x10, 0x20,
+  0x22, 0x22, 0x3E, 0x04, 0x02, 0x04, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x04, 0x20, 0x54, 0x54,
+  0x54, 0x78, 0x7E, 0x48, 0x48, 0x48, 0x30, 0x38, 0x44, 0x44, 0x44, 0x28, 0x30, 0x48, 0x48, 0x48,
+  0x7E, 0x38, 0x54, 0x54, 0x54, 0x18, 0x08, 0x7C, 0x0A, 0x0A, 0x08, 0x54, 0x54, 0x54, 0x3C, 0x7E,
+  0x08, 0x08, 0x08, 0x70, 0x48, 0x7A, 0x40, 0x20, 0x40, 0x40, 0x3A, 0x7E, 0x10, 0x28, 0x44, 0x42,
+  0x7E, 0x40, 0x7C, 0x04, 0x78, 0x04, 0x78, 0x7C, 0x04, 0x04, 0x04, 0x78, 0x38, 0x44, 0x44, 0x44,
+  0x38, 0x7C, 0x14, 0x14, 0x14, 0x08, 0x08, 0x14, 0x14, 0x14, 0x7C, 0x7C, 0x08, 0x04, 0x04, 0x08,
+  0x48, 0x54, 0x54, 0x54, 0x24, 0x04, 0x3E, 0x44, 0x44, 0x3C, 0x40, 0x40, 0x20, 0x7C, 0x1C, 0x20,
+  0x40, 0x20, 0x1C, 0x3C, 0x40, 0x30, 0x40, 0x3C, 0x44, 0x28, 0x10, 0x28, 0x44, 0x0C, 0x50, 0x50,
+  0x50, 0x3C, 0x44, 0x64, 0x54, 0x4C, 0x44, 0x08, 0x7E, 0x42, 0x7E, 0x42, 0x7E, 0x08, 0x04, 0x02,
+  0x02, 0x04, 0x02, 0x00, 0x00, 0x7A, 0x18, 0x24, 0x7E, 0x24, 0x48, 0x7C, 0x4A, 0x4A, 0x20, 0x44,
+  0x38, 0x28, 0x38, 0x44, 0x2A, 0x2C, 0x78, 0x2C, 0x2A, 0x66, 0x44, 0x5A, 0x5A, 0x22, 0x02, 0x00,
+  0x02, 0x3C, 0x5A, 0x66, 0x66, 0x3C, 0x14, 0x1A, 0x1E, 0x08, 0x14, 0x08, 0x14, 0x08, 0x08, 0x08,
+  0x18, 0x08, 0x08, 0x08, 0x3C, 0x7E, 0x56, 0x6A, 0x3C, 0x02, 0x02, 0x02, 0x02, 0x04, 0x0A, 0x04,
+  0x24, 0x24, 0x2E, 0x24, 0x24, 0x12, 0x1A, 0x14, 0x12, 0x16, 0x1E, 0x04, 0x02, 0x7E, 0x10, 0x10,
+  0x0E, 0x0C, 0x1E, 0x7E, 0x02, 0x7E, 0x08, 0x80, 0xC0, 0x04, 0x1E, 0x14, 0x1A, 0x14, 0x14, 0x08,
+  0x14, 0x08, 0x2E, 0x10, 0x28, 0x34, 0x62, 0x2E, 0x10, 0x08, 0x6C, 0x52, 0x2A, 0x1E, 0x28, 0x34,
+  0x62, 0x20, 0x50, 0x4A, 0x40, 0x20, 0x7C, 0x0B, 0x0A, 0x0A, 0x7C, 0x7C, 0x0A, 0x0A, 0x0B, 0x7C,
+  0x7C, 0x0B, 0x0B, 0x0B, 0x7C, 0x7D, 0x0B, 0x0A, 0x0B, 0x7D, 0x7C, 0x0B, 0x0A, 0x0B, 0x7C, 0x7C,
+  0x0A, 0x0B, 0x0A, 0x7C, 0x7C, 0x0A, 0x7E, 0x4A, 0x42, 0x3C, 0x42, 0xC2, 0x42, 0x24, 0x7E, 0x4B,
+  0x4A, 0x4A, 0x42, 0x7E, 0x4A, 0x4A, 0x4B, 0x42, 0x7E, 0x4B, 0x4B, 0x4B, 0x42, 0x7E, 0x4B, 0x4A,
+  0x4B, 0x42, 0x42, 0x43, 0x7E, 0x42, 0x42, 0x42, 0x42, 0x7E, 0x43, 0x42, 0x42, 0x43, 0x7F, 0x43,
+  0x42, 0x42, 0x43, 0x7E, 0x43, 0x42, 0x4A, 0x7E, 0x4A, 0x42, 0x3C, 0x7F, 0x05, 0x08, 0x11, 0x7F,
+  0x3C, 0x43, 0x42, 0x42, 0x3C, 0x3C, 0x42, 0x42, 0x43, 0x3C, 0x3C, 0x43, 0x43, 0x43, 0x3C, 0x3D,
+  0x43, 0x42, 0x43, 0x3D, 0x3C, 0x43, 0x42, 0x43, 0x3C, 0x14, 0x08, 0x14, 0x3C, 0x62, 0x5A, 0x46,
+  0x3C, 0x3E, 0x41, 0x40, 0x40, 0x3E, 0x3E, 0x40, 0x40, 0x41, 0x3E, 0x3E, 0x41, 0x41, 0x41, 0x3E,
+  0x3E, 0x41, 0x40, 0x41, 0x3E, 0x02, 0x04, 0x78, 0x05, 0x02, 0x7E, 0x14, 0x14, 0x14, 0x08, 0x7C,
+  0x02, 0x4A, 0x34, 0x20, 0x55, 0x56, 0x54, 0x78, 0x20, 0x54, 0x56, 0x55, 0x78, 0x20, 0x56, 0x55,
+  0x56, 0x78, 0x22, 0x55, 0x55, 0x56, 0x79, 0x20, 0x56, 0x54, 0x56, 0x78, 0x20, 0x57, 0x55, 0x57,
+  0x78, 0x24, 0x54, 0x38, 0x54, 0x58, 0x38, 0x44, 0xC4, 0x44, 0x28, 0x38, 0x55, 0x56, 0x54, 0x18,
+  0x38, 0x54, 0x56, 0x55, 0x18, 0x38, 0x56, 0x55, 0x56, 0x18, 0x38, 0x56, 0x54, 0x56, 0x18, 0x49,
+  0x7A, 0x40, 0x48, 0x7A, 0x41, 0x4A, 0x79, 0x42, 0x4A, 0x78, 0x42, 0x30, 0x48, 0x4C, 0x4E, 0x3C,
+  0x7E, 0x05, 0x05, 0x06, 0x79, 0x38, 0x45, 0x46, 0x44, 0x38, 0x38, 0x44, 0x46, 0x45, 0x38, 0x38,
+  0x46, 0x45, 0x46, 0x38, 0x3A, 0x45, 0x45, 0x46, 0x39, 0x38, 0x46, 0x44, 0x46, 0x38, 0x08, 0x08,
+  0x2A, 0x08, 0x08, 0x78, 0x64, 0x54, 0x4C, 0x3C, 0x3C, 0x41, 0x42, 0x20, 0x7C, 0x3C, 0x40, 0x42,
+  0x21, 0x7C, 0x3C, 0x42, 0x41, 0x22, 0x7C, 0x3C, 0x42, 0x40, 0x22, 0x7C, 0x0C, 0x50, 0x52, 0x51,
+  0x3C, 0x7E, 0x14, 0x14, 0x14, 0x08, 0x0C, 0x52, 0x50, 0x52, 0x3C,
+};
@@ -0,0 +1,219 @@
+// Scroll text layout over the kScrollFont blob: UTF-8 decoding, glyph and
+// kerning lookup, and rasterizing a message into strip columns. No Arduino
+// types, so the native test env runs it on the host.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "scroll_font.h"
+
+// Proportional font packed by tools/build_scroll_font.py: UTF-8 text resolves
+// to glyphs with their own widths, kerning pairs adjust the advance, and
+// code points without a glyph render as '?'. The blob is read in place.
+static const uint16_t kScrollFontRangesOffset = 10;
+
+struct ScrollGlyph {
+  uint16_t index;
+  uint8_t width;
+  const uint8_t *columns;
+};
+
+static inline uint16_t scrollFontU16(uint16_t offset) {
+  return static_cast<uint16_t>(kScrollFont[offset] | (kScrollFont[offset + 1] << 8));
+}
+
+static inline uint16_t scrollFontGlyphIndex(uint32_t codePoint) {
+  const uint8_t rangeCount = kScrollFont[3];
+  for (uint8_t r = 0; r < rangeCount; r++) {
+    const uint16_t entry = kScrollFontRangesOffset + r * 6;
+    const uint16_t first = scrollFontU16(entry);
+    if (codePoint >= first && codePoint - first < scrollFontU16(entry + 2)) {
+      return static_cast<uint16_t>(scrollFontU16(entry + 4) + (codePoint - first));
+    }
+  }
+  return scrollFontU16(8);
+}
+
+static inline uint16_t scrollFontOffsetsStart() {
+  return kScrollFontRangesOffset + kScrollFont[3] * 6;
+}
+
+static inline uint16_t scrollFontKerningStart() {
+  return scrollFontOffsetsStart() + (scrollFontU16(4) + 1) * 2;
+}
+
+static inline ScrollGlyph scrollFontGlyph(uint32_t codePoint) {
+  const uint16_t index = scrollFontGlyphIndex(codePoint);
+  const uint16_t bitmapStart = scrollFontKerningStart() + scrollFontU16(6) * 5;
+  const uint16_t begin = scrollFontU16(scrollFontOffsetsStart() + index * 2);
+  const uint16_t end = scrollFontU16(scrollFontOffsetsStart() + (index + 1) * 2);
+  return {index, static_cast<uint8_t>(end - begin), &kScrollFont[bitmapStart + begin]};
+}
+
+static inline int8_t scrollFontKerning(uint16_t left, uint16_t right) {
+  const uint32_t key = (static_cast<uint32_t>(left) << 16) | right;
+  const uint16_t start = scrollFontKerningStart();
+  int32_t lo = 0;
+  int32_t hi = static_cast<int32_t>(scrollFontU16(6)) - 1;
+  while (lo <= hi) {
+    const int32_t mid = (lo + hi) / 2;
+    const uint16_t entry = static_cast<uint16_t>(start + mid * 5);
+    const uint32_t midKey = (static_cast<uint32_t>(scrollFontU16(entry)) << 16) | scrollFontU16(entry + 2);
+    if (midKey == key) {
+      return static_cast<int8_t>(kScrollFont[entry + 4]);
+    }
+    if (midKey < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return 0;
+}
+
+static inline uint8_t utf8SequenceLength(uint8_t lead) {
+  if ((lead & 0xE0) == 0xC0) {
+    return 2;
+  }
+  if ((lead & 0xF0) == 0xE0) {
+    return 3;
+  }
+  if ((lead & 0xF8) == 0xF0) {
+    return 4;
+  }
+  return 1;
+}
+
+// Decodes the code point starting at index and advances past it. Stray
+// continuation bytes and truncated or overlong sequences decode as U+FFFD one
+// byte at a time, so malformed text still scrolls.
+static inline uint32_t decodeUtf8(const char *text, size_t length, size_t &index) {
+  const uint8_t lead = static_cast<uint8_t>(text[index]);
+  const uint8_t sequence = utf8SequenceLength(lead);
+  if (lead < 0x80) {
+    index++;
+    return lead;
+  }
+  if (sequence == 1 || index + sequence > length) {
+    index++;
+    return 0xFFFD;
+  }
+
+  static const uint32_t kMinByLength[5] = {0, 0, 0x80, 0x800, 0x10000};
+  uint32_t codePoint = lead & (0x7F >> sequence);
+  for (uint8_t i = 1; i < sequence; i++) {
+    const uint8_t next = static_cast<uint8_t>(text[index + i]);
+    if ((next & 0xC0) != 0x80) {
+      index++;
+      return 0xFFFD;
+    }
+    codePoint = (codePoint << 6) | (next & 0x3F);
+  }
+  if (codePoint < kMinByLength[sequence] || codePoint > 0x10FFFF) {
+    index++;
+    return 0xFFFD;
+  }
+  index += sequence;
+  return codePoint;
+}
+
+// Whether glyph may start at strip column start given the first `written`
+// columns: none of its pixels may land on, or sit directly above, below,
+// left or right of, a pixel already there, and a column both glyphs light
+// keeps a single color.
+static inline bool scrollGlyphFits(const ScrollGlyph &glyph,
+                                   int32_t start,
+                                   uint32_t color,
+                                   const uint8_t *masks,
+                                   const uint32_t *colors,
+                                   int32_t written) {
+  for (uint8_t col = 0; col < glyph.width; col++) {
+    const uint8_t mask = glyph.columns[col];
+    const int32_t x = start + col;
+    if (mask == 0 || x - 1 >= written) {
+      continue;
+    }
+    if (x > 0 && (masks[x - 1] & mask) != 0) {
+      return false;
+    }
+    if (x < written) {
+      const uint16_t halo = static_cast<uint16_t>(mask | (mask << 1) | (mask >> 1));
+      if ((masks[x] & halo) != 0 || (masks[x] != 0 && colors[x] != color)) {
+        return false;
+      }
+    }
+    if (x + 1 < written && (masks[x + 1] & mask) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Rasterizes text into one glyph column mask and color per strip column,
+// spacing and kerning included, and returns the strip width. charColors[i] is
+// the color of the glyph whose UTF-8 sequence starts at byte i. Glyphs that
+// would run past maxWidth columns are dropped.
+static inline uint16_t layoutScrollStrip(const char *text,
+                                         size_t length,
+                                         const uint32_t *charColors,
+                                         uint8_t *masks,
+                                         uint32_t *colors,
+                                         uint16_t maxWidth) {
+  const uint8_t spacing = kScrollFont[2];
+  int32_t column = 0;
+  bool hasPrevious = false;
+  uint16_t previousIndex = 0;
+  int32_t previousStart = 0;
+  int32_t previousEnd = 0;
+  for (size_t i = 0; i < length;) {
+    const uint32_t glyphColor = charColors[i];
+    const ScrollGlyph glyph = scrollFontGlyph(decodeUtf8(text, length, i));
+    int32_t start = column;
+    if (hasPrevious) {
+      const int8_t kerning = scrollFontKerning(previousIndex, glyph.index);
+      if (kerning > 0) {
+        start += kerning;
+      }
+      // Pull in by the full kerning where the pair allows it, otherwise as
+      // far as it can go without the glyphs touching or swapping order.
+      for (int32_t candidate = column + kerning; candidate < column; candidate++) {
+        if (candidate > previousStart && candidate + glyph.width > previousEnd &&
+            scrollGlyphFits(glyph, candidate, glyphColor, masks, colors, column)) {
+          start = candidate;
+          break;
+        }
+      }
+    }
+
+    const int32_t end = start + glyph.width + spacing;
+    if (end > maxWidth) {
+      break;
+    }
+    for (int32_t x = column; x < start; x++) {
+      masks[x] = 0;
+      colors[x] = 0;
+    }
+    for (uint8_t col = 0; col < glyph.width; col++) {
+      const int32_t x = start + col;
+      const uint8_t mask = glyph.columns[col];
+      if (x >= column) {
+        masks[x] = mask;
+        colors[x] = glyphColor;
+      } else if (mask != 0) {
+        masks[x] |= mask;
+        colors[x] = glyphColor;
+      }
+    }
+    for (int32_t x = start + glyph.width; x < end; x++) {
+      masks[x] = 0;
+      colors[x] = 0;
+    }
+    column = end;
+    hasPrevious = true;
+    previousIndex = glyph.index;
+    previousStart = start;
+    previousEnd = start + glyph.width;
+  }
+  return static_cast<uint16_t>(column);
+}
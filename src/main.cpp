@@ -1,14 +1,21 @@
 #include <Adafruit_NeoPixel.h>
 #include <Arduino.h>
+#include <atomic>
 #include <new>
 #include <ctype.h>
 #include <ESPmDNS.h>
+#include <esp_heap_caps.h>
 #include <esp_system.h>
 #include <Preferences.h>
 #include <Update.h>
-#include <WebServer.h>
+#include <ESPAsyncWebServer.h>
 #include <WiFi.h>
+#include <AsyncUDP.h>
 #include "soc/soc_caps.h"
+#include "matrix_map.h"
+#include "parallel_ws2812.h"
+#include "scroll_font.h"
+#include "scroll_layout.h"
 
 #if __has_include("wifi_secrets.h")
 #include "wifi_secrets.h"
@@ -22,6 +29,23 @@
 #define WIFI_PASSWORD ""
 #endif
 
+// Rejoin a known network with its last DHCP lease as a static address,
+// skipping DHCP; 0 always asks DHCP.
+#ifndef WIFI_REUSE_LEASE
+#define WIFI_REUSE_LEASE 1
+#endif
+
+// LED/PSRAM/NVS self tests and the wait for the serial monitor at boot
+// (about 2.5 s); 0 boots straight into Wi-Fi and the matrix.
+#ifndef BOOT_DIAGNOSTICS
+#define BOOT_DIAGNOSTICS 1
+#endif
+
+// Most /api/events pushes per second; changes in between go out merged.
+#ifndef STATE_EVENTS_PER_SECOND
+#define STATE_EVENTS_PER_SECOND 10
+#endif
+
 #ifndef DEVICE_HOSTNAME
 #define DEVICE_HOSTNAME "esp32"
 #endif
@@ -46,6 +70,12 @@
 #define MATRIX_HEIGHT 8
 #endif
 
+// Tallest output accepted at runtime (heights=...); MATRIX_HEIGHT is the
+// default for every output and the height the fast mapping path is built for.
+#ifndef MATRIX_MAX_HEIGHT
+#define MATRIX_MAX_HEIGHT 32
+#endif
+
 #ifndef MATRIX_PIN_0
 #define MATRIX_PIN_0 14
 #endif
@@ -102,11 +132,114 @@
 #define MATRIX_BRIGHTNESS_DEFAULT 32
 #endif
 
+// Output transfer curve exponent. 1.0 keeps brightness scaling linear.
+#ifndef MATRIX_GAMMA_DEFAULT
+#define MATRIX_GAMMA_DEFAULT 1.0f
+#endif
+
+// Current model for the limiter: draw of one channel at full duty and of an
+// LED's controller with all channels dark, in mA.
+#ifndef MATRIX_LED_CHANNEL_MA
+#define MATRIX_LED_CHANNEL_MA 20
+#endif
+
+#ifndef MATRIX_LED_IDLE_MA
+#define MATRIX_LED_IDLE_MA 1
+#endif
+
+// E1.31 (sACN) input: UDP port and the default first universe.
+#ifndef MATRIX_E131_PORT
+#define MATRIX_E131_PORT 5568
+#endif
+
+#ifndef MATRIX_E131_UNIVERSE
+#define MATRIX_E131_UNIVERSE 1
+#endif
+
+// Render and transmit run as separate tasks: the render task ticks the
+// animations on the Arduino core while the transmit task owns the other core.
+// A periodic esp_timer paces the render task at the target frame rate.
+#ifndef MATRIX_TARGET_FPS
+#define MATRIX_TARGET_FPS 100
+#endif
+
+// Render time an effect may spend per scheduler frame before it drops to a
+// coarser resolution and then to a lower frame rate.
+#ifndef MATRIX_EFFECT_BUDGET_US
+#define MATRIX_EFFECT_BUDGET_US 3000
+#endif
+
+#ifndef MATRIX_RENDER_CORE
+#define MATRIX_RENDER_CORE 1
+#endif
+
+#ifndef MATRIX_TRANSMIT_CORE
+#define MATRIX_TRANSMIT_CORE 0
+#endif
+
+// Clock all outputs in parallel from one DMA buffer through the LCD_CAM i80
+// bus. Set to 0 to always drive each output with Adafruit_NeoPixel (RMT).
+#ifndef MATRIX_PARALLEL_OUTPUT
+#if defined(SOC_LCD_I80_SUPPORTED) && SOC_LCD_I80_SUPPORTED
+#define MATRIX_PARALLEL_OUTPUT 1
+#else
+#define MATRIX_PARALLEL_OUTPUT 0
+#endif
+#endif
+
+// The i80 bus always needs a WR (pixel clock) and a D/C pin even though
+// WS2812 ignores both; they must not collide with any matrix output.
+#ifndef MATRIX_PARALLEL_WR_PIN
+#define MATRIX_PARALLEL_WR_PIN 41
+#endif
+
+#ifndef MATRIX_PARALLEL_DC_PIN
+#define MATRIX_PARALLEL_DC_PIN 42
+#endif
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#if MATRIX_PARALLEL_OUTPUT
+#include <esp_idf_version.h>
+#include <esp_lcd_panel_io.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include <esp_cache.h>
+#else
+#include "esp32s3/rom/cache.h"
+#endif
+#endif
+
 static const uint16_t kMatrixCompiledMaxLedCount = MATRIX_MAX_LEDS;
 static const uint16_t kMatrixDefaultLedsPerOutput = MATRIX_SEGMENT_WIDTH * MATRIX_HEIGHT;
 static const uint16_t kModuleLedCount64 = 64;
 static const uint16_t kModuleLedCount256 = 256;
 
+// Renderers write wire-format bytes straight into the strip pixel memory, so the
+// channel offsets must follow the pixel type handed to Adafruit_NeoPixel.
+static const neoPixelType kMatrixPixelType = NEO_GRB + NEO_KHZ800;
+static const uint8_t kMatrixBytesPerLed = 3;
+static const uint8_t kMatrixWireOffsetR = (kMatrixPixelType >> 4) & 0x03;
+static const uint8_t kMatrixWireOffsetG = (kMatrixPixelType >> 2) & 0x03;
+static const uint8_t kMatrixWireOffsetB = kMatrixPixelType & 0x03;
+static const float kMatrixGammaMin = 1.0f;
+static const float kMatrixGammaMax = 3.0f;
+
+// XY lookup table entry: output in the top 3 bits, LED index below. 16 bits
+// cover the default 6720-LED ceiling; bigger builds switch to 32-bit entries
+// and keep the table in PSRAM.
+#if MATRIX_MAX_LEDS < 8192
+typedef uint16_t MatrixMapEntry;
+static const uint8_t kMatrixMapIndexBits = 13;
+#else
+typedef uint32_t MatrixMapEntry;
+static const uint8_t kMatrixMapIndexBits = 29;
+#endif
+static const MatrixMapEntry kMatrixMapIndexMask = static_cast<MatrixMapEntry>((1UL << kMatrixMapIndexBits) - 1);
+static const MatrixMapEntry kMatrixMapUnmapped = static_cast<MatrixMapEntry>(~static_cast<MatrixMapEntry>(0));
+
 #ifdef LED_BUILTIN
 static const int kLedPin = LED_BUILTIN;
 #endif
@@ -134,9 +267,101 @@ enum class MatrixScanOrder : uint8_t {
   ColumnMajor = 1,
 };
 
-WebServer gWebServer(80);
-uint32_t *gMatrixBuffer[MATRIX_OUTPUT_COUNT] = {nullptr};
+enum class MatrixDriver : uint8_t {
+  NeoPixel = 0,
+  Parallel = 1,
+};
+
+// What the render task does with frames it woke up too late for: CatchUp
+// advances the animation clock over them, Skip drops them from the timeline.
+enum class FramePolicy : uint8_t {
+  CatchUp = 0,
+  Skip = 1,
+};
+
+// Heartbeat logging on the USB serial port, which may also carry frames.
+enum class SerialLogPolicy : uint8_t {
+  Auto = 0,  // Muted while a serial frame stream is live.
+  On = 1,
+  Off = 2,
+};
+
+// Requests are parsed on the AsyncTCP task, many connections at once, and
+// the handlers run there under MatrixLock; nothing is served from loop().
+AsyncWebServer gWebServer(80);
 Adafruit_NeoPixel *gMatrixStrips[MATRIX_OUTPUT_COUNT] = {nullptr};
+// Renderers draw into the back buffer (gMatrixPixels); showMatrix() queues it
+// and the transmit task swaps it with the front buffer it sends from.
+uint8_t *gMatrixPixels[MATRIX_OUTPUT_COUNT] = {nullptr};
+uint8_t *gMatrixFrontPixels[MATRIX_OUTPUT_COUNT] = {nullptr};
+MatrixDriver gMatrixDriver = MatrixDriver::NeoPixel;
+SemaphoreHandle_t gMatrixMutex = nullptr;
+SemaphoreHandle_t gMatrixFrontFree = nullptr;
+TaskHandle_t gMatrixRenderTask = nullptr;
+TaskHandle_t gMatrixTransmitTask = nullptr;
+bool gMatrixPipelineRunning = false;
+// Set under MatrixLock, consumed by the transmit task before its next send.
+bool gMatrixFramePending = false;
+bool gMatrixCurvePending = false;
+
+static const uint16_t kMatrixFpsMin = 1;
+static const uint16_t kMatrixFpsMax = 200;
+// Upper bounds of the lateness histogram buckets; the last bucket is open.
+static const uint8_t kFrameLateBucketCount = 8;
+static const uint32_t kFrameLateBucketUs[kFrameLateBucketCount - 1] = {250, 500, 1000, 2000, 5000, 10000, 20000};
+esp_timer_handle_t gMatrixFrameTimer = nullptr;
+uint16_t gMatrixTargetFps = MATRIX_TARGET_FPS;
+FramePolicy gMatrixFramePolicy = FramePolicy::CatchUp;
+// Animation time. Tickers read this instead of millis() so motion follows the
+// frame timeline, not whenever the render task happened to run.
+int64_t gMatrixFrameClockUs = 0;
+int64_t gMatrixFrameDeadlineUs = 0;
+uint32_t gMatrixFrameCount = 0;
+uint32_t gMatrixFrameMissed = 0;
+uint32_t gMatrixFrameLateMaxUs = 0;
+uint32_t gMatrixFrameLateHist[kFrameLateBucketCount] = {0};
+
+// Effects draw the whole back buffer at the given cell size (1, 2 or 4 px
+// blocks); timeMs is the frame clock.
+struct MatrixEffect {
+  const char *name;
+  void (*init)();
+  void (*render)(uint32_t timeMs, uint8_t cell);
+  void (*release)();
+};
+
+static const uint16_t kMatrixEffectBudgetMinUs = 500;
+static const uint16_t kMatrixEffectBudgetMaxUs = 20000;
+static const uint8_t kMatrixEffectMaxCell = 4;
+static const uint8_t kMatrixEffectMaxDivider = 4;
+static const uint8_t kMatrixEffectAdaptFrames = 16;
+const MatrixEffect *gMatrixEffect = nullptr;
+uint16_t gMatrixEffectBudgetUs = MATRIX_EFFECT_BUDGET_US;
+uint8_t gMatrixEffectCell = 1;
+uint8_t gMatrixEffectDivider = 1;
+uint8_t gMatrixEffectFramePhase = 0;
+uint8_t gMatrixEffectSamples = 0;
+uint32_t gMatrixEffectRenderUs = 0;
+uint32_t gMatrixEffectRng = 0x2545F491UL;
+uint8_t *gFireHeat = nullptr;
+size_t gFireHeatCells = 0;
+uint32_t gFireLastStepMs = 0;
+
+// Slot encoding lives in parallel_ws2812.h; this is the bus side of it.
+static const uint32_t kParallelPixelClockHz = 2400000;
+static const size_t kParallelInternalDmaMaxBytes = 32 * 1024;
+// PSRAM is written back to memory a cache line at a time.
+static const size_t kParallelCacheLineBytes = 64;
+static_assert(kParallelChannelsPerLed == kMatrixBytesPerLed, "parallel encoder expects RGB pixels");
+#if MATRIX_PARALLEL_OUTPUT
+esp_lcd_i80_bus_handle_t gParallelBus = nullptr;
+esp_lcd_panel_io_handle_t gParallelIo = nullptr;
+SemaphoreHandle_t gParallelTxIdle = nullptr;
+uint8_t *gParallelDmaBuffer = nullptr;
+size_t gParallelDmaBytes = 0;
+bool gParallelDmaInPsram = false;
+uint16_t gParallelLaneLeds = 0;
+#endif
 const uint8_t kMatrixDefaultPins[MATRIX_MAX_OUTPUTS] = {
   MATRIX_PIN_0,
   MATRIX_PIN_1,
@@ -148,11 +373,52 @@ const uint8_t kMatrixDefaultPins[MATRIX_MAX_OUTPUTS] = {
   MATRIX_PIN_7,
 };
 static_assert(MATRIX_OUTPUT_COUNT <= MATRIX_MAX_OUTPUTS, "MATRIX_OUTPUT_COUNT exceeds MATRIX_MAX_OUTPUTS");
+static_assert(MATRIX_MAX_OUTPUTS <= 8, "XY lookup table encodes the output in 3 bits");
+static_assert(MATRIX_HEIGHT >= 1 && MATRIX_HEIGHT <= MATRIX_MAX_HEIGHT, "MATRIX_HEIGHT exceeds MATRIX_MAX_HEIGHT");
+static_assert(MATRIX_MAX_HEIGHT <= 32, "column masks hold at most 32 rows");
 uint8_t gMatrixPins[MATRIX_OUTPUT_COUNT] = {0};
 uint16_t gMatrixLedsPerOutput[MATRIX_OUTPUT_COUNT] = {0};
 uint16_t gMatrixColsPerOutput[MATRIX_OUTPUT_COUNT] = {0};
 uint16_t gMatrixXOffsets[MATRIX_OUTPUT_COUNT + 1] = {0};
 uint16_t gMatrixTotalWidth = MATRIX_OUTPUT_COUNT * MATRIX_SEGMENT_WIDTH;
+// Rows per output; the canvas is as tall as the tallest active output and
+// shorter outputs leave their lower rows unmapped.
+uint8_t gMatrixHeights[MATRIX_OUTPUT_COUNT] = {0};
+uint8_t gMatrixTotalHeight = MATRIX_HEIGHT;
+
+// Optional 2D layout: panels placed anywhere on the canvas, each chained on an
+// output after the previous panel of that output. With no panels the outputs
+// sit side by side as plain strips.
+enum class PanelWiring : uint8_t {
+  Default = 0,  // Follows map= and MATRIX_SERPENTINE.
+  ColumnSerpentine = 1,
+  ColumnProgressive = 2,
+  RowSerpentine = 3,
+  RowProgressive = 4,
+};
+
+struct MatrixPanel {
+  uint8_t output;
+  uint16_t x;
+  uint8_t y;
+  // Footprint on the canvas, after rotation.
+  uint16_t width;
+  uint8_t height;
+  uint8_t quarterTurns;  // Clockwise.
+  PanelWiring wiring;
+  uint16_t firstLed;
+};
+
+static const uint8_t kMatrixLayoutMaxPanels = 32;
+MatrixPanel gMatrixPanels[kMatrixLayoutMaxPanels];
+uint8_t gMatrixPanelCount = 0;
+String gMatrixLayoutSpec;
+MatrixMapEntry *gMatrixPixelMap = nullptr;
+uint32_t gMatrixPixelMapCells = 0;
+// Mapping specialized for the current flips and scan order, see
+// selectMatrixMapXY(); null until the first layout is applied.
+MatrixMapXYFn gMatrixMapXY = nullptr;
+uint16_t gMatrixPixelMapWidth = 0;
 uint8_t gMatrixActiveOutputs =
   (MATRIX_ACTIVE_OUTPUTS_DEFAULT < 1)
     ? 1
@@ -163,30 +429,385 @@ int gMatrixDataPin = MATRIX_PIN_0;
 uint16_t gMatrixActiveLedCount = 0;
 uint16_t gMatrixRuntimeMaxLedCount = kMatrixCompiledMaxLedCount;
 uint8_t gMatrixBrightness = MATRIX_BRIGHTNESS_DEFAULT;
+float gMatrixGamma = MATRIX_GAMMA_DEFAULT;
+// Brightness and gamma folded into one table, applied when a frame is encoded
+// for the wire. Frame buffers always hold full-scale colors.
+uint8_t gMatrixOutputLut[256];
+// Current limiter: budgets in mA (0 = unlimited), checked against each frame
+// just before it is encoded. Outputs over budget are encoded through a scaled
+// copy of the output LUT. The last frame's figures are kept for /api/state.
+uint32_t gMatrixCurrentBudgetMa = 0;
+uint16_t gMatrixOutputBudgetMa[MATRIX_OUTPUT_COUNT] = {0};
+uint8_t gMatrixLimitedLuts[MATRIX_OUTPUT_COUNT][256];
+uint32_t gMatrixCurrentEstimateMa = 0;
+uint32_t gMatrixCurrentLimitedMa = 0;
+uint32_t gMatrixOutputEstimateMa[MATRIX_OUTPUT_COUNT] = {0};
+uint16_t gMatrixCurrentScale = 256;
+uint32_t gMatrixCurrentSumUs = 0;
 bool gMatrixReady = false;
 bool gMatrixTestRunning = false;
 uint16_t gMatrixTestIndex = 0;
 unsigned long gMatrixLastStepMs = 0;
 bool gMatrixScrollRunning = false;
-String gMatrixScrollText = "HELLO";
-int16_t gMatrixScrollOffsetX = 0;
-unsigned long gMatrixScrollLastStepMs = 0;
-uint16_t gMatrixScrollStepMs = 120;
 ScrollDirection gMatrixScrollDirection = ScrollDirection::Left;
 MatrixScanOrder gMatrixScanOrder = (MATRIX_SCAN_ORDER == 0) ? MatrixScanOrder::RowMajor
                                                             : MatrixScanOrder::ColumnMajor;
 bool gMatrixXFlip = (MATRIX_X_FLIP != 0);
 bool gMatrixYFlip = (MATRIX_Y_FLIP != 0);
 
-static const uint8_t kScrollFontHeight = 6;
-static const uint8_t kScrollGlyphWidth = 5;
-static const uint8_t kScrollGlyphSpacing = 1;
+// Header fields of kScrollFont (see tools/build_scroll_font.py).
+static const uint8_t kScrollFontHeight = kScrollFont[1];
+static const uint8_t kScrollGlyphSpacing = kScrollFont[2];
+// Widest glyph the font generator accepts; bounds the strip below.
+static const uint8_t kScrollGlyphMaxWidth = 5;
 static const size_t kScrollTextMaxLength = 64;
-uint32_t gMatrixScrollCharColors[kScrollTextMaxLength] = {0};
-bool gMatrixScrollUseCharColors = false;
+static const uint32_t kScrollSpeedMinMpps = 1000;
+static const uint32_t kScrollSpeedMaxMpps = 500000;
+static const uint32_t kScrollSpeedDefaultMpps = 1000000UL / 120;
+// Every glyph takes at least one byte of text and at most
+// kScrollGlyphMaxWidth columns plus one spacing column; the layout stops at
+// the strip end should positive kerning ever push past it.
+static const uint16_t kScrollStripMaxWidth = kScrollTextMaxLength * (kScrollGlyphMaxWidth + 1);
+
+// One ticker line. Its text is rasterized once per message: one glyph column
+// mask and color per strip column, spacing and kerning included, so a scroll
+// step only indexes into it.
+struct MatrixScrollLine {
+  String text;
+  // Speed in 1/1000 px per second; scroll_speed (ms per pixel) maps onto it.
+  uint32_t speedMpps = kScrollSpeedDefaultMpps;
+  // Position in 1/65536 px, advanced every frame by speed * frame delta.
+  int32_t posQ16 = 0;
+  int64_t lastUs = 0;
+  bool useCharColors = false;
+  int16_t stripWidth = 0;
+  uint32_t charColors[kScrollTextMaxLength] = {0};
+  uint8_t stripMasks[kScrollStripMaxWidth] = {0};
+  uint32_t stripColors[kScrollStripMaxWidth] = {0};
+};
+
+// Line 0 is the classic ticker. Line 1 shows below it once the canvas fits two
+// rows of text and it has text of its own; both scroll in the same direction.
+static const uint8_t kMatrixScrollLineCount = 2;
+MatrixScrollLine gMatrixScrollLines[kMatrixScrollLineCount] = {{"HELLO"}, {}};
+
+// Network pixel streams. While a source keeps sending it owns the back buffer
+// and scroll, effect and test pause; they resume once it has been quiet for
+// kMatrixStreamTimeoutMs.
+enum class MatrixStreamSource : uint8_t {
+  None = 0,
+  E131 = 1,
+  ArtNet = 2,
+  Ddp = 3,
+  Serial = 4,
+  WebSocket = 5,
+};
+
+static const unsigned long kMatrixStreamTimeoutMs = 2500;
+// Both protocols carry 170 RGB LEDs per universe. Universes go to the active
+// outputs in order from each protocol's first universe,
+// gMatrixStreamUniversesPerOutput each (0 = as many as the output's LEDs need).
+static const uint16_t kMatrixStreamLedsPerUniverse = 170;
+static const uint8_t kMatrixStreamMaxUniverses = 64;
+MatrixStreamSource gMatrixStreamSource = MatrixStreamSource::None;
+unsigned long gMatrixStreamLastMs = 0;
+uint8_t gMatrixStreamUniversesPerOutput = 0;
+// Frame assembly, one bit per universe offset.
+uint64_t gMatrixStreamReceivedMask = 0;
+uint32_t gMatrixStreamFrames = 0;
+// A completed stream frame waiting for the render task to present it.
+bool gMatrixStreamFramePending = false;
+unsigned long gMatrixStreamRateMs = 0;
+// Packet-to-photon latency: arrival of a stream frame's first packet to the
+// end of its transmission. The arrival stamp moves with the back buffer into
+// the front buffer on showMatrix(); 0 marks locally rendered frames.
+int64_t gMatrixBackStreamUs = 0;
+int64_t gMatrixFrontStreamUs = 0;
+uint32_t gMatrixStreamLatencyUs = 0;
+uint32_t gMatrixStreamLatencyAvgUs = 0;
+uint32_t gMatrixStreamLatencyMaxUs = 0;
+
+// E1.31 receiver. A nonzero sync address in the data packets defers the
+// frame to the sender's sync packet.
+static const uint16_t kE131MaxUniverse = 63999;
+static const size_t kE131SyncPacketLength = 49;
+static const size_t kE131DataOffset = 126;
+AsyncUDP gE131Udp;
+bool gE131Enabled = false;
+bool gE131Listening = false;
+uint16_t gE131StartUniverse = MATRIX_E131_UNIVERSE;
+uint16_t gE131SyncUniverse = 0;
+uint64_t gE131SequenceSeen = 0;
+uint8_t gE131LastSequence[kMatrixStreamMaxUniverses] = {0};
+uint32_t gE131Packets = 0;
+uint32_t gE131Dropped = 0;
+uint32_t gE131OutOfOrder = 0;
+uint32_t gE131Invalid = 0;
+uint32_t gE131Pps = 0;
+uint32_t gE131RatePackets = 0;
+
+// Art-Net 4 node. Port-addresses (net, sub-net and universe as one 15-bit
+// number) map like E1.31 universes from gArtNetStartPort. Once the controller
+// sends ArtSync, frames latch on ArtSync only until none has come for
+// kArtNetSyncTimeoutMs.
+static const uint16_t kArtNetUdpPort = 6454;
+static const uint16_t kArtNetMaxPortAddress = 32767;
+static const uint16_t kArtNetOpPoll = 0x2000;
+static const uint16_t kArtNetOpPollReply = 0x2100;
+static const uint16_t kArtNetOpDmx = 0x5000;
+static const uint16_t kArtNetOpSync = 0x5200;
+static const size_t kArtNetDmxHeaderLength = 18;
+static const size_t kArtNetPollReplyLength = 239;
+static const unsigned long kArtNetSyncTimeoutMs = 4000;
+AsyncUDP gArtNetUdp;
+bool gArtNetEnabled = false;
+bool gArtNetListening = false;
+uint16_t gArtNetStartPort = 0;
+bool gArtNetSyncMode = false;
+unsigned long gArtNetLastSyncMs = 0;
+uint32_t gArtNetSourceIp = 0;
+uint64_t gArtNetSequenceSeen = 0;
+uint8_t gArtNetLastSequence[kMatrixStreamMaxUniverses] = {0};
+// Poll replies are built here rather than on the UDP task's small stack.
+uint8_t gArtNetPollReply[kArtNetPollReplyLength];
+uint32_t gArtNetPackets = 0;
+uint32_t gArtNetSyncs = 0;
+uint32_t gArtNetPolls = 0;
+uint32_t gArtNetDropped = 0;
+uint32_t gArtNetOutOfOrder = 0;
+uint32_t gArtNetInvalid = 0;
+uint32_t gArtNetPps = 0;
+uint32_t gArtNetRatePackets = 0;
+
+// DDP receiver. Packets carry byte offsets into the canvas in logical order
+// (row by row, as mapMatrixXY() sees it) and the last one of a frame sets
+// PUSH, so there is no universe bookkeeping.
+static const uint16_t kDdpUdpPort = 4048;
+static const size_t kDdpHeaderLength = 10;
+static const size_t kDdpTimecodeLength = 4;
+static const uint8_t kDdpFlagVersionMask = 0xC0;
+static const uint8_t kDdpFlagVersion1 = 0x40;
+static const uint8_t kDdpFlagTimecode = 0x10;
+static const uint8_t kDdpFlagReply = 0x04;
+static const uint8_t kDdpFlagQuery = 0x02;
+static const uint8_t kDdpFlagPush = 0x01;
+static const uint8_t kDdpIdDisplay = 1;
+static const uint8_t kDdpIdConfig = 250;
+static const uint8_t kDdpIdStatus = 251;
+static const uint8_t kDdpIdAll = 255;
+static const size_t kDdpReplyMaxLength = 320;
+AsyncUDP gDdpUdp;
+bool gDdpEnabled = false;
+bool gDdpListening = false;
+uint8_t gDdpLastSequence = 0;
+uint8_t gDdpReply[kDdpReplyMaxLength];
+uint32_t gDdpPackets = 0;
+uint32_t gDdpQueries = 0;
+uint32_t gDdpDropped = 0;
+uint32_t gDdpOutOfOrder = 0;
+uint32_t gDdpInvalid = 0;
+uint32_t gDdpPps = 0;
+uint32_t gDdpRatePackets = 0;
+
+// Adalight and TPM2 frames on the USB CDC port that also carries the log.
+// Pixels are in canvas order like DDP and are parsed from each chunk read
+// straight into the back buffer; the frame is shown once it is complete.
+enum class SerialFrameState : uint8_t {
+  Sync,
+  AdalightHeader,
+  Tpm2Header,
+  Pixels,
+  Skip,
+  Tpm2End,
+};
+
+static const size_t kSerialRxBufferBytes = 8192;
+static const size_t kSerialChunkBytes = 512;
+// A frame that stalls this long is abandoned and the parser resyncs.
+static const unsigned long kSerialResyncMs = 100;
+static const uint8_t kAdalightHeaderLength = 6;
+static const uint8_t kTpm2HeaderLength = 4;
+static const uint8_t kTpm2Start = 0xC9;
+static const uint8_t kTpm2TypeData = 0xDA;
+static const uint8_t kTpm2TypeCommand = 0xC0;
+static const uint8_t kTpm2End = 0x36;
+TaskHandle_t gSerialIngestTask = nullptr;
+bool gSerialIngestEnabled = false;
+SerialLogPolicy gSerialLogPolicy = SerialLogPolicy::Auto;
+SerialFrameState gSerialState = SerialFrameState::Sync;
+bool gSerialTpm2 = false;
+bool gSerialFrameOwned = false;
+uint8_t gSerialHeader[kAdalightHeaderLength];
+uint8_t gSerialHeaderLength = 0;
+// Payload bytes still to come, and the canvas pixel they continue at.
+uint32_t gSerialFrameBytes = 0;
+uint32_t gSerialPixel = 0;
+// A pixel split across two reads.
+uint8_t gSerialCarry[3];
+uint8_t gSerialCarryLength = 0;
+unsigned long gSerialLastByteMs = 0;
+uint32_t gSerialBytes = 0;
+uint32_t gSerialInvalid = 0;
+uint32_t gSerialBps = 0;
+uint32_t gSerialRateBytes = 0;
+
+// Persistent WebSocket at /ws on the HTTP server. Binary frames are written
+// straight into the back buffer and one-message controls skip the query
+// parsing and state JSON of /api; layouts are in handleWebSocketBinary().
+static const uint8_t kWebSocketOpRgb = 0x01;
+static const uint8_t kWebSocketOpRle = 0x02;
+static const uint8_t kWebSocketOpColor = 0x10;
+static const uint8_t kWebSocketOpBrightness = 0x11;
+static const uint8_t kWebSocketOpScrollSpeed = 0x12;
+static const uint8_t kWebSocketOpScrollDirection = 0x13;
+static const uint8_t kWebSocketFramePush = 0x01;
+static const size_t kWebSocketFrameHeaderLength = 6;
+// Messages larger than one TCP segment arrive in pieces and are put back
+// together in a buffer of the sending client. The largest accepted message is
+// an RGB frame of the whole MATRIX_MAX_LEDS canvas; RLE frames that would be
+// longer have to be split like any canvas past one message.
+static const size_t kWebSocketMessageMaxBytes =
+  static_cast<size_t>(MATRIX_MAX_LEDS) * 3 + kWebSocketFrameHeaderLength;
+// Clients that can be reassembling at the same time; a fragmented message from
+// one more is dropped.
+static const uint8_t kWebSocketReassemblySlots = 4;
+struct WebSocketReassembly {
+  uint32_t clientId;
+  uint8_t *buffer;
+};
+AsyncWebSocket gWebSocket("/ws");
+WebSocketReassembly gWebSocketReassembly[kWebSocketReassemblySlots] = {};
+uint32_t gWebSocketMessages = 0;
+uint32_t gWebSocketInvalid = 0;
+// Settings changed by a slider drag are written once it has settled instead
+// of on every step.
+static const unsigned long kSettingsSaveDelayMs = 2000;
+bool gSettingsSavePending = false;
+unsigned long gSettingsSaveMs = 0;
+// /api/state is rendered into one of these fixed buffers and streamed from
+// there, so a poll allocates nothing. gStateVersion moves whenever a field
+// outside the live counters changes and backs the ETag; it is bumped from the
+// Wi-Fi event task, loop() and the AsyncTCP task alike, hence atomic.
+static const uint8_t kStateJsonSlots = 8;
+static const size_t kStateJsonMaxBytes = 8192;
+struct StateJsonSlot {
+  char *data;
+  size_t length;
+  uint32_t owner;  // 0 while free
+};
+StateJsonSlot gStateJsonSlots[kStateJsonSlots] = {};
+uint32_t gStateJsonOwnerCounter = 0;
+std::atomic<uint32_t> gStateVersion(1);
+uint32_t gStateJsonBytes = 0;
+uint32_t gStateJsonUs = 0;
+uint32_t gStateJsonNotModified = 0;
+// /api/events streams these fields as Server-Sent Events: a new client gets
+// all of them, after that only the pairs that changed since the last push.
+static const char kStateEventFields[] =
+  "hex,wifi,wifi_ssid,wifi_state,wifi_job*,ip,hostname,safe_*,boot_attempts,ap_*,"
+  "matrix_pin,matrix_pins,matrix_outputs,matrix_active_outputs,matrix_scan,matrix_x_flip,matrix_y_flip,"
+  "matrix_counts,matrix_count,matrix_max_count,matrix_width,matrix_brightness,matrix_scroll,"
+  "matrix_scroll_text,matrix_scroll_multicolor,matrix_scroll_speed,matrix_scroll_direction";
+static const size_t kStateEventMaxBytes = 2048;
+AsyncEventSource gEvents("/api/events");
+char gStateEventLast[kStateEventMaxBytes] = {0};
+size_t gStateEventLastLength = 0;
+char gStateEventDelta[kStateEventMaxBytes] = {0};
+uint32_t gStateEventVersion = 0;
+unsigned long gStateEventMs = 0;
+uint32_t gStateEventPushes = 0;
 
 bool gMdnsStarted = false;
 bool gWebServerStarted = false;
+// Handlers must not block the AsyncTCP task, so Wi-Fi changes and restarts
+// are queued here and run on the loop task once the response is out.
+enum class DeferredCommand : uint8_t {
+  None = 0,
+  WifiConnect = 1,
+  WifiForget = 2,
+  Restart = 3,
+  WifiRemove = 4,
+};
+static const unsigned long kDeferredCommandDelayMs = 300;
+DeferredCommand gDeferredCommand = DeferredCommand::None;
+unsigned long gDeferredCommandMs = 0;
+String gDeferredSsid;
+String gDeferredPassword;
+bool gDeferredSave = false;
+uint32_t gDeferredWifiJob = 0;
+// Station side of Wi-Fi, stepped by tickWifi() from loop() on the events the
+// driver posts, so joining never waits on the radio. A failed join brings up
+// the config AP and keeps retrying with a growing delay.
+enum class WifiState : uint8_t {
+  Idle = 0,        // No credentials.
+  Connecting = 1,  // WiFi.begin() issued, waiting for an IP.
+  Connected = 2,
+  Waiting = 3,     // Next join once gWifiRetryMs has passed.
+};
+enum class WifiJobStatus : uint8_t {
+  None = 0,
+  Pending = 1,
+  Connected = 2,
+  Failed = 3,
+};
+// How a join skips work: Bssid goes straight to the cached access point and
+// channel instead of scanning, Lease also reuses the last DHCP lease.
+enum class WifiJoinMode : uint8_t {
+  Scan = 0,
+  Bssid = 1,
+  Lease = 2,
+};
+static const unsigned long kWifiJoinTimeoutMs = 15000;
+// A cached access point answers quickly or has moved.
+static const unsigned long kWifiFastJoinTimeoutMs = 3000;
+static const unsigned long kWifiRetryMinMs = 2000;
+static const unsigned long kWifiRetryMaxMs = 60000;
+static const uint8_t kWifiMaxNetworks = 4;
+static const int8_t kWifiRssiUnknown = -127;
+// Stored networks are tried strongest first (last RSSI seen).
+struct WifiNetwork {
+  String ssid;
+  String password;
+  uint8_t bssid[6] = {0};
+  uint8_t channel = 0;  // 0 = nothing cached.
+  int8_t rssi = kWifiRssiUnknown;
+  uint32_t ip = 0;  // Last DHCP lease, 0 = none.
+  uint32_t gateway = 0;
+  uint32_t subnet = 0;
+  uint32_t dns = 0;
+};
+WifiNetwork gWifiNetworks[kWifiMaxNetworks];
+uint8_t gWifiNetworkCount = 0;
+// The network being joined; -1 when it is not gWifiNetworks[gWifiCandidate]
+// (a job, or rejoining after the link dropped).
+WifiNetwork gWifiCurrent;
+int8_t gWifiCandidate = -1;
+WifiJoinMode gWifiJoinMode = WifiJoinMode::Scan;
+WifiState gWifiState = WifiState::Idle;
+unsigned long gWifiStateMs = 0;
+unsigned long gWifiRetryMs = kWifiRetryMinMs;
+uint32_t gWifiAttempts = 0;
+// Set on the Wi-Fi event task, consumed by tickWifi().
+volatile bool gWifiGotIp = false;
+volatile bool gWifiLinkLost = false;
+volatile uint8_t gWifiDisconnectReason = 0;
+volatile unsigned long gWifiAssocAtMs = 0;
+volatile unsigned long gWifiGotIpAtMs = 0;
+uint8_t gWifiEventBssid[6] = {0};
+volatile uint8_t gWifiEventChannel = 0;
+// Connect-time breakdown of the last successful join, and milestones since
+// power-on (0 = not yet).
+uint32_t gWifiAssocMs = 0;
+uint32_t gWifiDhcpMs = 0;
+uint32_t gWifiConnectMs = 0;
+unsigned long gWifiOnlineAtMs = 0;
+unsigned long gHttpFirstAtMs = 0;
+// /api/wifi?ssid= joins are numbered jobs; their credentials are saved only
+// once the job connects.
+uint32_t gWifiJobCounter = 0;
+uint32_t gWifiJobId = 0;
+WifiJobStatus gWifiJobStatus = WifiJobStatus::None;
+bool gWifiJobSave = false;
 bool gApMode = false;
 bool gOtaHasError = false;
 String gApSsid;
@@ -205,6 +826,27 @@ static const uint32_t kRecoveryBootMagic = 0x5AFE1234;
 
 void renderMatrixScrollFrame();
 bool mapMatrixXY(uint16_t x, uint8_t y, uint8_t &output, uint16_t &index);
+void rebuildMatrixPixelMap();
+void transmitMatrixFrame(uint8_t *const frame[MATRIX_OUTPUT_COUNT]);
+uint8_t matrixEffectId(const MatrixEffect *effect);
+const MatrixEffect *matrixEffectById(uint8_t id);
+void markStateChanged();
+
+// Guards matrix state shared by the render task and the web handlers.
+struct MatrixLock {
+  MatrixLock() {
+    if (gMatrixMutex != nullptr) {
+      xSemaphoreTakeRecursive(gMatrixMutex, portMAX_DELAY);
+    }
+  }
+  ~MatrixLock() {
+    if (gMatrixMutex != nullptr) {
+      xSemaphoreGiveRecursive(gMatrixMutex);
+    }
+  }
+  MatrixLock(const MatrixLock &) = delete;
+  MatrixLock &operator=(const MatrixLock &) = delete;
+};
 
 int getBuiltinRgbDataPin() {
 #if defined(RGB_BUILTIN)
@@ -269,31 +911,112 @@ uint32_t packColor(uint8_t r, uint8_t g, uint8_t b) {
   return (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | b;
 }
 
+// weightB is out of 256; 0 returns a, 256 returns b.
+uint32_t blendColor(uint32_t a, uint32_t b, uint16_t weightB) {
+  const uint16_t weightA = 256 - weightB;
+  uint32_t out = 0;
+  for (uint8_t shift = 0; shift <= 16; shift += 8) {
+    const uint32_t channel = (((a >> shift) & 0xFF) * weightA + ((b >> shift) & 0xFF) * weightB) >> 8;
+    out |= channel << shift;
+  }
+  return out;
+}
+
+void rebuildMatrixOutputLut() {
+  const float peak = static_cast<float>(gMatrixBrightness);
+  for (uint16_t value = 0; value < 256; value++) {
+    const float level = powf(static_cast<float>(value) / 255.0f, gMatrixGamma) * peak;
+    gMatrixOutputLut[value] = static_cast<uint8_t>(lroundf(level));
+  }
+}
+
+void writeMatrixPixel(uint8_t *pixel, uint32_t color) {
+  pixel[kMatrixWireOffsetR] = static_cast<uint8_t>(color >> 16);
+  pixel[kMatrixWireOffsetG] = static_cast<uint8_t>(color >> 8);
+  pixel[kMatrixWireOffsetB] = static_cast<uint8_t>(color);
+}
+
 void clearMatrixBuffer() {
   for (uint8_t output = 0; output < gMatrixActiveOutputs; output++) {
-    if (gMatrixBuffer[output] == nullptr) {
+    if (gMatrixPixels[output] == nullptr) {
       continue;
     }
-    for (uint16_t i = 0; i < gMatrixLedsPerOutput[output]; i++) {
-      gMatrixBuffer[output][i] = 0;
-    }
+    memset(gMatrixPixels[output], 0, static_cast<size_t>(gMatrixLedsPerOutput[output]) * kMatrixBytesPerLed);
+  }
+}
+
+// The NeoPixel driver returns once the frame is out; the parallel one only
+// starts the DMA.
+void waitMatrixWireIdle() {
+#if MATRIX_PARALLEL_OUTPUT
+  if (gMatrixDriver == MatrixDriver::Parallel && gParallelTxIdle != nullptr) {
+    xSemaphoreTake(gParallelTxIdle, portMAX_DELAY);
+    xSemaphoreGive(gParallelTxIdle);
+  }
+#endif
+}
+
+void recordMatrixStreamLatency(int64_t arrivedUs) {
+  const int64_t elapsedUs = esp_timer_get_time() - arrivedUs;
+  const uint32_t latency = elapsedUs > 0 ? static_cast<uint32_t>(elapsedUs) : 0;
+  gMatrixStreamLatencyUs = latency;
+  gMatrixStreamLatencyAvgUs =
+    (gMatrixStreamLatencyAvgUs == 0) ? latency : gMatrixStreamLatencyAvgUs - gMatrixStreamLatencyAvgUs / 8 + latency / 8;
+  if (latency > gMatrixStreamLatencyMaxUs) {
+    gMatrixStreamLatencyMaxUs = latency;
   }
 }
 
 void showMatrix() {
-  for (uint8_t output = 0; output < gMatrixActiveOutputs; output++) {
-    Adafruit_NeoPixel *strip = gMatrixStrips[output];
-    if (strip == nullptr) {
-      continue;
-    }
-    strip->setBrightness(gMatrixBrightness);
-    if (gMatrixBuffer[output] == nullptr) {
-      continue;
+  if (!gMatrixPipelineRunning) {
+    transmitMatrixFrame(gMatrixPixels);
+    if (gMatrixBackStreamUs != 0) {
+      waitMatrixWireIdle();
+      recordMatrixStreamLatency(gMatrixBackStreamUs);
+      gMatrixBackStreamUs = 0;
     }
-    for (uint16_t i = 0; i < gMatrixLedsPerOutput[output]; i++) {
-      strip->setPixelColor(i, gMatrixBuffer[output][i]);
+    return;
+  }
+
+  // Frame boundary: the transmit task swaps this buffer in once the wire is
+  // free. Callers hold MatrixLock, so they must not wait for the wire here; a
+  // frame drawn before the swap simply replaces the queued one.
+  gMatrixFramePending = true;
+  xTaskNotifyGive(gMatrixTransmitTask);
+}
+
+// Transmit task, under MatrixLock, between sends: swap, and seed the new back
+// buffer with the frame about to go out so partial renderers keep
+// single-buffer semantics.
+void swapMatrixFrontBuffer() {
+  for (uint8_t output = 0; output < gMatrixActiveOutputs; output++) {
+    uint8_t *front = gMatrixPixels[output];
+    gMatrixPixels[output] = gMatrixFrontPixels[output];
+    gMatrixFrontPixels[output] = front;
+    if (front != nullptr && gMatrixPixels[output] != nullptr) {
+      memcpy(gMatrixPixels[output], front, static_cast<size_t>(gMatrixLedsPerOutput[output]) * kMatrixBytesPerLed);
     }
-    strip->show();
+  }
+  gMatrixFrontStreamUs = gMatrixBackStreamUs;
+  gMatrixBackStreamUs = 0;
+  gMatrixFramePending = false;
+}
+
+int64_t matrixFrameClockUs() {
+  if (!gMatrixPipelineRunning) {
+    return esp_timer_get_time();
+  }
+  return gMatrixFrameClockUs;
+}
+
+unsigned long matrixFrameClockMs() {
+  return static_cast<unsigned long>(matrixFrameClockUs() / 1000);
+}
+
+void waitMatrixTransmitIdle() {
+  if (gMatrixPipelineRunning) {
+    xSemaphoreTake(gMatrixFrontFree, portMAX_DELAY);
+    xSemaphoreGive(gMatrixFrontFree);
   }
 }
 
@@ -302,15 +1025,16 @@ void applyMatrixSolidColor(const RgbColor &color) {
     return;
   }
 
-  clearMatrixBuffer();
-
-  const uint32_t packed = packColor(color.r, color.g, color.b);
+  uint8_t encoded[kMatrixBytesPerLed] = {0};
+  writeMatrixPixel(encoded, packColor(color.r, color.g, color.b));
   for (uint8_t output = 0; output < gMatrixActiveOutputs; output++) {
-    if (gMatrixBuffer[output] == nullptr) {
+    uint8_t *pixel = gMatrixPixels[output];
+    if (pixel == nullptr) {
       continue;
     }
     for (uint16_t i = 0; i < gMatrixLedsPerOutput[output]; i++) {
-      gMatrixBuffer[output][i] = packed;
+      memcpy(pixel, encoded, kMatrixBytesPerLed);
+      pixel += kMatrixBytesPerLed;
     }
   }
   showMatrix();
@@ -322,20 +1046,42 @@ void setLedColor(uint8_t r, uint8_t g, uint8_t b) {
   applyBoardLedColor(gLedColor);
   if (gMatrixScrollRunning) {
     renderMatrixScrollFrame();
-  } else {
+  } else if (gMatrixEffect == nullptr) {
     applyMatrixSolidColor(gLedColor);
   }
 }
 
-void setMatrixBrightness(uint8_t value) {
-  gMatrixBrightness = value;
-  if (gMatrixReady && !gMatrixTestRunning) {
-    if (gMatrixScrollRunning) {
-      renderMatrixScrollFrame();
-    } else {
-      applyMatrixSolidColor(gLedColor);
-    }
+void applyMatrixOutputCurve(uint8_t brightness, float gamma) {
+  if (!gMatrixReady) {
+    gMatrixBrightness = brightness;
+    gMatrixGamma = gamma;
+    rebuildMatrixOutputLut();
+    return;
+  }
+
+  if (!gMatrixPipelineRunning) {
+    gMatrixBrightness = brightness;
+    gMatrixGamma = gamma;
+    rebuildMatrixOutputLut();
+    transmitMatrixFrame(gMatrixPixels);
+    return;
   }
+
+  // The frame on the wire is still valid; only the curve changed. The
+  // transmit task rebuilds the table between sends, so it never changes
+  // mid-encode, then resends the frame.
+  gMatrixBrightness = brightness;
+  gMatrixGamma = gamma;
+  gMatrixCurvePending = true;
+  xTaskNotifyGive(gMatrixTransmitTask);
+}
+
+void setMatrixBrightness(uint8_t value) {
+  applyMatrixOutputCurve(value, gMatrixGamma);
+}
+
+void setMatrixGamma(float value) {
+  applyMatrixOutputCurve(gMatrixBrightness, value);
 }
 
 String ledHexColor() {
@@ -373,6 +1119,64 @@ const char *matrixScanOrderToString(MatrixScanOrder order) {
   return order == MatrixScanOrder::ColumnMajor ? "column" : "row";
 }
 
+const char *matrixDriverToString(MatrixDriver driver) {
+  return driver == MatrixDriver::Parallel ? "parallel" : "neopixel";
+}
+
+const char *framePolicyToString(FramePolicy policy) {
+  return policy == FramePolicy::Skip ? "skip" : "catchup";
+}
+
+const char *serialLogPolicyToString(SerialLogPolicy policy) {
+  switch (policy) {
+    case SerialLogPolicy::On:
+      return "on";
+    case SerialLogPolicy::Off:
+      return "off";
+    case SerialLogPolicy::Auto:
+    default:
+      return "auto";
+  }
+}
+
+bool parseSerialLogPolicy(const String &value, SerialLogPolicy &out) {
+  String policy = value;
+  policy.trim();
+  policy.toLowerCase();
+
+  if (policy == "auto") {
+    out = SerialLogPolicy::Auto;
+    return true;
+  }
+  if (policy == "on" || policy == "1") {
+    out = SerialLogPolicy::On;
+    return true;
+  }
+  if (policy == "off" || policy == "0") {
+    out = SerialLogPolicy::Off;
+    return true;
+  }
+
+  return false;
+}
+
+bool parseFramePolicy(const String &value, FramePolicy &out) {
+  String policy = value;
+  policy.trim();
+  policy.toLowerCase();
+
+  if (policy == "catchup" || policy == "catch_up") {
+    out = FramePolicy::CatchUp;
+    return true;
+  }
+  if (policy == "skip" || policy == "drop") {
+    out = FramePolicy::Skip;
+    return true;
+  }
+
+  return false;
+}
+
 bool parseScrollDirection(const String &value, ScrollDirection &out) {
   String dir = value;
   dir.trim();
@@ -426,13 +1230,14 @@ bool parseBoolArg(const String &value, bool &out) {
 void applyMatrixFlips(bool xFlip, bool yFlip) {
   gMatrixXFlip = xFlip;
   gMatrixYFlip = yFlip;
+  rebuildMatrixPixelMap();
   if (!gMatrixReady) {
     return;
   }
 
   if (gMatrixScrollRunning) {
     renderMatrixScrollFrame();
-  } else {
+  } else if (gMatrixEffect == nullptr) {
     applyMatrixSolidColor(gLedColor);
   }
   Serial.printf("[OK] Matrix flip updated | x=%d | y=%d\n",
@@ -442,13 +1247,14 @@ void applyMatrixFlips(bool xFlip, bool yFlip) {
 
 void applyMatrixScanOrder(MatrixScanOrder order) {
   gMatrixScanOrder = order;
+  rebuildMatrixPixelMap();
   if (!gMatrixReady) {
     return;
   }
 
   if (gMatrixScrollRunning) {
     renderMatrixScrollFrame();
-  } else {
+  } else if (gMatrixEffect == nullptr) {
     applyMatrixSolidColor(gLedColor);
   }
   Serial.printf("[OK] Matrix scan mapping set to %s-major\n", matrixScanOrderToString(order));
@@ -513,10 +1319,25 @@ String matrixCountsCsv() {
   return counts;
 }
 
+String matrixHeightsCsv() {
+  String heights;
+  for (uint8_t i = 0; i < gMatrixActiveOutputs; i++) {
+    if (i > 0) {
+      heights += ",";
+    }
+    heights += String(gMatrixHeights[i]);
+  }
+  return heights;
+}
+
 uint16_t matrixWidth() {
   return gMatrixTotalWidth;
 }
 
+uint8_t matrixHeight() {
+  return gMatrixTotalHeight;
+}
+
 uint8_t clampActiveOutputs(int value) {
   if (value < 1) {
     return 1;
@@ -531,6 +1352,10 @@ bool isValidMatrixPin(int pin) {
   return pin >= 0 && pin < static_cast<int>(SOC_GPIO_PIN_COUNT);
 }
 
+bool isValidMatrixGamma(float gamma) {
+  return gamma >= kMatrixGammaMin && gamma <= kMatrixGammaMax;
+}
+
 void loadDefaultMatrixPins() {
   for (uint8_t i = 0; i < MATRIX_OUTPUT_COUNT; i++) {
     gMatrixPins[i] = kMatrixDefaultPins[i];
@@ -544,7 +1369,18 @@ void loadDefaultMatrixCounts() {
   }
 }
 
+void loadDefaultMatrixHeights() {
+  for (uint8_t i = 0; i < MATRIX_OUTPUT_COUNT; i++) {
+    gMatrixHeights[i] = MATRIX_HEIGHT;
+  }
+}
+
+bool isValidMatrixHeight(long height) {
+  return height >= 1 && height <= MATRIX_MAX_HEIGHT;
+}
+
 bool matrixCountsAreValid(const uint16_t counts[MATRIX_OUTPUT_COUNT],
+                         const uint8_t heights[MATRIX_OUTPUT_COUNT],
                          uint8_t activeOutputs,
                          String &errorCode) {
   uint32_t total = 0;
@@ -554,7 +1390,11 @@ bool matrixCountsAreValid(const uint16_t counts[MATRIX_OUTPUT_COUNT],
       errorCode = "count_zero_not_allowed";
       return false;
     }
-    if ((count % MATRIX_HEIGHT) != 0) {
+    if (!isValidMatrixHeight(heights[i])) {
+      errorCode = "height_out_of_range";
+      return false;
+    }
+    if ((count % heights[i]) != 0) {
       errorCode = "count_must_be_multiple_of_matrix_height";
       return false;
     }
@@ -571,26 +1411,47 @@ bool matrixCountsAreValid(const uint16_t counts[MATRIX_OUTPUT_COUNT],
 bool rebuildMatrixGeometry(const uint16_t counts[MATRIX_OUTPUT_COUNT],
                           uint8_t activeOutputs,
                           String &errorCode) {
-  if (!matrixCountsAreValid(counts, activeOutputs, errorCode)) {
+  if (!matrixCountsAreValid(counts, gMatrixHeights, activeOutputs, errorCode)) {
     return false;
   }
 
   uint16_t x = 0;
   uint32_t total = 0;
+  uint8_t height = 0;
   gMatrixXOffsets[0] = 0;
   for (uint8_t i = 0; i < activeOutputs; i++) {
-    gMatrixColsPerOutput[i] = static_cast<uint16_t>(counts[i] / MATRIX_HEIGHT);
+    gMatrixColsPerOutput[i] = static_cast<uint16_t>(counts[i] / gMatrixHeights[i]);
     x = static_cast<uint16_t>(x + gMatrixColsPerOutput[i]);
     gMatrixXOffsets[i + 1] = x;
     total += counts[i];
+    if (gMatrixHeights[i] > height) {
+      height = gMatrixHeights[i];
+    }
   }
   for (uint8_t i = activeOutputs; i < MATRIX_OUTPUT_COUNT; i++) {
     gMatrixColsPerOutput[i] = 0;
     gMatrixXOffsets[i + 1] = x;
   }
 
+  // A panel layout defines its own canvas; the strips above only size outputs.
+  if (gMatrixPanelCount > 0) {
+    x = 0;
+    height = 0;
+    for (uint8_t i = 0; i < gMatrixPanelCount; i++) {
+      const MatrixPanel &panel = gMatrixPanels[i];
+      if (panel.x + panel.width > x) {
+        x = static_cast<uint16_t>(panel.x + panel.width);
+      }
+      if (panel.y + panel.height > height) {
+        height = static_cast<uint8_t>(panel.y + panel.height);
+      }
+    }
+  }
+
   gMatrixTotalWidth = x;
+  gMatrixTotalHeight = height;
   gMatrixActiveLedCount = static_cast<uint16_t>(total);
+  rebuildMatrixPixelMap();
   return true;
 }
 
@@ -790,51 +1651,345 @@ bool parseMatrixPinsCsv(String csv,
   return true;
 }
 
-uint16_t detectRuntimeMaxLedCount() {
-  // WS2812 + internal strip buffer + frame buffer: ~7-8 bytes per LED.
-  // Reserve heap for Wi-Fi/WebServer and compute a safe runtime ceiling.
-  const uint32_t freeHeap = ESP.getFreeHeap();
-  const uint32_t reservedHeap = 48 * 1024;
-  const uint32_t minReasonable = gMatrixActiveOutputs * MATRIX_HEIGHT;
+bool parseMatrixHeightsCsv(String csv,
+                          uint8_t expectedCount,
+                          uint8_t outHeights[MATRIX_OUTPUT_COUNT],
+                          String &errorCode) {
+  csv.trim();
+  if (csv.length() == 0) {
+    errorCode = "heights_empty";
+    return false;
+  }
 
-  if (freeHeap <= reservedHeap) {
-    return static_cast<uint16_t>(minReasonable);
+  uint8_t count = 0;
+  int start = 0;
+  while (start <= csv.length()) {
+    const int separator = csv.indexOf(',', start);
+    String token = (separator < 0) ? csv.substring(start) : csv.substring(start, separator);
+    token.trim();
+    if (token.length() == 0) {
+      errorCode = "invalid_heights_format";
+      return false;
+    }
+
+    char *endPtr = nullptr;
+    const long height = strtol(token.c_str(), &endPtr, 10);
+    if (endPtr == token.c_str() || endPtr == nullptr || *endPtr != '\0') {
+      errorCode = "invalid_height_value";
+      return false;
+    }
+    if (!isValidMatrixHeight(height)) {
+      errorCode = "height_out_of_range";
+      return false;
+    }
+    if (count >= expectedCount) {
+      errorCode = "too_many_heights";
+      return false;
+    }
+
+    outHeights[count++] = static_cast<uint8_t>(height);
+
+    if (separator < 0) {
+      break;
+    }
+    start = separator + 1;
   }
 
-  uint32_t byHeap = (freeHeap - reservedHeap) / 8;
-  if (byHeap < minReasonable) {
-    byHeap = minReasonable;
+  if (count != expectedCount) {
+    errorCode = "heights_count_mismatch";
+    return false;
   }
-  if (byHeap > kMatrixCompiledMaxLedCount) {
-    byHeap = kMatrixCompiledMaxLedCount;
+  return true;
+}
+
+bool parsePanelWiring(String token, PanelWiring &out) {
+  token.trim();
+  token.toLowerCase();
+  if (token == "cs") {
+    out = PanelWiring::ColumnSerpentine;
+  } else if (token == "cp") {
+    out = PanelWiring::ColumnProgressive;
+  } else if (token == "rs") {
+    out = PanelWiring::RowSerpentine;
+  } else if (token == "rp") {
+    out = PanelWiring::RowProgressive;
+  } else {
+    return false;
   }
-  return static_cast<uint16_t>(byHeap);
+  return true;
 }
 
-void saveSettings() {
-  Preferences pref;
-  if (!pref.begin("ledcfg", false)) {
-    return;
+const char *panelWiringToString(PanelWiring wiring) {
+  switch (wiring) {
+    case PanelWiring::ColumnSerpentine:
+      return "cs";
+    case PanelWiring::ColumnProgressive:
+      return "cp";
+    case PanelWiring::RowSerpentine:
+      return "rs";
+    case PanelWiring::RowProgressive:
+      return "rp";
+    default:
+      return "default";
   }
-  pref.putUChar("r", gLedColor.r);
-  pref.putUChar("g", gLedColor.g);
-  pref.putUChar("b", gLedColor.b);
-  pref.putUChar("br", gMatrixBrightness);
-  pref.putInt("mpin", gMatrixDataPin);
-  pref.putUChar("mout", gMatrixActiveOutputs);
-  pref.putUChar("mscan", static_cast<uint8_t>(gMatrixScanOrder));
-  pref.putUChar("mxf", gMatrixXFlip ? 1 : 0);
-  pref.putUChar("myf", gMatrixYFlip ? 1 : 0);
-  for (uint8_t i = 0; i < MATRIX_OUTPUT_COUNT; i++) {
-    char pinKey[6];
-    char countKey[6];
-    snprintf(pinKey, sizeof(pinKey), "mp%u", static_cast<unsigned>(i));
-    snprintf(countKey, sizeof(countKey), "mc%u", static_cast<unsigned>(i));
-    pref.putUChar(pinKey, gMatrixPins[i]);
-    pref.putUShort(countKey, gMatrixLedsPerOutput[i]);
+}
+
+// Layout spec: panels separated by ';', each "output:x,y,w,h[,rotation[,wiring]]"
+// with a 1-based output, w/h as placed on the canvas, rotation 0/90/180/270
+// (clockwise) and wiring cs|cp|rs|rp. Panels on one output are chained in the
+// order listed and must fit in that output's LED count.
+bool parseMatrixLayout(String spec,
+                       const uint16_t counts[MATRIX_OUTPUT_COUNT],
+                       MatrixPanel outPanels[kMatrixLayoutMaxPanels],
+                       uint8_t &outCount,
+                       String &errorCode) {
+  spec.trim();
+  outCount = 0;
+  if (spec.length() == 0) {
+    errorCode = "layout_empty";
+    return false;
+  }
+
+  uint32_t usedLeds[MATRIX_OUTPUT_COUNT] = {0};
+  int start = 0;
+  while (start <= spec.length()) {
+    const int separator = spec.indexOf(';', start);
+    String item = (separator < 0) ? spec.substring(start) : spec.substring(start, separator);
+    item.trim();
+    if (item.length() > 0) {
+      const int colon = item.indexOf(':');
+      if (colon <= 0) {
+        errorCode = "invalid_layout_format";
+        return false;
+      }
+      if (outCount >= kMatrixLayoutMaxPanels) {
+        errorCode = "too_many_panels";
+        return false;
+      }
+
+      long values[5] = {0, 0, 0, 0, 0};
+      uint8_t valueCount = 0;
+      PanelWiring wiring = PanelWiring::Default;
+      String outputText = item.substring(0, colon);
+      outputText.trim();
+      char *endPtr = nullptr;
+      const long output = strtol(outputText.c_str(), &endPtr, 10);
+      if (endPtr == outputText.c_str() || endPtr == nullptr || *endPtr != '\0') {
+        errorCode = "invalid_layout_format";
+        return false;
+      }
+      if (output < 1 || output > MATRIX_OUTPUT_COUNT) {
+        errorCode = "layout_output_out_of_range";
+        return false;
+      }
+
+      int fieldStart = colon + 1;
+      while (fieldStart <= item.length()) {
+        const int comma = item.indexOf(',', fieldStart);
+        String field = (comma < 0) ? item.substring(fieldStart) : item.substring(fieldStart, comma);
+        field.trim();
+        if (valueCount == 5) {
+          if (!parsePanelWiring(field, wiring)) {
+            errorCode = "invalid_layout_wiring";
+            return false;
+          }
+          valueCount++;
+        } else if (valueCount < 5) {
+          const long value = strtol(field.c_str(), &endPtr, 10);
+          if (field.length() == 0 || endPtr == nullptr || *endPtr != '\0') {
+            errorCode = "invalid_layout_format";
+            return false;
+          }
+          values[valueCount++] = value;
+        } else {
+          errorCode = "invalid_layout_format";
+          return false;
+        }
+
+        if (comma < 0) {
+          break;
+        }
+        fieldStart = comma + 1;
+      }
+      if (valueCount < 4) {
+        errorCode = "invalid_layout_format";
+        return false;
+      }
+
+      const long x = values[0];
+      const long y = values[1];
+      const long width = values[2];
+      const long height = values[3];
+      const long rotation = values[4];
+      if (x < 0 || y < 0 || width < 1 || height < 1 || x + width > 65535 || y + height > MATRIX_MAX_HEIGHT) {
+        errorCode = "layout_panel_out_of_range";
+        return false;
+      }
+      if (rotation != 0 && rotation != 90 && rotation != 180 && rotation != 270) {
+        errorCode = "invalid_layout_rotation";
+        return false;
+      }
+
+      const uint8_t outputIndex = static_cast<uint8_t>(output - 1);
+      const uint32_t panelLeds = static_cast<uint32_t>(width) * height;
+      if (usedLeds[outputIndex] + panelLeds > counts[outputIndex]) {
+        errorCode = "layout_exceeds_counts";
+        return false;
+      }
+
+      MatrixPanel &panel = outPanels[outCount++];
+      panel.output = outputIndex;
+      panel.x = static_cast<uint16_t>(x);
+      panel.y = static_cast<uint8_t>(y);
+      panel.width = static_cast<uint16_t>(width);
+      panel.height = static_cast<uint8_t>(height);
+      panel.quarterTurns = static_cast<uint8_t>(rotation / 90);
+      panel.wiring = wiring;
+      panel.firstLed = static_cast<uint16_t>(usedLeds[outputIndex]);
+      usedLeds[outputIndex] += panelLeds;
+    }
+
+    if (separator < 0) {
+      break;
+    }
+    start = separator + 1;
+  }
+
+  if (outCount == 0) {
+    errorCode = "layout_empty";
+    return false;
+  }
+
+  // The canvas is the box around every panel, and the XY table holds one
+  // entry per canvas cell; sparse layouts must not blow it past the LEDs.
+  uint32_t canvasWidth = 0;
+  uint32_t canvasHeight = 0;
+  for (uint8_t i = 0; i < outCount; i++) {
+    const MatrixPanel &panel = outPanels[i];
+    if (static_cast<uint32_t>(panel.x) + panel.width > canvasWidth) {
+      canvasWidth = static_cast<uint32_t>(panel.x) + panel.width;
+    }
+    if (static_cast<uint32_t>(panel.y) + panel.height > canvasHeight) {
+      canvasHeight = static_cast<uint32_t>(panel.y) + panel.height;
+    }
+  }
+  if (canvasWidth * canvasHeight > MATRIX_MAX_LEDS) {
+    errorCode = "layout_canvas_too_large";
+    return false;
+  }
+  return true;
+}
+
+bool parseMatrixOutputBudgetsCsv(String csv,
+                                uint8_t expectedCount,
+                                uint16_t outBudgets[MATRIX_OUTPUT_COUNT],
+                                String &errorCode) {
+  csv.trim();
+  if (csv.length() == 0) {
+    errorCode = "output_current_empty";
+    return false;
+  }
+
+  uint8_t count = 0;
+  int start = 0;
+  while (start <= csv.length()) {
+    const int separator = csv.indexOf(',', start);
+    String token = (separator < 0) ? csv.substring(start) : csv.substring(start, separator);
+    token.trim();
+
+    char *endPtr = nullptr;
+    const long budget = strtol(token.c_str(), &endPtr, 10);
+    if (token.length() == 0 || endPtr == nullptr || *endPtr != '\0' || budget < 0 || budget > 65535) {
+      errorCode = "invalid_output_current";
+      return false;
+    }
+    if (count >= expectedCount) {
+      errorCode = "too_many_output_currents";
+      return false;
+    }
+
+    outBudgets[count++] = static_cast<uint16_t>(budget);
+
+    if (separator < 0) {
+      break;
+    }
+    start = separator + 1;
+  }
+
+  if (count != expectedCount) {
+    errorCode = "output_current_count_mismatch";
+    return false;
+  }
+  return true;
+}
+
+uint16_t detectRuntimeMaxLedCount() {
+  // Front/back frame buffers live in PSRAM; internal heap only holds the strip
+  // pixel memory: 3 bytes per LED plus allocator overhead, budgeted as 4.
+  // Reserve heap for Wi-Fi/WebServer and compute a safe runtime ceiling.
+  const uint32_t freeHeap = ESP.getFreeHeap();
+  const uint32_t reservedHeap = 48 * 1024;
+  const uint32_t minReasonable = gMatrixActiveOutputs * MATRIX_HEIGHT;
+
+  if (freeHeap <= reservedHeap) {
+    return static_cast<uint16_t>(minReasonable);
+  }
+
+  uint32_t byHeap = (freeHeap - reservedHeap) / 4;
+  if (byHeap < minReasonable) {
+    byHeap = minReasonable;
+  }
+  if (byHeap > kMatrixCompiledMaxLedCount) {
+    byHeap = kMatrixCompiledMaxLedCount;
+  }
+  return static_cast<uint16_t>(byHeap);
+}
+
+void saveSettings() {
+  Preferences pref;
+  if (!pref.begin("ledcfg", false)) {
+    return;
+  }
+  pref.putUChar("r", gLedColor.r);
+  pref.putUChar("g", gLedColor.g);
+  pref.putUChar("b", gLedColor.b);
+  pref.putUChar("br", gMatrixBrightness);
+  pref.putFloat("mgam", gMatrixGamma);
+  pref.putInt("mpin", gMatrixDataPin);
+  pref.putUChar("mout", gMatrixActiveOutputs);
+  pref.putUChar("mscan", static_cast<uint8_t>(gMatrixScanOrder));
+  pref.putUChar("mxf", gMatrixXFlip ? 1 : 0);
+  pref.putUChar("myf", gMatrixYFlip ? 1 : 0);
+  pref.putUShort("mfps", gMatrixTargetFps);
+  pref.putUChar("mfpol", static_cast<uint8_t>(gMatrixFramePolicy));
+  pref.putUChar("mfx", matrixEffectId(gMatrixEffect));
+  pref.putUShort("mfxb", gMatrixEffectBudgetUs);
+  pref.putUInt("mcur", gMatrixCurrentBudgetMa);
+  for (uint8_t i = 0; i < MATRIX_OUTPUT_COUNT; i++) {
+    char pinKey[6];
+    char countKey[6];
+    char heightKey[6];
+    char currentKey[6];
+    snprintf(pinKey, sizeof(pinKey), "mp%u", static_cast<unsigned>(i));
+    snprintf(countKey, sizeof(countKey), "mc%u", static_cast<unsigned>(i));
+    snprintf(heightKey, sizeof(heightKey), "mh%u", static_cast<unsigned>(i));
+    snprintf(currentKey, sizeof(currentKey), "ma%u", static_cast<unsigned>(i));
+    pref.putUChar(pinKey, gMatrixPins[i]);
+    pref.putUShort(countKey, gMatrixLedsPerOutput[i]);
+    pref.putUChar(heightKey, gMatrixHeights[i]);
+    pref.putUShort(currentKey, gMatrixOutputBudgetMa[i]);
   }
   pref.putUShort("mcount", gMatrixActiveLedCount);
   pref.putUChar("msdir", static_cast<uint8_t>(gMatrixScrollDirection));
+  pref.putString("mlay", gMatrixLayoutSpec);
+  pref.putUChar("e131", gE131Enabled ? 1 : 0);
+  pref.putUShort("e1uni", gE131StartUniverse);
+  pref.putUChar("mspo", gMatrixStreamUniversesPerOutput);
+  pref.putUChar("anet", gArtNetEnabled ? 1 : 0);
+  pref.putUShort("anuni", gArtNetStartPort);
+  pref.putUChar("ddp", gDdpEnabled ? 1 : 0);
+  pref.putUChar("sin", gSerialIngestEnabled ? 1 : 0);
+  pref.putUChar("slog", static_cast<uint8_t>(gSerialLogPolicy));
   pref.end();
 }
 
@@ -851,22 +2006,49 @@ void loadSettings() {
   const uint8_t g = pref.getUChar("g", 0);
   const uint8_t b = pref.getUChar("b", 0);
   const uint8_t br = pref.getUChar("br", MATRIX_BRIGHTNESS_DEFAULT);
+  const float gamma = pref.getFloat("mgam", MATRIX_GAMMA_DEFAULT);
   const uint8_t activeOutputsRaw = pref.getUChar("mout", gMatrixActiveOutputs);
   const uint16_t legacyTotalCount = pref.getUShort("mcount", 0);
   const uint8_t scrollDirRaw = pref.getUChar("msdir", static_cast<uint8_t>(ScrollDirection::Left));
   const uint8_t scanRaw = pref.getUChar("mscan", static_cast<uint8_t>(gMatrixScanOrder));
   const uint8_t xFlipRaw = pref.getUChar("mxf", gMatrixXFlip ? 1 : 0);
   const uint8_t yFlipRaw = pref.getUChar("myf", gMatrixYFlip ? 1 : 0);
+  const uint16_t fpsRaw = pref.getUShort("mfps", gMatrixTargetFps);
+  const uint8_t framePolicyRaw = pref.getUChar("mfpol", static_cast<uint8_t>(gMatrixFramePolicy));
+  const uint8_t effectRaw = pref.getUChar("mfx", 0);
+  const uint16_t effectBudgetRaw = pref.getUShort("mfxb", gMatrixEffectBudgetUs);
+  gMatrixCurrentBudgetMa = pref.getUInt("mcur", 0);
+  gE131Enabled = (pref.getUChar("e131", 0) != 0);
+  const uint16_t e131UniverseRaw = pref.getUShort("e1uni", MATRIX_E131_UNIVERSE);
+  const uint8_t streamPerOutputRaw = pref.getUChar("mspo", 0);
+  gE131StartUniverse = (e131UniverseRaw >= 1 && e131UniverseRaw <= kE131MaxUniverse) ? e131UniverseRaw
+                                                                                     : MATRIX_E131_UNIVERSE;
+  gMatrixStreamUniversesPerOutput = (streamPerOutputRaw <= kMatrixStreamMaxUniverses) ? streamPerOutputRaw : 0;
+  gArtNetEnabled = (pref.getUChar("anet", 0) != 0);
+  const uint16_t artNetPortRaw = pref.getUShort("anuni", 0);
+  gArtNetStartPort = (artNetPortRaw <= kArtNetMaxPortAddress) ? artNetPortRaw : 0;
+  gDdpEnabled = (pref.getUChar("ddp", 0) != 0);
+  gSerialIngestEnabled = (pref.getUChar("sin", 0) != 0);
+  const uint8_t serialLogRaw = pref.getUChar("slog", static_cast<uint8_t>(SerialLogPolicy::Auto));
+  gSerialLogPolicy = (serialLogRaw <= static_cast<uint8_t>(SerialLogPolicy::Off))
+                       ? static_cast<SerialLogPolicy>(serialLogRaw)
+                       : SerialLogPolicy::Auto;
 
   gMatrixActiveOutputs = clampActiveOutputs(static_cast<int>(activeOutputsRaw));
   gMatrixRuntimeMaxLedCount = detectRuntimeMaxLedCount();
 
   bool hasAnyPerOutputCount = false;
+  loadDefaultMatrixHeights();
   for (uint8_t i = 0; i < MATRIX_OUTPUT_COUNT; i++) {
     char pinKey[6];
     char countKey[6];
+    char heightKey[6];
+    char currentKey[6];
     snprintf(pinKey, sizeof(pinKey), "mp%u", static_cast<unsigned>(i));
     snprintf(countKey, sizeof(countKey), "mc%u", static_cast<unsigned>(i));
+    snprintf(heightKey, sizeof(heightKey), "mh%u", static_cast<unsigned>(i));
+    snprintf(currentKey, sizeof(currentKey), "ma%u", static_cast<unsigned>(i));
+    gMatrixOutputBudgetMa[i] = pref.getUShort(currentKey, 0);
 
     int loadedPin = kMatrixDefaultPins[i];
     if (pref.isKey(pinKey)) {
@@ -884,6 +2066,11 @@ void loadSettings() {
       gMatrixLedsPerOutput[i] = loadedCount;
       hasAnyPerOutputCount = true;
     }
+
+    const uint8_t loadedHeight = pref.getUChar(heightKey, MATRIX_HEIGHT);
+    if (isValidMatrixHeight(loadedHeight)) {
+      gMatrixHeights[i] = loadedHeight;
+    }
   }
 
   if (!hasAnyPerOutputCount && legacyTotalCount > 0) {
@@ -896,8 +2083,21 @@ void loadSettings() {
       }
     }
   }
+  const String layoutSpec = pref.getString("mlay", "");
   pref.end();
 
+  gMatrixPanelCount = 0;
+  gMatrixLayoutSpec = "";
+  if (layoutSpec.length() > 0) {
+    String layoutError;
+    if (parseMatrixLayout(layoutSpec, gMatrixLedsPerOutput, gMatrixPanels, gMatrixPanelCount, layoutError)) {
+      gMatrixLayoutSpec = layoutSpec;
+    } else {
+      gMatrixPanelCount = 0;
+      Serial.printf("[WARN] Stored matrix layout ignored: %s\n", layoutError.c_str());
+    }
+  }
+
   if (!matrixPinsAreUnique(gMatrixPins, gMatrixActiveOutputs)) {
     loadDefaultMatrixPins();
   } else {
@@ -907,13 +2107,17 @@ void loadSettings() {
   String geometryError;
   if (!rebuildMatrixGeometry(gMatrixLedsPerOutput, gMatrixActiveOutputs, geometryError)) {
     loadDefaultMatrixCounts();
+    loadDefaultMatrixHeights();
     if (!rebuildMatrixGeometry(gMatrixLedsPerOutput, gMatrixActiveOutputs, geometryError)) {
       gMatrixActiveLedCount = gMatrixActiveOutputs * MATRIX_HEIGHT;
       gMatrixTotalWidth = gMatrixActiveOutputs;
+      gMatrixTotalHeight = MATRIX_HEIGHT;
     }
   }
 
   gMatrixBrightness = br;
+  gMatrixGamma = isValidMatrixGamma(gamma) ? gamma : MATRIX_GAMMA_DEFAULT;
+  rebuildMatrixOutputLut();
   gMatrixScrollDirection = (scrollDirRaw == static_cast<uint8_t>(ScrollDirection::Right))
                              ? ScrollDirection::Right
                              : ScrollDirection::Left;
@@ -922,116 +2126,408 @@ void loadSettings() {
                        : MatrixScanOrder::ColumnMajor;
   gMatrixXFlip = (xFlipRaw != 0);
   gMatrixYFlip = (yFlipRaw != 0);
+  gMatrixTargetFps = constrain(fpsRaw, kMatrixFpsMin, kMatrixFpsMax);
+  gMatrixFramePolicy = (framePolicyRaw == static_cast<uint8_t>(FramePolicy::Skip)) ? FramePolicy::Skip
+                                                                                    : FramePolicy::CatchUp;
+  gMatrixEffectBudgetUs = constrain(effectBudgetRaw, kMatrixEffectBudgetMinUs, kMatrixEffectBudgetMaxUs);
+  // Started from setup() once the matrix is up.
+  gMatrixEffect = matrixEffectById(effectRaw);
+  rebuildMatrixPixelMap();
   setLedColor(r, g, b);
 }
 
-String jsonEscape(const String &value) {
-  String out;
-  out.reserve(value.length() + 8);
-  for (size_t i = 0; i < value.length(); i++) {
-    const char c = value.charAt(i);
-    switch (c) {
-      case '"':
-        out += "\\\"";
-        break;
-      case '\\':
-        out += "\\\\";
-        break;
-      case '\n':
-        out += "\\n";
-        break;
-      case '\r':
-        out += "\\r";
-        break;
-      case '\t':
-        out += "\\t";
-        break;
-      default:
-        out += c;
+// Writes JSON into a fixed buffer without touching the heap. A fields=
+// filter (comma separated top-level keys, a trailing * matches a prefix)
+// drops unselected keys with their values. Keys written as live are
+// counters and rates that change between polls, so a document holding one
+// gets no ETag.
+struct JsonWriter {
+  static const uint8_t kMaxDepth = 4;
+
+  char *buffer;
+  size_t capacity;
+  const char *fields;
+  size_t length = 0;
+  uint8_t depth = 0;
+  bool hasItem[kMaxDepth] = {};
+  bool afterKey = false;
+  bool overflow = false;
+  bool live = false;
+
+  JsonWriter(char *out, size_t outCapacity, const char *filter)
+      : buffer(out), capacity(outCapacity), fields((filter != nullptr && filter[0] != '\0') ? filter : nullptr) {}
+
+  void beginObject() {
+    separate();
+    put('{');
+    push();
+  }
+  void endObject() {
+    pop();
+    put('}');
+  }
+  void beginArray() {
+    separate();
+    put('[');
+    push();
+  }
+  void endArray() {
+    pop();
+    put(']');
+  }
+
+  // Starts a key; false (and nothing written) when the filter skips it.
+  bool key(const char *name, bool isLive = false) {
+    if (depth == 1 && !selected(name)) {
+      return false;
+    }
+    separate();
+    writeQuoted(name);
+    put(':');
+    afterKey = true;
+    live = live || isLive;
+    return true;
+  }
+
+  void number(uint32_t value) {
+    char text[12];
+    snprintf(text, sizeof(text), "%lu", static_cast<unsigned long>(value));
+    raw(text);
+  }
+  void signedNumber(int32_t value) {
+    char text[12];
+    snprintf(text, sizeof(text), "%ld", static_cast<long>(value));
+    raw(text);
+  }
+  void fixed(float value, uint8_t decimals) {
+    char text[24];
+    snprintf(text, sizeof(text), "%.*f", static_cast<int>(decimals), static_cast<double>(value));
+    raw(text);
+  }
+  void flag(bool value) {
+    raw(value ? "1" : "0");
+  }
+  void string(const char *value) {
+    separate();
+    writeQuoted(value);
+  }
+  void ip(const IPAddress &value) {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", value[0], value[1], value[2], value[3]);
+    string(text);
+  }
+
+  // Comma separated list written as one string value, e.g. "14,17".
+  template <typename T>
+  void csv(const T *values, uint8_t count) {
+    separate();
+    put('"');
+    for (uint8_t i = 0; i < count; i++) {
+      char text[12];
+      snprintf(text, sizeof(text), i > 0 ? ",%lu" : "%lu", static_cast<unsigned long>(values[i]));
+      putText(text);
+    }
+    put('"');
+  }
+  void csvNames(const MatrixEffect *effects, uint8_t count) {
+    separate();
+    put('"');
+    for (uint8_t i = 0; i < count; i++) {
+      if (i > 0) {
+        put(',');
+      }
+      writeEscaped(effects[i].name);
+    }
+    put('"');
+  }
+
+  void addNumber(const char *name, uint32_t value, bool isLive = false) {
+    if (key(name, isLive)) {
+      number(value);
+    }
+  }
+  void addSigned(const char *name, int32_t value, bool isLive = false) {
+    if (key(name, isLive)) {
+      signedNumber(value);
+    }
+  }
+  void addFixed(const char *name, float value, uint8_t decimals, bool isLive = false) {
+    if (key(name, isLive)) {
+      fixed(value, decimals);
+    }
+  }
+  void addFlag(const char *name, bool value, bool isLive = false) {
+    if (key(name, isLive)) {
+      flag(value);
+    }
+  }
+  void addString(const char *name, const char *value) {
+    if (key(name)) {
+      string(value);
+    }
+  }
+  void addIp(const char *name, const IPAddress &value) {
+    if (key(name)) {
+      ip(value);
+    }
+  }
+  template <typename T>
+  void addCsv(const char *name, const T *values, uint8_t count, bool isLive = false) {
+    if (key(name, isLive)) {
+      csv(values, count);
+    }
+  }
+
+  bool selected(const char *name) const {
+    if (fields == nullptr) {
+      return true;
+    }
+    const char *token = fields;
+    while (*token != '\0') {
+      const char *end = strchr(token, ',');
+      const size_t tokenLength = (end != nullptr) ? static_cast<size_t>(end - token) : strlen(token);
+      if (tokenLength > 0 && token[tokenLength - 1] == '*') {
+        if (strncmp(name, token, tokenLength - 1) == 0) {
+          return true;
+        }
+      } else if (tokenLength > 0 && strncmp(name, token, tokenLength) == 0 && name[tokenLength] == '\0') {
+        return true;
+      }
+      if (end == nullptr) {
         break;
+      }
+      token = end + 1;
     }
+    return false;
   }
-  return out;
-}
 
-void loadWifiSettings(String &ssid, String &password) {
-  ssid = "";
-  password = "";
+  void separate() {
+    if (afterKey) {
+      afterKey = false;
+      return;
+    }
+    if (depth > 0 && depth <= kMaxDepth) {
+      if (hasItem[depth - 1]) {
+        put(',');
+      }
+      hasItem[depth - 1] = true;
+    }
+  }
+  void push() {
+    if (depth < kMaxDepth) {
+      hasItem[depth] = false;
+    }
+    depth++;
+  }
+  void pop() {
+    if (depth > 0) {
+      depth--;
+    }
+  }
+  void raw(const char *text) {
+    separate();
+    putText(text);
+  }
+  void writeQuoted(const char *text) {
+    put('"');
+    writeEscaped(text);
+    put('"');
+  }
+  void writeEscaped(const char *text) {
+    for (; *text != '\0'; text++) {
+      const char c = *text;
+      switch (c) {
+        case '"':
+          putText("\\\"");
+          break;
+        case '\\':
+          putText("\\\\");
+          break;
+        case '\n':
+          putText("\\n");
+          break;
+        case '\r':
+          putText("\\r");
+          break;
+        case '\t':
+          putText("\\t");
+          break;
+        default:
+          if (static_cast<uint8_t>(c) < 0x20) {
+            // Other control bytes are not allowed raw inside a JSON string.
+            char text[7];
+            snprintf(text, sizeof(text), "\\u%04x", static_cast<unsigned>(c));
+            putText(text);
+          } else {
+            put(c);
+          }
+          break;
+      }
+    }
+  }
+  void putText(const char *text) {
+    for (; *text != '\0'; text++) {
+      put(*text);
+    }
+  }
+  void put(char c) {
+    if (length + 1 >= capacity) {
+      overflow = true;
+      return;
+    }
+    buffer[length++] = c;
+    buffer[length] = '\0';
+  }
+};
+
+void wifiNetworkKey(char (&key)[8], const char *field, uint8_t slot) {
+  snprintf(key, sizeof(key), "%s%u", field, static_cast<unsigned>(slot));
+}
 
+void loadWifiNetworks() {
+  gWifiNetworkCount = 0;
   Preferences pref;
   if (!pref.begin("wifi", true)) {
     return;
   }
-  ssid = pref.getString("ssid", "");
-  password = pref.getString("pass", "");
+  const uint8_t count = pref.getUChar("n", 0);
+  char key[8];
+  for (uint8_t i = 0; i < count && i < kWifiMaxNetworks; i++) {
+    WifiNetwork &net = gWifiNetworks[gWifiNetworkCount];
+    net = WifiNetwork();
+    wifiNetworkKey(key, "s", i);
+    net.ssid = pref.getString(key, "");
+    wifiNetworkKey(key, "p", i);
+    net.password = pref.getString(key, "");
+    wifiNetworkKey(key, "b", i);
+    if (pref.getBytes(key, net.bssid, sizeof(net.bssid)) == sizeof(net.bssid)) {
+      wifiNetworkKey(key, "c", i);
+      net.channel = pref.getUChar(key, 0);
+    }
+    wifiNetworkKey(key, "r", i);
+    net.rssi = pref.getChar(key, kWifiRssiUnknown);
+    wifiNetworkKey(key, "ip", i);
+    net.ip = pref.getUInt(key, 0);
+    wifiNetworkKey(key, "gw", i);
+    net.gateway = pref.getUInt(key, 0);
+    wifiNetworkKey(key, "nm", i);
+    net.subnet = pref.getUInt(key, 0);
+    wifiNetworkKey(key, "dn", i);
+    net.dns = pref.getUInt(key, 0);
+    if (net.ssid.length() > 0) {
+      gWifiNetworkCount++;
+    }
+  }
+  // The single network older firmware stored.
+  if (gWifiNetworkCount == 0 && pref.isKey("ssid")) {
+    gWifiNetworks[0] = WifiNetwork();
+    gWifiNetworks[0].ssid = pref.getString("ssid", "");
+    gWifiNetworks[0].password = pref.getString("pass", "");
+    gWifiNetworkCount = (gWifiNetworks[0].ssid.length() > 0) ? 1 : 0;
+  }
   pref.end();
 }
 
-void saveWifiSettings(const String &ssid, const String &password) {
+void saveWifiNetworks() {
   Preferences pref;
   if (!pref.begin("wifi", false)) {
     return;
   }
-  pref.putString("ssid", ssid);
-  pref.putString("pass", password);
+  pref.putUChar("n", gWifiNetworkCount);
+  char key[8];
+  for (uint8_t i = 0; i < kWifiMaxNetworks; i++) {
+    if (i >= gWifiNetworkCount) {
+      static const char *const kFields[] = {"s", "p", "b", "c", "r", "ip", "gw", "nm", "dn"};
+      for (const char *field : kFields) {
+        wifiNetworkKey(key, field, i);
+        pref.remove(key);
+      }
+      continue;
+    }
+    const WifiNetwork &net = gWifiNetworks[i];
+    wifiNetworkKey(key, "s", i);
+    pref.putString(key, net.ssid);
+    wifiNetworkKey(key, "p", i);
+    pref.putString(key, net.password);
+    wifiNetworkKey(key, "b", i);
+    pref.putBytes(key, net.bssid, sizeof(net.bssid));
+    wifiNetworkKey(key, "c", i);
+    pref.putUChar(key, net.channel);
+    wifiNetworkKey(key, "r", i);
+    pref.putChar(key, net.rssi);
+    wifiNetworkKey(key, "ip", i);
+    pref.putUInt(key, net.ip);
+    wifiNetworkKey(key, "gw", i);
+    pref.putUInt(key, net.gateway);
+    wifiNetworkKey(key, "nm", i);
+    pref.putUInt(key, net.subnet);
+    wifiNetworkKey(key, "dn", i);
+    pref.putUInt(key, net.dns);
+  }
+  pref.remove("ssid");
+  pref.remove("pass");
   pref.end();
 }
 
-void clearWifiSettings() {
+void clearWifiNetworks() {
   Preferences pref;
   if (!pref.begin("wifi", false)) {
     return;
   }
-  pref.remove("ssid");
-  pref.remove("pass");
+  pref.clear();
   pref.end();
+  gWifiNetworkCount = 0;
 }
 
-bool connectWifiWithCredentials(const String &ssid, const String &password, unsigned long timeoutMs = 15000) {
-  if (ssid.length() == 0) {
-    return false;
-  }
-
-  Serial.printf("Connecting to Wi-Fi: %s\n", ssid.c_str());
-  WiFi.mode(gApMode ? WIFI_AP_STA : WIFI_STA);
-  WiFi.setAutoReconnect(true);
-  WiFi.persistent(false);
-  WiFi.begin(ssid.c_str(), password.c_str());
-
-  const unsigned long start = millis();
-  while (WiFi.status() != WL_CONNECTED && (millis() - start) < timeoutMs) {
-    delay(250);
-    Serial.print('.');
+int8_t findWifiNetwork(const String &ssid) {
+  for (uint8_t i = 0; i < gWifiNetworkCount; i++) {
+    if (gWifiNetworks[i].ssid == ssid) {
+      return static_cast<int8_t>(i);
+    }
   }
-  Serial.println();
+  return -1;
+}
 
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.printf("[FAIL] Wi-Fi did not connect (status=%d)\n", static_cast<int>(WiFi.status()));
-    return false;
+// Strongest first; networks never joined keep their order at the end.
+void rankWifiNetworks() {
+  for (uint8_t i = 1; i < gWifiNetworkCount; i++) {
+    for (uint8_t j = i; j > 0 && gWifiNetworks[j].rssi > gWifiNetworks[j - 1].rssi; j--) {
+      std::swap(gWifiNetworks[j], gWifiNetworks[j - 1]);
+    }
   }
-
-  Serial.println("[OK] Wi-Fi connected.");
-  Serial.printf("SSID: %s\n", WiFi.SSID().c_str());
-  Serial.printf("IP: %s\n", WiFi.localIP().toString().c_str());
-  Serial.printf("RSSI: %d dBm\n", WiFi.RSSI());
-  return true;
 }
 
-bool connectConfiguredWifi() {
-  String storedSsid;
-  String storedPassword;
-  loadWifiSettings(storedSsid, storedPassword);
+// RSSI is left out: it moves on every join and would rewrite NVS each time.
+bool sameWifiNetwork(const WifiNetwork &a, const WifiNetwork &b) {
+  return a.ssid == b.ssid && a.password == b.password && memcmp(a.bssid, b.bssid, sizeof(a.bssid)) == 0 &&
+         a.channel == b.channel && a.ip == b.ip && a.gateway == b.gateway && a.subnet == b.subnet &&
+         a.dns == b.dns;
+}
 
-  if (storedSsid.length() > 0) {
-    return connectWifiWithCredentials(storedSsid, storedPassword);
+// Adds or updates a network; a full store drops the weakest one.
+void storeWifiNetwork(const WifiNetwork &net) {
+  int8_t index = findWifiNetwork(net.ssid);
+  if (index >= 0 && sameWifiNetwork(gWifiNetworks[index], net)) {
+    return;
   }
-
-  if (strlen(WIFI_SSID) == 0) {
-    Serial.println("[INFO] Wi-Fi not configured (no saved credentials and empty WIFI_SSID).");
-    return false;
+  if (index < 0) {
+    rankWifiNetworks();
+    index = static_cast<int8_t>((gWifiNetworkCount < kWifiMaxNetworks) ? gWifiNetworkCount++ : kWifiMaxNetworks - 1);
   }
+  gWifiNetworks[index] = net;
+  saveWifiNetworks();
+}
 
-  return connectWifiWithCredentials(String(WIFI_SSID), String(WIFI_PASSWORD));
+void removeWifiNetwork(const String &ssid) {
+  const int8_t index = findWifiNetwork(ssid);
+  if (index < 0) {
+    return;
+  }
+  for (uint8_t i = static_cast<uint8_t>(index); i + 1 < gWifiNetworkCount; i++) {
+    gWifiNetworks[i] = gWifiNetworks[i + 1];
+  }
+  gWifiNetworkCount--;
+  saveWifiNetworks();
 }
 
 bool startConfigAp() {
@@ -1078,763 +2574,2137 @@ uint32_t colorWheel(uint8_t pos) {
   return packColor(pos * 3, 255 - pos * 3, 0);
 }
 
-bool mapMatrixXY(uint16_t x, uint8_t y, uint8_t &output, uint16_t &index) {
-  if (matrixWidth() == 0 || x >= matrixWidth() || y >= MATRIX_HEIGHT) {
-    return false;
-  }
-
-  uint16_t mappedX = gMatrixXFlip ? (matrixWidth() - 1 - x) : x;
-  const uint8_t mappedY = gMatrixYFlip ? (MATRIX_HEIGHT - 1 - y) : y;
+// The strip wall as matrix_map.h sees it; serpentine stays a build flag.
+struct MatrixStripGeometry {
+  static uint16_t width() { return matrixWidth(); }
+  static uint8_t height() { return matrixHeight(); }
+  static uint8_t activeOutputs() { return gMatrixActiveOutputs; }
+  static uint16_t xOffset(uint8_t output) { return gMatrixXOffsets[output]; }
+  static uint16_t outputWidth(uint8_t output) { return gMatrixColsPerOutput[output]; }
+  static uint8_t outputHeight(uint8_t output) { return gMatrixHeights[output]; }
+  static uint16_t outputLeds(uint8_t output) { return gMatrixLedsPerOutput[output]; }
+};
 
-  const uint32_t logical = static_cast<uint32_t>(mappedY) * matrixWidth() + mappedX;
-  if (logical >= gMatrixActiveLedCount) {
+// Panel layouts resolve through the panel list; the XY table hides the
+// search, so this only runs when the table is rebuilt.
+bool mapMatrixLayoutXY(uint16_t x, uint8_t y, uint8_t &output, uint16_t &index) {
+  if (x >= matrixWidth() || y >= matrixHeight()) {
     return false;
   }
+  const uint16_t canvasX = gMatrixXFlip ? (matrixWidth() - 1 - x) : x;
+  const uint8_t canvasY = gMatrixYFlip ? (matrixHeight() - 1 - y) : y;
 
-  output = 0;
-  while (output < gMatrixActiveOutputs && mappedX >= gMatrixXOffsets[output + 1]) {
-    output++;
-  }
-  if (output >= gMatrixActiveOutputs) {
-    return false;
-  }
+  // Later panels win where panels overlap.
+  for (int8_t i = static_cast<int8_t>(gMatrixPanelCount) - 1; i >= 0; i--) {
+    const MatrixPanel &panel = gMatrixPanels[i];
+    if (canvasX < panel.x || canvasX >= panel.x + panel.width || canvasY < panel.y ||
+        canvasY >= panel.y + panel.height) {
+      continue;
+    }
+    if (panel.output >= gMatrixActiveOutputs) {
+      return false;
+    }
 
-  uint16_t localX = static_cast<uint16_t>(mappedX - gMatrixXOffsets[output]);
-  const uint16_t outputWidth = gMatrixColsPerOutput[output];
-  if (outputWidth == 0 || localX >= outputWidth) {
-    return false;
-  }
+    // Undo the rotation to get the panel's own column/row.
+    const uint16_t u = canvasX - panel.x;
+    const uint16_t v = canvasY - panel.y;
+    const bool quarter = (panel.quarterTurns & 0x01) != 0;
+    const uint16_t nativeWidth = quarter ? panel.height : panel.width;
+    const uint16_t nativeHeight = quarter ? panel.width : panel.height;
+    uint16_t col = u;
+    uint16_t row = v;
+    switch (panel.quarterTurns) {
+      case 1:
+        col = v;
+        row = static_cast<uint16_t>(panel.width - 1 - u);
+        break;
+      case 2:
+        col = static_cast<uint16_t>(panel.width - 1 - u);
+        row = static_cast<uint16_t>(panel.height - 1 - v);
+        break;
+      case 3:
+        col = static_cast<uint16_t>(panel.height - 1 - v);
+        row = u;
+        break;
+      default:
+        break;
+    }
 
-  uint8_t localY = mappedY;
-  if (gMatrixScanOrder == MatrixScanOrder::ColumnMajor) {
-    if (MATRIX_SERPENTINE && ((localX & 0x01) != 0)) {
-      localY = MATRIX_HEIGHT - 1 - localY;
+    PanelWiring wiring = panel.wiring;
+    if (wiring == PanelWiring::Default) {
+      const bool columnMajor = gMatrixScanOrder == MatrixScanOrder::ColumnMajor;
+      if (MATRIX_SERPENTINE) {
+        wiring = columnMajor ? PanelWiring::ColumnSerpentine : PanelWiring::RowSerpentine;
+      } else {
+        wiring = columnMajor ? PanelWiring::ColumnProgressive : PanelWiring::RowProgressive;
+      }
     }
-    index = static_cast<uint16_t>(localX) * MATRIX_HEIGHT + localY;
-  } else {
-    if (MATRIX_SERPENTINE && ((localY & 0x01) != 0)) {
-      localX = outputWidth - 1 - localX;
+    uint32_t local = 0;
+    if (wiring == PanelWiring::ColumnSerpentine || wiring == PanelWiring::ColumnProgressive) {
+      if (wiring == PanelWiring::ColumnSerpentine && (col & 0x01) != 0) {
+        row = static_cast<uint16_t>(nativeHeight - 1 - row);
+      }
+      local = static_cast<uint32_t>(col) * nativeHeight + row;
+    } else {
+      if (wiring == PanelWiring::RowSerpentine && (row & 0x01) != 0) {
+        col = static_cast<uint16_t>(nativeWidth - 1 - col);
+      }
+      local = static_cast<uint32_t>(row) * nativeWidth + col;
     }
-    index = static_cast<uint16_t>(localY) * outputWidth + localX;
-  }
-  return index < gMatrixLedsPerOutput[output];
-}
 
-void setMatrixPixel(uint16_t x, uint8_t y, uint32_t color) {
-  uint8_t output = 0;
-  uint16_t index = 0;
-  if (mapMatrixXY(x, y, output, index)) {
-    gMatrixBuffer[output][index] = color;
+    const uint32_t led = panel.firstLed + local;
+    if (led >= gMatrixLedsPerOutput[panel.output]) {
+      return false;
+    }
+    output = panel.output;
+    index = static_cast<uint16_t>(led);
+    return true;
   }
+  return false;
 }
 
-bool loadGlyphRows(char c, uint8_t rows[kScrollFontHeight]) {
-  memset(rows, 0, kScrollFontHeight);
-
-  // 5x6 lowercase glyphs.
-  switch (c) {
-    case 'a': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'b': {
-      const uint8_t data[kScrollFontHeight] = {0x10, 0x10, 0x1E, 0x11, 0x11, 0x1E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'c': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x0E, 0x11, 0x10, 0x11, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'd': {
-      const uint8_t data[kScrollFontHeight] = {0x01, 0x01, 0x0F, 0x11, 0x11, 0x0F};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'e': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'f': {
-      const uint8_t data[kScrollFontHeight] = {0x06, 0x08, 0x1E, 0x08, 0x08, 0x08};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'g': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x0F, 0x11, 0x0F, 0x01, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'h': {
-      const uint8_t data[kScrollFontHeight] = {0x10, 0x10, 0x1E, 0x11, 0x11, 0x11};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'i': {
-      const uint8_t data[kScrollFontHeight] = {0x04, 0x00, 0x0C, 0x04, 0x04, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'j': {
-      const uint8_t data[kScrollFontHeight] = {0x02, 0x00, 0x02, 0x02, 0x12, 0x0C};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'k': {
-      const uint8_t data[kScrollFontHeight] = {0x10, 0x12, 0x14, 0x18, 0x14, 0x12};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'l': {
-      const uint8_t data[kScrollFontHeight] = {0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'm': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x1A, 0x15, 0x15, 0x15, 0x15};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'n': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x1E, 0x11, 0x11, 0x11, 0x11};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'o': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'p': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x1E, 0x11, 0x1E, 0x10, 0x10};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'q': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x0F, 0x11, 0x0F, 0x01, 0x01};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'r': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x16, 0x19, 0x10, 0x10, 0x10};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 's': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x0F, 0x10, 0x0E, 0x01, 0x1E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 't': {
-      const uint8_t data[kScrollFontHeight] = {0x08, 0x1E, 0x08, 0x08, 0x08, 0x06};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'u': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x11, 0x11, 0x11, 0x13, 0x0D};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'v': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x11, 0x11, 0x11, 0x0A, 0x04};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'w': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x11, 0x11, 0x15, 0x15, 0x0A};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'x': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'y': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x11, 0x11, 0x0F, 0x01, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'z': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    default:
+void selectMatrixMapXY() {
+  if (gMatrixPanelCount > 0) {
+    gMatrixMapXY = mapMatrixLayoutXY;
+    return;
+  }
+  const uint8_t variant = (gMatrixXFlip ? 1 : 0) | (gMatrixYFlip ? 2 : 0) |
+                          (gMatrixScanOrder == MatrixScanOrder::ColumnMajor ? 4 : 0);
+  bool uniformHeight = true;
+  for (uint8_t i = 0; i < gMatrixActiveOutputs; i++) {
+    if (gMatrixHeights[i] != MATRIX_HEIGHT) {
+      uniformHeight = false;
       break;
+    }
   }
+  static const bool kSerpentine = (MATRIX_SERPENTINE != 0);
+  gMatrixMapXY = uniformHeight ? matrixMapXYVariant<MatrixStripGeometry, kSerpentine, MATRIX_HEIGHT>(variant)
+                               : matrixMapXYVariant<MatrixStripGeometry, kSerpentine, 0>(variant);
+}
 
-  const char up = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+bool mapMatrixXY(uint16_t x, uint8_t y, uint8_t &output, uint16_t &index) {
+  if (gMatrixMapXY == nullptr) {
+    selectMatrixMapXY();
+  }
+  return gMatrixMapXY(x, y, output, index);
+}
 
-  switch (up) {
-    case 'A': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x1F, 0x11, 0x11, 0x11};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'B': {
-      const uint8_t data[kScrollFontHeight] = {0x1E, 0x11, 0x1E, 0x11, 0x11, 0x1E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'C': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x10, 0x10, 0x11, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'D': {
-      const uint8_t data[kScrollFontHeight] = {0x1E, 0x11, 0x11, 0x11, 0x11, 0x1E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'E': {
-      const uint8_t data[kScrollFontHeight] = {0x1F, 0x10, 0x1E, 0x10, 0x10, 0x1F};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'F': {
-      const uint8_t data[kScrollFontHeight] = {0x1F, 0x10, 0x1E, 0x10, 0x10, 0x10};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'G': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x10, 0x13, 0x11, 0x0F};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'H': {
-      const uint8_t data[kScrollFontHeight] = {0x11, 0x11, 0x1F, 0x11, 0x11, 0x11};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'I': {
-      const uint8_t data[kScrollFontHeight] = {0x1F, 0x04, 0x04, 0x04, 0x04, 0x1F};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'J': {
-      const uint8_t data[kScrollFontHeight] = {0x01, 0x01, 0x01, 0x11, 0x11, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'K': {
-      const uint8_t data[kScrollFontHeight] = {0x11, 0x12, 0x1C, 0x12, 0x11, 0x11};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'L': {
-      const uint8_t data[kScrollFontHeight] = {0x10, 0x10, 0x10, 0x10, 0x10, 0x1F};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'M': {
-      const uint8_t data[kScrollFontHeight] = {0x11, 0x1B, 0x15, 0x11, 0x11, 0x11};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'N': {
-      const uint8_t data[kScrollFontHeight] = {0x11, 0x19, 0x15, 0x13, 0x11, 0x11};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'O': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x11, 0x11, 0x11, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'P': {
-      const uint8_t data[kScrollFontHeight] = {0x1E, 0x11, 0x1E, 0x10, 0x10, 0x10};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'Q': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x11, 0x15, 0x12, 0x0D};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'R': {
-      const uint8_t data[kScrollFontHeight] = {0x1E, 0x11, 0x1E, 0x12, 0x11, 0x11};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
-    }
-    case 'S': {
-      const uint8_t data[kScrollFontHeight] = {0x0F, 0x10, 0x0E, 0x01, 0x11, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+void releaseMatrixPixelMap() {
+  if (gMatrixPixelMap != nullptr) {
+    heap_caps_free(gMatrixPixelMap);
+    gMatrixPixelMap = nullptr;
+  }
+  gMatrixPixelMapCells = 0;
+  gMatrixPixelMapWidth = 0;
+}
+
+void rebuildMatrixPixelMap() {
+  // Resolve flips, output lookup, scan order and serpentine once per layout
+  // change so setMatrixPixel() is a single indexed store. Every layout change
+  // lands here, so this is also where the specialized mapping is swapped in.
+  selectMatrixMapXY();
+  const uint16_t width = matrixWidth();
+  const uint32_t cells = static_cast<uint32_t>(width) * matrixHeight();
+  if (cells == 0) {
+    releaseMatrixPixelMap();
+    return;
+  }
+
+  if (cells != gMatrixPixelMapCells) {
+    releaseMatrixPixelMap();
+    const size_t bytes = cells * sizeof(MatrixMapEntry);
+#if MATRIX_MAX_LEDS < 8192
+    gMatrixPixelMap = static_cast<MatrixMapEntry *>(heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+#else
+    gMatrixPixelMap = static_cast<MatrixMapEntry *>(heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+#endif
+    if (gMatrixPixelMap == nullptr) {
+      gMatrixPixelMap = static_cast<MatrixMapEntry *>(heap_caps_malloc(bytes, MALLOC_CAP_8BIT));
     }
-    case 'T': {
-      const uint8_t data[kScrollFontHeight] = {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    if (gMatrixPixelMap == nullptr) {
+      Serial.printf("[WARN] Matrix XY table allocation failed (cells=%u), using direct mapping.\n",
+                    static_cast<unsigned>(cells));
+      return;
     }
-    case 'U': {
-      const uint8_t data[kScrollFontHeight] = {0x11, 0x11, 0x11, 0x11, 0x11, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    gMatrixPixelMapCells = cells;
+  }
+  gMatrixPixelMapWidth = width;
+
+  const MatrixMapXYFn mapXY = gMatrixMapXY;
+  MatrixMapEntry *entry = gMatrixPixelMap;
+  for (uint8_t y = 0; y < matrixHeight(); y++) {
+    for (uint16_t x = 0; x < width; x++) {
+      uint8_t output = 0;
+      uint16_t index = 0;
+      if (mapXY(x, y, output, index) && index <= kMatrixMapIndexMask) {
+        *entry = static_cast<MatrixMapEntry>((static_cast<MatrixMapEntry>(output) << kMatrixMapIndexBits) | index);
+      } else {
+        *entry = kMatrixMapUnmapped;
+      }
+      entry++;
     }
-    case 'V': {
-      const uint8_t data[kScrollFontHeight] = {0x11, 0x11, 0x11, 0x11, 0x0A, 0x04};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  }
+}
+
+void setMatrixPixel(uint16_t x, uint8_t y, uint32_t color) {
+  if (gMatrixPixelMap == nullptr) {
+    uint8_t output = 0;
+    uint16_t index = 0;
+    if (mapMatrixXY(x, y, output, index) && gMatrixPixels[output] != nullptr) {
+      writeMatrixPixel(gMatrixPixels[output] + static_cast<size_t>(index) * kMatrixBytesPerLed, color);
     }
-    case 'W': {
-      const uint8_t data[kScrollFontHeight] = {0x11, 0x11, 0x11, 0x15, 0x1B, 0x11};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    return;
+  }
+
+  if (x >= gMatrixPixelMapWidth || y >= matrixHeight()) {
+    return;
+  }
+  const MatrixMapEntry entry = gMatrixPixelMap[static_cast<uint32_t>(y) * gMatrixPixelMapWidth + x];
+  if (entry == kMatrixMapUnmapped) {
+    return;
+  }
+  uint8_t *pixels = gMatrixPixels[entry >> kMatrixMapIndexBits];
+  if (pixels != nullptr) {
+    writeMatrixPixel(pixels + static_cast<size_t>(entry & kMatrixMapIndexMask) * kMatrixBytesPerLed, color);
+  }
+}
+
+// 8-bit sine over one period of 256 steps, centred on 128.
+static constexpr uint8_t kSin8[256] = {
+  128, 131, 134, 137, 140, 144, 147, 150, 153, 156, 159, 162, 165, 168, 171, 174,
+  177, 179, 182, 185, 188, 191, 193, 196, 199, 201, 204, 206, 209, 211, 213, 216,
+  218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 239, 240, 241, 243, 244,
+  245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+  255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+  245, 244, 243, 241, 240, 239, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+  218, 216, 213, 211, 209, 206, 204, 201, 199, 196, 193, 191, 188, 185, 182, 179,
+  177, 174, 171, 168, 165, 162, 159, 156, 153, 150, 147, 144, 140, 137, 134, 131,
+  128, 125, 122, 119, 116, 112, 109, 106, 103, 100,  97,  94,  91,  88,  85,  82,
+   79,  77,  74,  71,  68,  65,  63,  60,  57,  55,  52,  50,  47,  45,  43,  40,
+   38,  36,  34,  32,  30,  28,  26,  24,  22,  21,  19,  17,  16,  15,  13,  12,
+   11,  10,   8,   7,   6,   6,   5,   4,   3,   3,   2,   2,   2,   1,   1,   1,
+    1,   1,   1,   1,   2,   2,   2,   3,   3,   4,   5,   6,   6,   7,   8,  10,
+   11,  12,  13,  15,  16,  17,  19,  21,  22,  24,  26,  28,  30,  32,  34,  36,
+   38,  40,  43,  45,  47,  50,  52,  55,  57,  60,  63,  65,  68,  71,  74,  77,
+   79,  82,  85,  88,  91,  94,  97, 100, 103, 106, 109, 112, 116, 119, 122, 125
+
+};
+
+uint8_t effectRandom8() {
+  gMatrixEffectRng ^= gMatrixEffectRng << 13;
+  gMatrixEffectRng ^= gMatrixEffectRng >> 17;
+  gMatrixEffectRng ^= gMatrixEffectRng << 5;
+  return static_cast<uint8_t>(gMatrixEffectRng >> 24);
+}
+
+uint8_t effectHash8(uint32_t x, uint32_t y) {
+  uint32_t h = x * 0x27D4EB2DUL ^ y * 0x165667B1UL;
+  h ^= h >> 15;
+  h *= 0x85EBCA6BUL;
+  h ^= h >> 13;
+  return static_cast<uint8_t>(h >> 24);
+}
+
+uint8_t lerp8(uint8_t a, uint8_t b, uint8_t frac) {
+  return static_cast<uint8_t>(a + (((static_cast<int16_t>(b) - a) * frac) >> 8));
+}
+
+// 2D value noise on 8.8 fixed-point coordinates, smoothstep-interpolated.
+uint8_t valueNoise8(uint32_t x, uint32_t y) {
+  const uint32_t xi = x >> 8;
+  const uint32_t yi = y >> 8;
+  const uint32_t fx = x & 0xFF;
+  const uint32_t fy = y & 0xFF;
+  const uint8_t sx = static_cast<uint8_t>((fx * fx * (768 - 2 * fx)) >> 16);
+  const uint8_t sy = static_cast<uint8_t>((fy * fy * (768 - 2 * fy)) >> 16);
+  const uint8_t top = lerp8(effectHash8(xi, yi), effectHash8(xi + 1, yi), sx);
+  const uint8_t bottom = lerp8(effectHash8(xi, yi + 1), effectHash8(xi + 1, yi + 1), sx);
+  return lerp8(top, bottom, sy);
+}
+
+void fillMatrixCell(uint16_t x, uint8_t y, uint8_t cell, uint32_t color) {
+  for (uint8_t dy = 0; dy < cell && (y + dy) < matrixHeight(); dy++) {
+    for (uint8_t dx = 0; dx < cell; dx++) {
+      setMatrixPixel(static_cast<uint16_t>(x + dx), static_cast<uint8_t>(y + dy), color);
     }
-    case 'X': {
-      const uint8_t data[kScrollFontHeight] = {0x11, 0x0A, 0x04, 0x04, 0x0A, 0x11};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  }
+}
+
+void renderPlasmaEffect(uint32_t timeMs, uint8_t cell) {
+  const uint16_t width = matrixWidth();
+  for (uint16_t x = 0; x < width; x += cell) {
+    for (uint8_t y = 0; y < matrixHeight(); y += cell) {
+      const uint16_t sum = kSin8[static_cast<uint8_t>(x * 8 + (timeMs >> 3))] +
+                           kSin8[static_cast<uint8_t>(y * 16 + (timeMs >> 4))] +
+                           kSin8[static_cast<uint8_t>((x + y) * 6 + (timeMs >> 5))];
+      fillMatrixCell(x, y, cell, colorWheel(static_cast<uint8_t>(sum / 3 + (timeMs >> 6))));
     }
-    case 'Y': {
-      const uint8_t data[kScrollFontHeight] = {0x11, 0x0A, 0x04, 0x04, 0x04, 0x04};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  }
+}
+
+uint32_t fireHeatColor(uint8_t heat) {
+  const uint8_t scaled = static_cast<uint8_t>((static_cast<uint16_t>(heat) * 191) >> 8);
+  const uint8_t ramp = static_cast<uint8_t>((scaled & 0x3F) << 2);
+  if (scaled & 0x80) {
+    return packColor(255, 255, ramp);
+  }
+  if (scaled & 0x40) {
+    return packColor(255, ramp, 0);
+  }
+  return packColor(ramp, 0, 0);
+}
+
+void releaseFireEffect() {
+  if (gFireHeat != nullptr) {
+    heap_caps_free(gFireHeat);
+    gFireHeat = nullptr;
+  }
+  gFireHeatCells = 0;
+}
+
+void initFireEffect() {
+  if (gFireHeat != nullptr) {
+    memset(gFireHeat, 0, gFireHeatCells);
+  }
+  gFireLastStepMs = 0;
+}
+
+void renderFireEffect(uint32_t timeMs, uint8_t cell) {
+  const uint16_t columns = static_cast<uint16_t>((matrixWidth() + cell - 1) / cell);
+  const uint8_t rows = static_cast<uint8_t>((matrixHeight() + cell - 1) / cell);
+  const size_t cells = static_cast<size_t>(columns) * rows;
+  // Geometry and cell size both change the grid, so it is sized lazily.
+  if (cells != gFireHeatCells) {
+    releaseFireEffect();
+    gFireHeat = static_cast<uint8_t *>(heap_caps_malloc(cells, MALLOC_CAP_8BIT));
+    if (gFireHeat == nullptr) {
+      return;
     }
-    case 'Z': {
-      const uint8_t data[kScrollFontHeight] = {0x1F, 0x02, 0x04, 0x08, 0x10, 0x1F};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    memset(gFireHeat, 0, cells);
+    gFireHeatCells = cells;
+  }
+
+  // The simulation runs at ~60 Hz whatever the frame rate; heat[0] is the bottom row.
+  const bool step = (timeMs - gFireLastStepMs) >= 16;
+  if (step) {
+    gFireLastStepMs = timeMs;
+  }
+  // Short canvases (rows <= 2, e.g. 8 rows at cell 4) would pass 255.
+  const uint16_t coolingRange = static_cast<uint16_t>(550 / rows + 2);
+  const uint8_t coolingMax = static_cast<uint8_t>(coolingRange < 255 ? coolingRange : 255);
+  for (uint16_t column = 0; column < columns; column++) {
+    uint8_t *heat = gFireHeat + static_cast<size_t>(column) * rows;
+    if (step) {
+      for (uint8_t i = 0; i < rows; i++) {
+        const uint8_t cooling = effectRandom8() % coolingMax;
+        heat[i] = heat[i] > cooling ? heat[i] - cooling : 0;
+      }
+      for (uint8_t i = rows - 1; i >= 2; i--) {
+        heat[i] = static_cast<uint8_t>((heat[i - 1] + 2 * heat[i - 2]) / 3);
+      }
+      if (effectRandom8() < 120) {
+        const uint8_t i = effectRandom8() % (rows < 3 ? rows : 3);
+        const uint16_t spark = heat[i] + 160 + effectRandom8() % 96;
+        heat[i] = spark > 255 ? 255 : static_cast<uint8_t>(spark);
+      }
     }
-    case '0': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x13, 0x15, 0x19, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    for (uint8_t i = 0; i < rows; i++) {
+      fillMatrixCell(static_cast<uint16_t>(column * cell), static_cast<uint8_t>((rows - 1 - i) * cell), cell,
+                     fireHeatColor(heat[i]));
     }
-    case '1': {
-      const uint8_t data[kScrollFontHeight] = {0x04, 0x0C, 0x04, 0x04, 0x04, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  }
+}
+
+void renderNoiseEffect(uint32_t timeMs, uint8_t cell) {
+  const uint16_t width = matrixWidth();
+  for (uint16_t x = 0; x < width; x += cell) {
+    for (uint8_t y = 0; y < matrixHeight(); y += cell) {
+      const uint8_t n = valueNoise8(static_cast<uint32_t>(x) * 48 + (timeMs >> 2), static_cast<uint32_t>(y) * 48 + (timeMs >> 3));
+      fillMatrixCell(x, y, cell, colorWheel(static_cast<uint8_t>(n + (timeMs >> 6))));
     }
-    case '2': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x01, 0x06, 0x08, 0x1F};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  }
+}
+
+void renderGradientEffect(uint32_t timeMs, uint8_t cell) {
+  const uint16_t width = matrixWidth();
+  for (uint16_t x = 0; x < width; x += cell) {
+    const uint8_t hue = static_cast<uint8_t>((static_cast<uint32_t>(x) * 256) / width + (timeMs >> 4));
+    for (uint8_t y = 0; y < matrixHeight(); y += cell) {
+      fillMatrixCell(x, y, cell, colorWheel(static_cast<uint8_t>(hue + y * 4)));
     }
-    case '3': {
-      const uint8_t data[kScrollFontHeight] = {0x1E, 0x01, 0x06, 0x01, 0x11, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  }
+}
+
+void renderTwinkleEffect(uint32_t timeMs, uint8_t cell) {
+  const uint16_t width = matrixWidth();
+  for (uint16_t x = 0; x < width; x += cell) {
+    for (uint8_t y = 0; y < matrixHeight(); y += cell) {
+      // Each cell fades in and out once per ~8 s cycle, lit 1/8 of the time.
+      const uint8_t phase = effectHash8(x, y);
+      const uint16_t cycle = static_cast<uint16_t>(((timeMs >> 3) + phase * 4U) & 0x3FF);
+      uint16_t level = 0;
+      if (cycle < 64) {
+        level = cycle * 4;
+      } else if (cycle < 128) {
+        level = (127 - cycle) * 4;
+      }
+      fillMatrixCell(x, y, cell, blendColor(0, colorWheel(effectHash8(y + 0x55, x)), level));
     }
-    case '4': {
-      const uint8_t data[kScrollFontHeight] = {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  }
+}
+
+static const MatrixEffect kMatrixEffects[] = {
+  {"plasma", nullptr, renderPlasmaEffect, nullptr},
+  {"fire", initFireEffect, renderFireEffect, releaseFireEffect},
+  {"noise", nullptr, renderNoiseEffect, nullptr},
+  {"gradient", nullptr, renderGradientEffect, nullptr},
+  {"twinkle", nullptr, renderTwinkleEffect, nullptr},
+};
+static const uint8_t kMatrixEffectCount = sizeof(kMatrixEffects) / sizeof(kMatrixEffects[0]);
+
+const MatrixEffect *findMatrixEffect(const String &name) {
+  for (uint8_t i = 0; i < kMatrixEffectCount; i++) {
+    if (name.equalsIgnoreCase(kMatrixEffects[i].name)) {
+      return &kMatrixEffects[i];
     }
-    case '5': {
-      const uint8_t data[kScrollFontHeight] = {0x1F, 0x10, 0x1E, 0x01, 0x11, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  }
+  return nullptr;
+}
+
+// Persisted ids: 0 is no effect, 1.. index kMatrixEffects.
+uint8_t matrixEffectId(const MatrixEffect *effect) {
+  return effect == nullptr ? 0 : static_cast<uint8_t>(effect - kMatrixEffects + 1);
+}
+
+const MatrixEffect *matrixEffectById(uint8_t id) {
+  return (id >= 1 && id <= kMatrixEffectCount) ? &kMatrixEffects[id - 1] : nullptr;
+}
+
+void releaseMatrixEffect() {
+  if (gMatrixEffect != nullptr && gMatrixEffect->release != nullptr) {
+    gMatrixEffect->release();
+  }
+  gMatrixEffect = nullptr;
+}
+
+void startMatrixEffect(const MatrixEffect *effect) {
+  releaseMatrixEffect();
+  gMatrixScrollRunning = false;
+  gMatrixTestRunning = false;
+  gMatrixEffect = effect;
+  gMatrixEffectCell = 1;
+  gMatrixEffectDivider = 1;
+  gMatrixEffectFramePhase = 0;
+  gMatrixEffectSamples = 0;
+  gMatrixEffectRenderUs = 0;
+  if (effect->init != nullptr) {
+    effect->init();
+  }
+  Serial.printf("[OK] Matrix effect started: %s | budget=%u us\n", effect->name, gMatrixEffectBudgetUs);
+}
+
+void stopMatrixEffect() {
+  if (gMatrixEffect == nullptr) {
+    return;
+  }
+  releaseMatrixEffect();
+  applyMatrixSolidColor(gLedColor);
+  Serial.println("[OK] Matrix effect stopped.");
+}
+
+// Effects render on the Arduino core, so an effect that outgrows its budget
+// gives up resolution first and frame rate second instead of starving loop().
+void adaptMatrixEffectLoad() {
+  if (++gMatrixEffectSamples < kMatrixEffectAdaptFrames) {
+    return;
+  }
+  gMatrixEffectSamples = 0;
+
+  const uint32_t budget = gMatrixEffectBudgetUs;
+  const uint32_t load = gMatrixEffectRenderUs / gMatrixEffectDivider;
+  if (load > budget) {
+    if (gMatrixEffectCell < kMatrixEffectMaxCell) {
+      gMatrixEffectCell *= 2;
+    } else if (gMatrixEffectDivider < kMatrixEffectMaxDivider) {
+      gMatrixEffectDivider++;
+    } else {
+      return;
     }
-    case '6': {
-      const uint8_t data[kScrollFontHeight] = {0x07, 0x08, 0x1E, 0x11, 0x11, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  } else if (gMatrixEffectDivider > 1) {
+    if (gMatrixEffectRenderUs / (gMatrixEffectDivider - 1) >= budget * 3 / 4) {
+      return;
     }
-    case '7': {
-      const uint8_t data[kScrollFontHeight] = {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    gMatrixEffectDivider--;
+  } else if (gMatrixEffectCell > 1) {
+    // Halving the cell size roughly quadruples the render cost.
+    if (gMatrixEffectRenderUs * 4 >= budget * 3 / 4) {
+      return;
     }
-    case '8': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x0E, 0x11, 0x11, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    gMatrixEffectCell /= 2;
+  } else {
+    return;
+  }
+  // Cell and divider are part of the ETagged state.
+  markStateChanged();
+  Serial.printf("[INFO] Matrix effect %s load %u us | cell=%u | divider=%u\n",
+                gMatrixEffect->name,
+                static_cast<unsigned>(gMatrixEffectRenderUs),
+                static_cast<unsigned>(gMatrixEffectCell),
+                static_cast<unsigned>(gMatrixEffectDivider));
+}
+
+void tickMatrixEffect() {
+  if (!gMatrixReady || gMatrixEffect == nullptr) {
+    return;
+  }
+  if (++gMatrixEffectFramePhase < gMatrixEffectDivider) {
+    return;
+  }
+  gMatrixEffectFramePhase = 0;
+
+  const int64_t start = esp_timer_get_time();
+  gMatrixEffect->render(static_cast<uint32_t>(matrixFrameClockMs()), gMatrixEffectCell);
+  const uint32_t elapsedUs = static_cast<uint32_t>(esp_timer_get_time() - start);
+  gMatrixEffectRenderUs = (gMatrixEffectRenderUs == 0)
+                            ? elapsedUs
+                            : gMatrixEffectRenderUs - gMatrixEffectRenderUs / 8 + elapsedUs / 8;
+  showMatrix();
+  adaptMatrixEffectLoad();
+}
+
+void drawMatrixColumnMask(int16_t x, int16_t y, uint32_t mask, uint32_t color) {
+  if (x < 0 || x >= static_cast<int16_t>(matrixWidth()) || y >= matrixHeight()) {
+    return;
+  }
+  if (y < 0) {
+    mask = (-y < 32) ? (mask >> -y) : 0;
+    y = 0;
+  }
+  const uint8_t rowsLeft = static_cast<uint8_t>(matrixHeight() - y);
+  if (rowsLeft < 32) {
+    mask &= (1UL << rowsLeft) - 1;
+  }
+
+  // Only the lit rows cost anything; blank columns return immediately.
+  while (mask != 0) {
+    const uint8_t row = static_cast<uint8_t>(__builtin_ctz(mask));
+    mask &= mask - 1;
+    setMatrixPixel(static_cast<uint16_t>(x), static_cast<uint8_t>(y + row), color);
+  }
+}
+
+int16_t scrollStartOffsetX(ScrollDirection direction, const MatrixScrollLine &line) {
+  if (direction == ScrollDirection::Right) {
+    return -line.stripWidth;
+  }
+  return matrixWidth();
+}
+
+bool buildMulticolorScrollText(const String &payload, String &outText, uint32_t outColors[kScrollTextMaxLength]) {
+  outText = "";
+  memset(outColors, 0, sizeof(uint32_t) * kScrollTextMaxLength);
+
+  bool hasAny = false;
+  int start = 0;
+  while (start <= static_cast<int>(payload.length())) {
+    const int separator = payload.indexOf('|', start);
+    String item = separator < 0 ? payload.substring(start) : payload.substring(start, separator);
+    item.trim();
+
+    if (item.length() > 0) {
+      const int colon = item.indexOf(':');
+      if (colon <= 0) {
+        return false;
+      }
+
+      String colorText = item.substring(0, colon);
+      colorText.trim();
+      String segmentText = item.substring(colon + 1);
+
+      if (segmentText.length() > 0) {
+        RgbColor segmentColor = {0, 0, 0};
+        if (!parseHexColor(colorText, segmentColor)) {
+          return false;
+        }
+
+        const uint32_t packed = packColor(segmentColor.r, segmentColor.g, segmentColor.b);
+        // Whole UTF-8 sequences only; the color sits on the lead byte.
+        for (size_t i = 0; i < segmentText.length();) {
+          const uint8_t length = utf8SequenceLength(static_cast<uint8_t>(segmentText.charAt(i)));
+          if (outText.length() + length > kScrollTextMaxLength) {
+            break;
+          }
+          outColors[outText.length()] = packed;
+          for (uint8_t b = 0; b < length && i < segmentText.length(); b++, i++) {
+            outText += segmentText.charAt(i);
+          }
+        }
+
+        hasAny = outText.length() > 0;
+      }
     }
-    case '9': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x0E};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+
+    if (separator < 0) {
+      break;
     }
-    case '!': {
-      const uint8_t data[kScrollFontHeight] = {0x04, 0x04, 0x04, 0x04, 0x00, 0x04};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    start = separator + 1;
+  }
+
+  return hasAny;
+}
+
+void rasterizeMatrixScrollStrip(MatrixScrollLine &line) {
+  const size_t length = line.text.length() < kScrollTextMaxLength ? line.text.length() : kScrollTextMaxLength;
+  line.stripWidth = static_cast<int16_t>(layoutScrollStrip(line.text.c_str(), length, line.charColors,
+                                                           line.stripMasks, line.stripColors, kScrollStripMaxWidth));
+}
+
+int16_t matrixScrollOffsetX(const MatrixScrollLine &line) {
+  // Floor, so the fraction below is always in [0, 1) px.
+  return static_cast<int16_t>(line.posQ16 >= 0 ? line.posQ16 / 65536 : -((65535 - line.posQ16) / 65536));
+}
+
+void resetMatrixScrollLinePosition(MatrixScrollLine &line) {
+  line.posQ16 = static_cast<int32_t>(scrollStartOffsetX(gMatrixScrollDirection, line)) * 65536;
+  line.lastUs = matrixFrameClockUs();
+}
+
+void resetMatrixScrollPosition() {
+  for (uint8_t i = 0; i < kMatrixScrollLineCount; i++) {
+    resetMatrixScrollLinePosition(gMatrixScrollLines[i]);
+  }
+}
+
+uint16_t matrixScrollStepMs(const MatrixScrollLine &line) {
+  return static_cast<uint16_t>((1000000UL + line.speedMpps / 2) / line.speedMpps);
+}
+
+void setMatrixScrollSpeedMpps(MatrixScrollLine &line, uint32_t mpps) {
+  line.speedMpps = constrain(mpps, kScrollSpeedMinMpps, kScrollSpeedMaxMpps);
+}
+
+bool matrixScrollLineVisible(uint8_t lineIndex) {
+  if (lineIndex == 0) {
+    return true;
+  }
+  // Extra lines need a text row of their own.
+  return matrixHeight() >= (lineIndex + 1) * kScrollFontHeight && gMatrixScrollLines[lineIndex].stripWidth > 0;
+}
+
+bool scrollStripColumnVisible(int32_t column, int16_t period) {
+  // Leftward text repeats from its head onward, rightward text behind its tail.
+  return gMatrixScrollDirection == ScrollDirection::Right ? column < period : column >= 0;
+}
+
+void renderMatrixScrollLine(const MatrixScrollLine &line, int16_t yOffset, uint32_t color) {
+  const int16_t period = line.stripWidth;
+  if (period <= 0) {
+    return;
+  }
+
+  const int16_t width = static_cast<int16_t>(matrixWidth());
+  const int16_t offsetX = matrixScrollOffsetX(line);
+  // At offset X + f, display column x shows strip column x - X at weight 1 - f
+  // and its left neighbour at weight f.
+  const uint16_t weightPrev = static_cast<uint16_t>((line.posQ16 - static_cast<int32_t>(offsetX) * 65536) >> 8);
+  const uint16_t weightCur = 256 - weightPrev;
+
+  int32_t rel = -static_cast<int32_t>(offsetX);
+  int16_t column = static_cast<int16_t>(rel % period);
+  if (column < 0) {
+    column = static_cast<int16_t>(column + period);
+  }
+  for (int16_t x = 0; x < width; x++, rel++) {
+    const int16_t prev = (column == 0) ? static_cast<int16_t>(period - 1) : static_cast<int16_t>(column - 1);
+    const uint8_t maskCur = scrollStripColumnVisible(rel, period) ? line.stripMasks[column] : 0;
+    const uint8_t maskPrev =
+      (weightPrev != 0 && scrollStripColumnVisible(rel - 1, period)) ? line.stripMasks[prev] : 0;
+    if ((maskCur | maskPrev) != 0) {
+      const uint32_t colorCur = line.useCharColors ? line.stripColors[column] : color;
+      const uint32_t colorPrev = line.useCharColors ? line.stripColors[prev] : color;
+      drawMatrixColumnMask(x, yOffset, maskCur & ~maskPrev, blendColor(0, colorCur, weightCur));
+      drawMatrixColumnMask(x, yOffset, maskPrev & ~maskCur, blendColor(0, colorPrev, weightPrev));
+      drawMatrixColumnMask(x, yOffset, maskCur & maskPrev, blendColor(colorCur, colorPrev, weightPrev));
     }
-    case '?': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x02, 0x04, 0x00, 0x04};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    if (++column >= period) {
+      column = 0;
     }
-    case '.': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x04};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  }
+}
+
+void renderMatrixScrollFrame() {
+  if (!gMatrixReady || !gMatrixScrollRunning) {
+    return;
+  }
+
+  clearMatrixBuffer();
+
+  // Visible lines split the canvas into equal bands, each text row centred in
+  // its band; all of them land in the same frame.
+  uint8_t lineCount = 0;
+  while (lineCount < kMatrixScrollLineCount && matrixScrollLineVisible(lineCount)) {
+    lineCount++;
+  }
+  const int16_t band = static_cast<int16_t>(matrixHeight() / lineCount);
+  const int16_t bandOffset = band > kScrollFontHeight ? (band - kScrollFontHeight) / 2 : 0;
+  const uint32_t color = packColor(gLedColor.r, gLedColor.g, gLedColor.b);
+  for (uint8_t i = 0; i < lineCount; i++) {
+    renderMatrixScrollLine(gMatrixScrollLines[i], static_cast<int16_t>(i * band + bandOffset), color);
+  }
+
+  showMatrix();
+}
+
+bool startMatrixScrollCore(uint8_t lineIndex, String text, uint32_t speedMpps) {
+  if (!gMatrixReady || gMatrixActiveLedCount == 0 || lineIndex >= kMatrixScrollLineCount) {
+    return false;
+  }
+
+  text.replace("\r", "");
+  text.replace("\n", " ");
+  if (text.length() == 0) {
+    return false;
+  }
+
+  if (text.length() > kScrollTextMaxLength) {
+    // Cut on a UTF-8 boundary so the last character is not mangled.
+    size_t cut = kScrollTextMaxLength;
+    while (cut > 0 && (static_cast<uint8_t>(text.charAt(cut)) & 0xC0) == 0x80) {
+      cut--;
     }
-    case ':': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x04, 0x00, 0x00, 0x04, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    text.remove(cut);
+  }
+
+  releaseMatrixEffect();
+  MatrixScrollLine &line = gMatrixScrollLines[lineIndex];
+  line.text = text;
+  rasterizeMatrixScrollStrip(line);
+  setMatrixScrollSpeedMpps(line, speedMpps);
+  // Lines already on screen keep scrolling; a fresh start lines them all up.
+  if (gMatrixScrollRunning) {
+    resetMatrixScrollLinePosition(line);
+  } else {
+    resetMatrixScrollPosition();
+  }
+  gMatrixScrollRunning = true;
+  gMatrixTestRunning = false;
+  renderMatrixScrollFrame();
+  Serial.printf("[OK] Scroll text started: line=%u | \"%s\" | speed=%.2f px/s | dir=%s\n",
+                static_cast<unsigned>(lineIndex + 1),
+                line.text.c_str(),
+                line.speedMpps / 1000.0f,
+                scrollDirectionToString(gMatrixScrollDirection));
+  return true;
+}
+
+bool startMatrixScroll(uint8_t lineIndex, String text, uint32_t speedMpps) {
+  if (lineIndex >= kMatrixScrollLineCount) {
+    return false;
+  }
+  gMatrixScrollLines[lineIndex].useCharColors = false;
+  return startMatrixScrollCore(lineIndex, text, speedMpps);
+}
+
+bool startMatrixScrollSegments(uint8_t lineIndex, String payload, uint32_t speedMpps) {
+  if (lineIndex >= kMatrixScrollLineCount) {
+    return false;
+  }
+  MatrixScrollLine &line = gMatrixScrollLines[lineIndex];
+  String multicolorText;
+  if (!buildMulticolorScrollText(payload, multicolorText, line.charColors)) {
+    return false;
+  }
+  line.useCharColors = true;
+  return startMatrixScrollCore(lineIndex, multicolorText, speedMpps);
+}
+
+void stopMatrixScroll() {
+  if (!gMatrixScrollRunning) {
+    return;
+  }
+  gMatrixScrollRunning = false;
+  applyMatrixSolidColor(gLedColor);
+  Serial.println("[OK] Scroll text stopped.");
+}
+
+void clearMatrixScrollLine(uint8_t lineIndex) {
+  // Line 0 carries the ticker; only the extra lines can be emptied.
+  if (lineIndex == 0 || lineIndex >= kMatrixScrollLineCount) {
+    return;
+  }
+  MatrixScrollLine &line = gMatrixScrollLines[lineIndex];
+  line.text = "";
+  line.stripWidth = 0;
+  renderMatrixScrollFrame();
+  Serial.printf("[OK] Scroll line %u cleared.\n", static_cast<unsigned>(lineIndex + 1));
+}
+
+bool advanceMatrixScrollLine(MatrixScrollLine &line, int64_t now) {
+  int64_t elapsedUs = now - line.lastUs;
+  if (elapsedUs <= 0) {
+    return false;
+  }
+  if (elapsedUs > 1000000) {
+    elapsedUs = 1000000;  // Keeps the fixed-point product below in range.
+  }
+  line.lastUs = now;
+
+  const int16_t period = line.stripWidth;
+  if (period <= 0) {
+    return false;
+  }
+  // Whole loops are invisible, so the step is reduced modulo the period.
+  const int64_t periodQ16 = static_cast<int64_t>(period) * 65536;
+  const int32_t deltaQ16 = static_cast<int32_t>(
+    ((static_cast<int64_t>(line.speedMpps) * elapsedUs * 65536) / 1000000000LL) % periodQ16);
+  if (gMatrixScrollDirection == ScrollDirection::Right) {
+    line.posQ16 += deltaQ16;
+    if (line.posQ16 >= periodQ16) {
+      line.posQ16 -= static_cast<int32_t>(periodQ16);
     }
-    case '-': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x00, 0x1F, 0x00, 0x00, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  } else {
+    line.posQ16 -= deltaQ16;
+    if (line.posQ16 <= -periodQ16) {
+      line.posQ16 += static_cast<int32_t>(periodQ16);
     }
-    case '_': {
-      const uint8_t data[kScrollFontHeight] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x1F};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  }
+  return true;
+}
+
+void tickMatrixScroll() {
+  if (!gMatrixReady || !gMatrixScrollRunning) {
+    return;
+  }
+
+  const int64_t now = matrixFrameClockUs();
+  bool moved = false;
+  for (uint8_t i = 0; i < kMatrixScrollLineCount; i++) {
+    moved |= advanceMatrixScrollLine(gMatrixScrollLines[i], now);
+  }
+  if (moved) {
+    renderMatrixScrollFrame();
+  }
+}
+
+void startMatrixTest() {
+  if (!gMatrixReady || gMatrixActiveLedCount == 0) {
+    return;
+  }
+  releaseMatrixEffect();
+  gMatrixScrollRunning = false;
+  gMatrixTestRunning = true;
+  gMatrixTestIndex = 0;
+  gMatrixLastStepMs = 0;
+  Serial.println("[OK] Matrix test started.");
+}
+
+void tickMatrixTest() {
+  if (!gMatrixReady || !gMatrixTestRunning) {
+    return;
+  }
+
+  const unsigned long now = matrixFrameClockMs();
+  if (now - gMatrixLastStepMs < 55) {
+    return;
+  }
+  gMatrixLastStepMs = now;
+
+  clearMatrixBuffer();
+  uint8_t wheel = 0;
+  if (gMatrixActiveLedCount > 1) {
+    wheel = static_cast<uint8_t>((gMatrixTestIndex * 255) / (gMatrixActiveLedCount - 1));
+  }
+  const uint16_t x = static_cast<uint16_t>(gMatrixTestIndex % matrixWidth());
+  const uint8_t y = static_cast<uint8_t>(gMatrixTestIndex / matrixWidth());
+  setMatrixPixel(x, y, colorWheel(wheel));
+  showMatrix();
+
+  gMatrixTestIndex++;
+  if (gMatrixTestIndex >= gMatrixActiveLedCount) {
+    gMatrixTestRunning = false;
+    applyMatrixSolidColor(gLedColor);
+    Serial.println("[OK] Matrix test completed.");
+  }
+}
+
+const char *matrixStreamSourceToString(MatrixStreamSource source) {
+  switch (source) {
+    case MatrixStreamSource::E131:
+      return "e131";
+    case MatrixStreamSource::ArtNet:
+      return "artnet";
+    case MatrixStreamSource::Ddp:
+      return "ddp";
+    case MatrixStreamSource::Serial:
+      return "serial";
+    case MatrixStreamSource::WebSocket:
+      return "websocket";
+    case MatrixStreamSource::None:
+    default:
+      return "none";
+  }
+}
+
+// Called for every accepted packet. A different source can only take over
+// once the current one has timed out.
+bool claimMatrixStream(MatrixStreamSource source) {
+  const unsigned long now = millis();
+  if (gMatrixStreamSource != source) {
+    if (gMatrixStreamSource != MatrixStreamSource::None && now - gMatrixStreamLastMs < kMatrixStreamTimeoutMs) {
+      return false;
     }
-    case '/': {
-      const uint8_t data[kScrollFontHeight] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
+    gMatrixStreamSource = source;
+    gMatrixStreamReceivedMask = 0;
+    gMatrixStreamLatencyAvgUs = 0;
+    gMatrixStreamLatencyMaxUs = 0;
+    gMatrixTestRunning = false;
+    markStateChanged();
+    Serial.printf("[OK] Matrix stream started: %s\n", matrixStreamSourceToString(source));
+  }
+  gMatrixStreamLastMs = now;
+  return true;
+}
+
+void releaseMatrixStream() {
+  if (gMatrixStreamSource == MatrixStreamSource::None) {
+    return;
+  }
+  Serial.printf("[OK] Matrix stream ended: %s\n", matrixStreamSourceToString(gMatrixStreamSource));
+  gMatrixStreamSource = MatrixStreamSource::None;
+  gMatrixStreamReceivedMask = 0;
+  gMatrixStreamFramePending = false;
+  gArtNetSyncMode = false;
+  markStateChanged();
+  if (gMatrixScrollRunning) {
+    renderMatrixScrollFrame();
+  } else if (gMatrixEffect == nullptr) {
+    applyMatrixSolidColor(gLedColor);
+  }
+}
+
+void tickMatrixStream() {
+  const unsigned long now = millis();
+  const unsigned long rateWindowMs = now - gMatrixStreamRateMs;
+  if (rateWindowMs >= 1000) {
+    gE131Pps = static_cast<uint32_t>((static_cast<uint64_t>(gE131Packets - gE131RatePackets) * 1000) / rateWindowMs);
+    gArtNetPps =
+      static_cast<uint32_t>((static_cast<uint64_t>(gArtNetPackets - gArtNetRatePackets) * 1000) / rateWindowMs);
+    gDdpPps = static_cast<uint32_t>((static_cast<uint64_t>(gDdpPackets - gDdpRatePackets) * 1000) / rateWindowMs);
+    gE131RatePackets = gE131Packets;
+    gArtNetRatePackets = gArtNetPackets;
+    gSerialBps = static_cast<uint32_t>((static_cast<uint64_t>(gSerialBytes - gSerialRateBytes) * 1000) / rateWindowMs);
+    gDdpRatePackets = gDdpPackets;
+    gSerialRateBytes = gSerialBytes;
+    gMatrixStreamRateMs = now;
+  }
+  if (gArtNetSyncMode && now - gArtNetLastSyncMs >= kArtNetSyncTimeoutMs) {
+    gArtNetSyncMode = false;
+    Serial.println("[INFO] Art-Net sync lost, latching on complete frames.");
+  }
+  if (gMatrixStreamSource != MatrixStreamSource::None && now - gMatrixStreamLastMs >= kMatrixStreamTimeoutMs) {
+    releaseMatrixStream();
+  }
+}
+
+uint8_t matrixStreamUniversesForOutput(uint8_t output) {
+  if (gMatrixStreamUniversesPerOutput > 0) {
+    return gMatrixStreamUniversesPerOutput;
+  }
+  return static_cast<uint8_t>((gMatrixLedsPerOutput[output] + kMatrixStreamLedsPerUniverse - 1) /
+                              kMatrixStreamLedsPerUniverse);
+}
+
+uint8_t matrixStreamUniverseCount() {
+  uint16_t total = 0;
+  for (uint8_t output = 0; output < gMatrixActiveOutputs; output++) {
+    total += matrixStreamUniversesForOutput(output);
+  }
+  return static_cast<uint8_t>(total < kMatrixStreamMaxUniverses ? total : kMatrixStreamMaxUniverses);
+}
+
+bool matrixStreamFrameComplete() {
+  const uint8_t count = matrixStreamUniverseCount();
+  const uint64_t expected = (count >= 64) ? ~0ULL : ((1ULL << count) - 1);
+  return (gMatrixStreamReceivedMask & expected) == expected;
+}
+
+// Universe offset to the output and first LED it fills.
+bool matrixStreamUniverseTarget(uint16_t offset, uint8_t &output, uint16_t &firstLed) {
+  for (uint8_t i = 0; i < gMatrixActiveOutputs; i++) {
+    const uint8_t count = matrixStreamUniversesForOutput(i);
+    if (offset < count) {
+      output = i;
+      firstLed = static_cast<uint16_t>(offset * kMatrixStreamLedsPerUniverse);
       return true;
     }
-    case '\\': {
-      const uint8_t data[kScrollFontHeight] = {0x10, 0x08, 0x04, 0x02, 0x01, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    offset -= count;
+  }
+  return false;
+}
+
+// Stamps the back buffer with the arrival of its first stream packet.
+void markMatrixStreamArrival() {
+  if (gMatrixBackStreamUs == 0) {
+    gMatrixBackStreamUs = esp_timer_get_time();
+  }
+}
+
+// Receivers run on the UDP, WebSocket and serial paths; the frame is handed
+// to the render task, which is woken without counting a timer period. Before
+// the pipeline runs there is no render task, so it is shown right away.
+void presentMatrixStreamFrame() {
+  gMatrixStreamReceivedMask = 0;
+  gMatrixStreamFrames++;
+  if (!gMatrixPipelineRunning || gMatrixRenderTask == nullptr) {
+    showMatrix();
+    return;
+  }
+  gMatrixStreamFramePending = true;
+  xTaskNotify(gMatrixRenderTask, 0, eNoAction);
+}
+
+// Render task, under MatrixLock.
+void showPendingMatrixStreamFrame() {
+  if (gMatrixStreamFramePending) {
+    gMatrixStreamFramePending = false;
+    showMatrix();
+  }
+}
+
+// Copies one universe of RGB slots straight from the received packet into the
+// back buffer, already in wire order. A universe arriving twice means the
+// previous frame is over even if some of its universes were lost; what made
+// it is shown first.
+void writeMatrixStreamUniverse(uint8_t index, const uint8_t *slots, size_t slotCount) {
+  const uint64_t bit = 1ULL << index;
+  if ((gMatrixStreamReceivedMask & bit) != 0) {
+    presentMatrixStreamFrame();
+  }
+  gMatrixStreamReceivedMask |= bit;
+  markMatrixStreamArrival();
+
+  uint8_t output = 0;
+  uint16_t firstLed = 0;
+  if (!matrixStreamUniverseTarget(index, output, firstLed) || gMatrixPixels[output] == nullptr ||
+      firstLed >= gMatrixLedsPerOutput[output]) {
+    return;
+  }
+  size_t leds = slotCount / 3;
+  if (leds > kMatrixStreamLedsPerUniverse) {
+    leds = kMatrixStreamLedsPerUniverse;
+  }
+  if (leds > static_cast<size_t>(gMatrixLedsPerOutput[output] - firstLed)) {
+    leds = gMatrixLedsPerOutput[output] - firstLed;
+  }
+  uint8_t *pixel = gMatrixPixels[output] + static_cast<size_t>(firstLed) * kMatrixBytesPerLed;
+  for (size_t i = 0; i < leds; i++) {
+    pixel[kMatrixWireOffsetR] = slots[0];
+    pixel[kMatrixWireOffsetG] = slots[1];
+    pixel[kMatrixWireOffsetB] = slots[2];
+    pixel += kMatrixBytesPerLed;
+    slots += 3;
+  }
+}
+
+uint16_t e131ReadU16(const uint8_t *p) {
+  return static_cast<uint16_t>((static_cast<uint16_t>(p[0]) << 8) | p[1]);
+}
+
+uint32_t e131ReadU32(const uint8_t *p) {
+  return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+void resetE131Frame() {
+  gMatrixStreamReceivedMask = 0;
+  gE131SyncUniverse = 0;
+  gE131SequenceSeen = 0;
+}
+
+// Sequence rule from E1.31 6.7.2: a packet up to 19 behind the last one is
+// stale and dropped; anything else is accepted and a forward gap is counted
+// as lost packets.
+bool acceptE131Sequence(uint8_t index, uint8_t sequence) {
+  const uint64_t bit = 1ULL << index;
+  if (gE131SequenceSeen & bit) {
+    const int8_t delta = static_cast<int8_t>(sequence - gE131LastSequence[index]);
+    if (delta <= 0 && delta > -20) {
+      gE131OutOfOrder++;
+      return false;
     }
-    case '<': {
-      const uint8_t data[kScrollFontHeight] = {0x02, 0x04, 0x08, 0x04, 0x02, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    if (delta > 1) {
+      gE131Dropped += static_cast<uint32_t>(delta - 1);
     }
-    case '>': {
-      const uint8_t data[kScrollFontHeight] = {0x08, 0x04, 0x02, 0x04, 0x08, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+  }
+  gE131SequenceSeen |= bit;
+  gE131LastSequence[index] = sequence;
+  return true;
+}
+
+// Runs on the UDP task.
+void handleE131Packet(const uint8_t *data, size_t length) {
+  static const uint8_t kAcnPacketId[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+  MatrixLock lock;
+  if (!gMatrixReady || !gE131Enabled) {
+    return;
+  }
+  if (length < kE131SyncPacketLength || e131ReadU16(data) != 0x0010 ||
+      memcmp(data + 4, kAcnPacketId, sizeof(kAcnPacketId)) != 0) {
+    gE131Invalid++;
+    return;
+  }
+
+  const uint32_t rootVector = e131ReadU32(data + 18);
+  const uint32_t framingVector = e131ReadU32(data + 40);
+  if (rootVector == 0x00000008 && framingVector == 0x00000001) {
+    if (gE131SyncUniverse != 0 && e131ReadU16(data + 45) == gE131SyncUniverse && gMatrixStreamReceivedMask != 0 &&
+        gMatrixStreamSource == MatrixStreamSource::E131) {
+      presentMatrixStreamFrame();
     }
-    case '*': {
-      const uint8_t data[kScrollFontHeight] = {0x04, 0x15, 0x0E, 0x15, 0x04, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    return;
+  }
+  if (rootVector != 0x00000004 || framingVector != 0x00000002 || length <= kE131DataOffset || data[117] != 0x02) {
+    gE131Invalid++;
+    return;
+  }
+
+  const uint8_t options = data[112];
+  const uint16_t universe = e131ReadU16(data + 113);
+  // Preview data and non-zero start codes (e.g. per-address priority) are
+  // not pixels.
+  if ((options & 0x80) != 0 || data[125] != 0 || universe < gE131StartUniverse ||
+      universe - gE131StartUniverse >= matrixStreamUniverseCount()) {
+    return;
+  }
+  const uint8_t index = static_cast<uint8_t>(universe - gE131StartUniverse);
+  gE131Packets++;
+  if (!acceptE131Sequence(index, data[111])) {
+    return;
+  }
+  if ((options & 0x40) != 0) {
+    if (gMatrixStreamSource == MatrixStreamSource::E131) {
+      releaseMatrixStream();
     }
-    case '"': {
-      const uint8_t data[kScrollFontHeight] = {0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    return;
+  }
+  if (!claimMatrixStream(MatrixStreamSource::E131)) {
+    return;
+  }
+
+  size_t slots = e131ReadU16(data + 123);
+  slots = (slots > 0) ? slots - 1 : 0;
+  if (slots > length - kE131DataOffset) {
+    slots = length - kE131DataOffset;
+  }
+  writeMatrixStreamUniverse(index, data + kE131DataOffset, slots);
+  gE131SyncUniverse = e131ReadU16(data + 109);
+  if (gE131SyncUniverse == 0 && matrixStreamFrameComplete()) {
+    presentMatrixStreamFrame();
+  }
+}
+
+bool startE131Receiver() {
+  if (gE131Listening) {
+    return true;
+  }
+  gE131Udp.onPacket([](AsyncUDPPacket &packet) {
+    handleE131Packet(packet.data(), packet.length());
+  });
+  if (!gE131Udp.listen(MATRIX_E131_PORT)) {
+    Serial.printf("[FAIL] E1.31 receiver could not listen on UDP %u.\n", static_cast<unsigned>(MATRIX_E131_PORT));
+    return false;
+  }
+  gE131Listening = true;
+  resetE131Frame();
+  Serial.printf("[OK] E1.31 receiver listening | port=%u | universe=%u | universes=%u\n",
+                static_cast<unsigned>(MATRIX_E131_PORT),
+                static_cast<unsigned>(gE131StartUniverse),
+                static_cast<unsigned>(matrixStreamUniverseCount()));
+  return true;
+}
+
+void stopE131Receiver() {
+  if (!gE131Listening) {
+    return;
+  }
+  gE131Udp.close();
+  gE131Listening = false;
+  if (gMatrixStreamSource == MatrixStreamSource::E131) {
+    releaseMatrixStream();
+  }
+  Serial.println("[OK] E1.31 receiver stopped.");
+}
+
+void resetArtNetFrame() {
+  gMatrixStreamReceivedMask = 0;
+  gArtNetSequenceSeen = 0;
+}
+
+// Art-Net numbers packets 1..255 and uses 0 for "not sequenced". Same window
+// as E1.31: up to 19 behind the last packet is stale.
+bool acceptArtNetSequence(uint8_t index, uint8_t sequence) {
+  if (sequence == 0) {
+    return true;
+  }
+  const uint64_t bit = 1ULL << index;
+  if (gArtNetSequenceSeen & bit) {
+    const uint8_t last = gArtNetLastSequence[index];
+    const uint8_t delta = (sequence >= last) ? static_cast<uint8_t>(sequence - last)
+                                             : static_cast<uint8_t>(sequence + 255 - last);
+    if (delta == 0 || delta > 255 - 20) {
+      gArtNetOutOfOrder++;
+      return false;
     }
-    case '\'': {
-      const uint8_t data[kScrollFontHeight] = {0x04, 0x04, 0x00, 0x00, 0x00, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    gArtNetDropped += delta - 1;
+  }
+  gArtNetSequenceSeen |= bit;
+  gArtNetLastSequence[index] = sequence;
+  return true;
+}
+
+// A node with more than four ports answers ArtPoll with one ArtPollReply per
+// group of four (BindIndex 1, 2, ...). Groups are aligned so the ports of
+// each reply share net and sub-net. The long name and node report carry the
+// canvas size and LED count.
+void sendArtNetPollReplies(const IPAddress &to) {
+  static const uint8_t kArtNetId[8] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+  MatrixLock lock;
+  gArtNetPolls++;
+  const IPAddress ip = gApMode ? WiFi.softAPIP() : WiFi.localIP();
+  uint8_t mac[6] = {0};
+  WiFi.macAddress(mac);
+  const bool streaming = (gMatrixStreamSource == MatrixStreamSource::ArtNet);
+  const uint32_t end = static_cast<uint32_t>(gArtNetStartPort) + matrixStreamUniverseCount();
+  uint32_t port = gArtNetStartPort;
+  uint8_t bindIndex = 1;
+  do {
+    uint32_t groupEnd = (port | 0x03) + 1;
+    if (groupEnd > end) {
+      groupEnd = end;
+    }
+    if (groupEnd > kArtNetMaxPortAddress + 1UL) {
+      groupEnd = kArtNetMaxPortAddress + 1UL;
+    }
+    const uint8_t ports = static_cast<uint8_t>(groupEnd > port ? groupEnd - port : 0);
+
+    uint8_t *reply = gArtNetPollReply;
+    memset(reply, 0, kArtNetPollReplyLength);
+    memcpy(reply, kArtNetId, sizeof(kArtNetId));
+    reply[8] = static_cast<uint8_t>(kArtNetOpPollReply);
+    reply[9] = static_cast<uint8_t>(kArtNetOpPollReply >> 8);
+    for (uint8_t i = 0; i < 4; i++) {
+      reply[10 + i] = ip[i];
+      reply[207 + i] = ip[i];
+    }
+    reply[14] = static_cast<uint8_t>(kArtNetUdpPort);
+    reply[15] = static_cast<uint8_t>(kArtNetUdpPort >> 8);
+    reply[18] = static_cast<uint8_t>((port >> 8) & 0x7F);
+    reply[19] = static_cast<uint8_t>((port >> 4) & 0x0F);
+    reply[21] = 0xFF;  // OEM code: unregistered.
+    reply[23] = 0xE0;  // Indicators normal, addresses set over the network.
+    reply[24] = 0xF0;  // ESTA code 0x7FF0 (prototype range), little-endian.
+    reply[25] = 0x7F;
+    snprintf(reinterpret_cast<char *>(reply + 26), 18, "%s", DEVICE_HOSTNAME);
+    snprintf(reinterpret_cast<char *>(reply + 44),
+             64,
+             "%s WS2812 %ux%u %u LEDs",
+             DEVICE_HOSTNAME,
+             static_cast<unsigned>(matrixWidth()),
+             static_cast<unsigned>(matrixHeight()),
+             static_cast<unsigned>(gMatrixActiveLedCount));
+    snprintf(reinterpret_cast<char *>(reply + 108),
+             64,
+             "#0001 [%04u] width=%u leds=%u",
+             static_cast<unsigned>(gArtNetPolls % 10000),
+             static_cast<unsigned>(matrixWidth()),
+             static_cast<unsigned>(gMatrixActiveLedCount));
+    reply[173] = ports;
+    for (uint8_t i = 0; i < ports; i++) {
+      reply[174 + i] = 0x80;  // Output, DMX512.
+      reply[182 + i] = streaming ? 0x80 : 0x00;
+      reply[190 + i] = static_cast<uint8_t>((port + i) & 0x0F);
+      reply[213 + i] = 0xC0;  // No RDM, continuous output.
+    }
+    memcpy(reply + 201, mac, sizeof(mac));
+    reply[211] = bindIndex;
+    reply[212] = 0x0E;  // 15-bit port-addresses, DHCP.
+    gArtNetUdp.writeTo(reply, kArtNetPollReplyLength, to, kArtNetUdpPort);
+    port = groupEnd;
+    bindIndex++;
+  } while (port < end && port <= kArtNetMaxPortAddress);
+}
+
+// Runs on the UDP task.
+void handleArtNetPacket(AsyncUDPPacket &packet) {
+  static const uint8_t kArtNetId[8] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+  const uint8_t *data = packet.data();
+  const size_t length = packet.length();
+  if (length < 12 || memcmp(data, kArtNetId, sizeof(kArtNetId)) != 0) {
+    MatrixLock lock;
+    gArtNetInvalid++;
+    return;
+  }
+  const uint16_t opCode = static_cast<uint16_t>(data[8] | (static_cast<uint16_t>(data[9]) << 8));
+  if (opCode == kArtNetOpPoll) {
+    sendArtNetPollReplies(packet.remoteIP());
+    return;
+  }
+
+  MatrixLock lock;
+  if (!gMatrixReady || !gArtNetEnabled) {
+    return;
+  }
+  const uint32_t fromIp = static_cast<uint32_t>(packet.remoteIP());
+  if (opCode == kArtNetOpSync) {
+    // Only the controller feeding us may latch the frame.
+    if (gMatrixStreamSource != MatrixStreamSource::ArtNet || fromIp != gArtNetSourceIp) {
+      return;
     }
-    case '[': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x08, 0x08, 0x08, 0x0E, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    gArtNetSyncs++;
+    if (!gArtNetSyncMode) {
+      gArtNetSyncMode = true;
+      Serial.println("[INFO] Art-Net sync detected, latching on ArtSync.");
     }
-    case ']': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x02, 0x02, 0x02, 0x0E, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    gArtNetLastSyncMs = millis();
+    if (gMatrixStreamReceivedMask != 0) {
+      presentMatrixStreamFrame();
     }
-    case '@': {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x17, 0x15, 0x16, 0x0C};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    return;
+  }
+  if (opCode != kArtNetOpDmx) {
+    return;
+  }
+  if (length < kArtNetDmxHeaderLength) {
+    gArtNetInvalid++;
+    return;
+  }
+
+  const uint16_t portAddress = static_cast<uint16_t>((static_cast<uint16_t>(data[15] & 0x7F) << 8) | data[14]);
+  if (portAddress < gArtNetStartPort || portAddress - gArtNetStartPort >= matrixStreamUniverseCount()) {
+    return;
+  }
+  const uint8_t index = static_cast<uint8_t>(portAddress - gArtNetStartPort);
+  gArtNetPackets++;
+  if (!acceptArtNetSequence(index, data[12])) {
+    return;
+  }
+  if (!claimMatrixStream(MatrixStreamSource::ArtNet)) {
+    return;
+  }
+  gArtNetSourceIp = fromIp;
+
+  size_t slots = (static_cast<size_t>(data[16]) << 8) | data[17];
+  if (slots > length - kArtNetDmxHeaderLength) {
+    slots = length - kArtNetDmxHeaderLength;
+  }
+  writeMatrixStreamUniverse(index, data + kArtNetDmxHeaderLength, slots);
+  if (!gArtNetSyncMode && matrixStreamFrameComplete()) {
+    presentMatrixStreamFrame();
+  }
+}
+
+bool startArtNetReceiver() {
+  if (gArtNetListening) {
+    return true;
+  }
+  gArtNetUdp.onPacket([](AsyncUDPPacket &packet) {
+    handleArtNetPacket(packet);
+  });
+  if (!gArtNetUdp.listen(kArtNetUdpPort)) {
+    Serial.printf("[FAIL] Art-Net node could not listen on UDP %u.\n", static_cast<unsigned>(kArtNetUdpPort));
+    return false;
+  }
+  gArtNetListening = true;
+  resetArtNetFrame();
+  Serial.printf("[OK] Art-Net node listening | port=%u | port_address=%u | universes=%u\n",
+                static_cast<unsigned>(kArtNetUdpPort),
+                static_cast<unsigned>(gArtNetStartPort),
+                static_cast<unsigned>(matrixStreamUniverseCount()));
+  return true;
+}
+
+void stopArtNetReceiver() {
+  if (!gArtNetListening) {
+    return;
+  }
+  gArtNetUdp.close();
+  gArtNetListening = false;
+  gArtNetSyncMode = false;
+  if (gMatrixStreamSource == MatrixStreamSource::ArtNet) {
+    releaseMatrixStream();
+  }
+  Serial.println("[OK] Art-Net node stopped.");
+}
+
+// Pixel offsets run row by row over the canvas; the XY table turns each one
+// into its output and LED.
+void writeMatrixCanvasPixels(uint32_t firstPixel, const uint8_t *rgb, uint32_t count) {
+  if (gMatrixPixelMap == nullptr) {
+    const uint16_t width = matrixWidth();
+    for (uint32_t i = 0; i < count; i++, rgb += 3) {
+      const uint32_t pixel = firstPixel + i;
+      if (pixel / width >= matrixHeight()) {
+        return;
+      }
+      setMatrixPixel(static_cast<uint16_t>(pixel % width), static_cast<uint8_t>(pixel / width),
+                     packColor(rgb[0], rgb[1], rgb[2]));
     }
-    case '#': {
-      const uint8_t data[kScrollFontHeight] = {0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x00};
-      memcpy(rows, data, kScrollFontHeight);
-      return true;
+    return;
+  }
+
+  if (firstPixel >= gMatrixPixelMapCells) {
+    return;
+  }
+  if (count > gMatrixPixelMapCells - firstPixel) {
+    count = gMatrixPixelMapCells - firstPixel;
+  }
+  const MatrixMapEntry *entry = gMatrixPixelMap + firstPixel;
+  for (uint32_t i = 0; i < count; i++, rgb += 3) {
+    if (entry[i] == kMatrixMapUnmapped) {
+      continue;
     }
-    case ' ': {
-      return true;
+    uint8_t *pixels = gMatrixPixels[entry[i] >> kMatrixMapIndexBits];
+    if (pixels == nullptr) {
+      continue;
     }
-    default: {
-      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x02, 0x04, 0x00, 0x04};
-      memcpy(rows, data, kScrollFontHeight);
+    uint8_t *pixel = pixels + static_cast<size_t>(entry[i] & kMatrixMapIndexMask) * kMatrixBytesPerLed;
+    pixel[kMatrixWireOffsetR] = rgb[0];
+    pixel[kMatrixWireOffsetG] = rgb[1];
+    pixel[kMatrixWireOffsetB] = rgb[2];
+  }
+}
+
+// DDP sequence numbers cycle 1..15 (0 = unused). Some senders number frames
+// rather than packets, so a repeat is fine; up to three behind is stale.
+bool acceptDdpSequence(uint8_t sequence) {
+  if (sequence == 0) {
+    return true;
+  }
+  if (gDdpLastSequence != 0) {
+    const uint8_t delta = static_cast<uint8_t>((sequence + 15 - gDdpLastSequence) % 15);
+    if (delta > 11) {
+      gDdpOutOfOrder++;
       return false;
     }
+    if (delta > 1) {
+      gDdpDropped += delta - 1;
+    }
   }
+  gDdpLastSequence = sequence;
+  return true;
 }
 
-void drawGlyphAt(int16_t x, int16_t y, char c, uint32_t color) {
-  uint8_t rows[kScrollFontHeight] = {0};
-  loadGlyphRows(c, rows);
-
-  for (uint8_t row = 0; row < kScrollFontHeight; row++) {
-    const uint8_t rowBits = rows[row];
-    for (uint8_t col = 0; col < kScrollGlyphWidth; col++) {
-      if ((rowBits & (1 << (kScrollGlyphWidth - 1 - col))) == 0) {
-        continue;
-      }
-
-      const int16_t px = x + col;
-      const int16_t py = y + row;
-      if (px < 0 || py < 0 || px >= matrixWidth() || py >= MATRIX_HEIGHT) {
-        continue;
-      }
+// Status (251) and config (250) queries get the JSON replies of the DDP
+// spec, each extended with the canvas size.
+void sendDdpReply(const IPAddress &to, uint8_t id) {
+  gDdpQueries++;
+  const IPAddress ip = gApMode ? WiFi.softAPIP() : WiFi.localIP();
+  uint8_t mac[6] = {0};
+  WiFi.macAddress(mac);
+  char *json = reinterpret_cast<char *>(gDdpReply + kDdpHeaderLength);
+  const size_t jsonMax = kDdpReplyMaxLength - kDdpHeaderLength;
+  int written = 0;
+  if (id == kDdpIdStatus) {
+    written = snprintf(json,
+                       jsonMax,
+                       "{\"status\":{\"man\":\"%s\",\"mod\":\"ws2812-matrix\",\"ver\":\"1.0\","
+                       "\"mac\":\"%02x:%02x:%02x:%02x:%02x:%02x\",\"width\":%u,\"height\":%u,\"pixels\":%u}}",
+                       DEVICE_HOSTNAME,
+                       mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+                       static_cast<unsigned>(matrixWidth()),
+                       static_cast<unsigned>(matrixHeight()),
+                       static_cast<unsigned>(gMatrixActiveLedCount));
+  } else {
+    written = snprintf(json,
+                       jsonMax,
+                       "{\"config\":{\"ip\":\"%u.%u.%u.%u\",\"width\":%u,\"height\":%u,"
+                       "\"ports\":[{\"port\":0,\"ts\":0,\"l\":%u,\"ss\":0}]}}",
+                       ip[0], ip[1], ip[2], ip[3],
+                       static_cast<unsigned>(matrixWidth()),
+                       static_cast<unsigned>(matrixHeight()),
+                       static_cast<unsigned>(static_cast<uint32_t>(matrixWidth()) * matrixHeight()));
+  }
+  if (written < 0) {
+    return;
+  }
+  const size_t jsonLength = (static_cast<size_t>(written) < jsonMax) ? static_cast<size_t>(written) : jsonMax - 1;
+  memset(gDdpReply, 0, kDdpHeaderLength);
+  gDdpReply[0] = kDdpFlagVersion1 | kDdpFlagReply | kDdpFlagPush;
+  gDdpReply[3] = id;
+  gDdpReply[8] = static_cast<uint8_t>(jsonLength >> 8);
+  gDdpReply[9] = static_cast<uint8_t>(jsonLength);
+  gDdpUdp.writeTo(gDdpReply, kDdpHeaderLength + jsonLength, to, kDdpUdpPort);
+}
 
-      setMatrixPixel(static_cast<uint16_t>(px), static_cast<uint8_t>(py), color);
+// Runs on the UDP task.
+void handleDdpPacket(AsyncUDPPacket &packet) {
+  const uint8_t *data = packet.data();
+  const size_t length = packet.length();
+  MatrixLock lock;
+  if (!gMatrixReady || !gDdpEnabled) {
+    return;
+  }
+  if (length < kDdpHeaderLength || (data[0] & kDdpFlagVersionMask) != kDdpFlagVersion1) {
+    gDdpInvalid++;
+    return;
+  }
+  const uint8_t flags = data[0];
+  const uint8_t id = data[3];
+  if ((flags & kDdpFlagQuery) != 0) {
+    if (id == kDdpIdStatus || id == kDdpIdConfig) {
+      sendDdpReply(packet.remoteIP(), id);
     }
+    return;
+  }
+  if ((flags & kDdpFlagReply) != 0 || (id != kDdpIdDisplay && id != kDdpIdAll)) {
+    return;
+  }
+  // Only 8-bit RGB: undefined (0), the legacy 1 and RGB/8-bit (0x0B).
+  const uint8_t dataType = data[2];
+  const size_t header = kDdpHeaderLength + (((flags & kDdpFlagTimecode) != 0) ? kDdpTimecodeLength : 0);
+  if (length < header || (dataType != 0x00 && dataType != 0x01 && dataType != 0x0B)) {
+    gDdpInvalid++;
+    return;
+  }
+  gDdpPackets++;
+  if (!acceptDdpSequence(data[1] & 0x0F)) {
+    return;
+  }
+  if (!claimMatrixStream(MatrixStreamSource::Ddp)) {
+    return;
   }
-}
 
-int16_t scrollTextPixelWidth(const String &text) {
-  if (text.length() == 0) {
-    return 0;
+  const uint32_t offset = e131ReadU32(data + 4);
+  size_t bytes = e131ReadU16(data + 8);
+  if (bytes > length - header) {
+    bytes = length - header;
+  }
+  // Offsets are in bytes; a packet may start mid-pixel.
+  const uint32_t skip = (3 - offset % 3) % 3;
+  if (bytes > skip) {
+    markMatrixStreamArrival();
+    writeMatrixCanvasPixels((offset + skip) / 3, data + header + skip, static_cast<uint32_t>((bytes - skip) / 3));
   }
+  if ((flags & kDdpFlagPush) != 0) {
+    presentMatrixStreamFrame();
+  }
+}
 
-  return static_cast<int16_t>(text.length() * (kScrollGlyphWidth + kScrollGlyphSpacing));
+bool startDdpReceiver() {
+  if (gDdpListening) {
+    return true;
+  }
+  gDdpUdp.onPacket([](AsyncUDPPacket &packet) {
+    handleDdpPacket(packet);
+  });
+  if (!gDdpUdp.listen(kDdpUdpPort)) {
+    Serial.printf("[FAIL] DDP receiver could not listen on UDP %u.\n", static_cast<unsigned>(kDdpUdpPort));
+    return false;
+  }
+  gDdpListening = true;
+  gDdpLastSequence = 0;
+  Serial.printf("[OK] DDP receiver listening | port=%u | pixels=%u\n",
+                static_cast<unsigned>(kDdpUdpPort),
+                static_cast<unsigned>(static_cast<uint32_t>(matrixWidth()) * matrixHeight()));
+  return true;
 }
 
-int16_t scrollLoopPeriodPx(const String &text) {
-  const int16_t textWidth = scrollTextPixelWidth(text);
-  if (textWidth <= 0) {
-    return 1;
+void stopDdpReceiver() {
+  if (!gDdpListening) {
+    return;
   }
-  return textWidth;
+  gDdpUdp.close();
+  gDdpListening = false;
+  if (gMatrixStreamSource == MatrixStreamSource::Ddp) {
+    releaseMatrixStream();
+  }
+  Serial.println("[OK] DDP receiver stopped.");
 }
 
-int16_t scrollStartOffsetX(ScrollDirection direction, const String &text) {
-  if (direction == ScrollDirection::Right) {
-    return -scrollTextPixelWidth(text);
+bool serialHeartbeatEnabled() {
+  switch (gSerialLogPolicy) {
+    case SerialLogPolicy::On:
+      return true;
+    case SerialLogPolicy::Off:
+      return false;
+    case SerialLogPolicy::Auto:
+    default:
+      return gMatrixStreamSource != MatrixStreamSource::Serial;
   }
-  return matrixWidth();
 }
 
-bool buildMulticolorScrollText(const String &payload, String &outText) {
-  outText = "";
-  memset(gMatrixScrollCharColors, 0, sizeof(gMatrixScrollCharColors));
+void resetSerialFrameParser() {
+  gSerialState = SerialFrameState::Sync;
+  gSerialHeaderLength = 0;
+  gSerialCarryLength = 0;
+}
 
-  bool hasAny = false;
-  int start = 0;
-  while (start <= static_cast<int>(payload.length())) {
-    const int separator = payload.indexOf('|', start);
-    String item = separator < 0 ? payload.substring(start) : payload.substring(start, separator);
-    item.trim();
+void finishSerialFramePayload() {
+  if (gSerialTpm2) {
+    gSerialState = SerialFrameState::Tpm2End;
+    return;
+  }
+  if (gSerialFrameOwned) {
+    presentMatrixStreamFrame();
+  }
+  gSerialState = SerialFrameState::Sync;
+}
 
-    if (item.length() > 0) {
-      const int colon = item.indexOf(':');
-      if (colon <= 0) {
-        return false;
-      }
+// A payload is only drawn while the serial port owns the stream; otherwise it
+// is read and dropped.
+void beginSerialFramePayload(uint32_t bytes, bool pixels) {
+  gSerialFrameBytes = bytes;
+  gSerialPixel = 0;
+  gSerialCarryLength = 0;
+  gSerialFrameOwned = pixels && claimMatrixStream(MatrixStreamSource::Serial);
+  gSerialState = gSerialFrameOwned ? SerialFrameState::Pixels : SerialFrameState::Skip;
+  if (bytes == 0) {
+    finishSerialFramePayload();
+  }
+}
 
-      String colorText = item.substring(0, colon);
-      colorText.trim();
-      String segmentText = item.substring(colon + 1);
+void writeSerialPixels(const uint8_t *data, size_t length) {
+  markMatrixStreamArrival();
+  if (gSerialCarryLength > 0) {
+    while (gSerialCarryLength < 3 && length > 0) {
+      gSerialCarry[gSerialCarryLength++] = *data++;
+      length--;
+    }
+    if (gSerialCarryLength < 3) {
+      return;
+    }
+    writeMatrixCanvasPixels(gSerialPixel++, gSerialCarry, 1);
+    gSerialCarryLength = 0;
+  }
+  const uint32_t pixels = static_cast<uint32_t>(length / 3);
+  writeMatrixCanvasPixels(gSerialPixel, data, pixels);
+  gSerialPixel += pixels;
+  data += static_cast<size_t>(pixels) * 3;
+  length -= static_cast<size_t>(pixels) * 3;
+  memcpy(gSerialCarry, data, length);
+  gSerialCarryLength = static_cast<uint8_t>(length);
+}
 
-      if (segmentText.length() > 0) {
-        RgbColor segmentColor = {0, 0, 0};
-        if (!parseHexColor(colorText, segmentColor)) {
-          return false;
+// Adalight: "Ada", LED count - 1 (u16 big-endian), checksum hi ^ lo ^ 0x55,
+// then RGB. TPM2: 0xC9, type, size (u16 big-endian), payload, 0x36.
+void parseSerialFrameBytes(const uint8_t *data, size_t length) {
+  while (length > 0) {
+    switch (gSerialState) {
+      case SerialFrameState::Pixels:
+      case SerialFrameState::Skip: {
+        const size_t take = (length < gSerialFrameBytes) ? length : gSerialFrameBytes;
+        if (gSerialState == SerialFrameState::Pixels) {
+          writeSerialPixels(data, take);
         }
-
-        const uint32_t packed = packColor(segmentColor.r, segmentColor.g, segmentColor.b);
-        for (size_t i = 0; i < segmentText.length(); i++) {
-          if (outText.length() >= kScrollTextMaxLength) {
+        data += take;
+        length -= take;
+        gSerialFrameBytes -= take;
+        if (gSerialFrameBytes == 0) {
+          finishSerialFramePayload();
+        }
+        break;
+      }
+      case SerialFrameState::Tpm2End:
+        if (*data != kTpm2End) {
+          gSerialInvalid++;
+        } else if (gSerialFrameOwned) {
+          presentMatrixStreamFrame();
+        }
+        gSerialState = SerialFrameState::Sync;
+        data++;
+        length--;
+        break;
+      case SerialFrameState::AdalightHeader: {
+        const uint8_t b = *data;
+        // "Ada" has to match as it comes; on a mismatch this byte is looked
+        // at again as a possible start.
+        if ((gSerialHeaderLength == 1 && b != 'd') || (gSerialHeaderLength == 2 && b != 'a')) {
+          gSerialState = SerialFrameState::Sync;
+          break;
+        }
+        gSerialHeader[gSerialHeaderLength++] = b;
+        data++;
+        length--;
+        if (gSerialHeaderLength == kAdalightHeaderLength) {
+          if ((gSerialHeader[3] ^ gSerialHeader[4] ^ 0x55) != gSerialHeader[5]) {
+            gSerialInvalid++;
+            gSerialState = SerialFrameState::Sync;
             break;
           }
-          gMatrixScrollCharColors[outText.length()] = packed;
-          outText += segmentText.charAt(i);
+          gSerialTpm2 = false;
+          const uint32_t leds = ((static_cast<uint32_t>(gSerialHeader[3]) << 8) | gSerialHeader[4]) + 1;
+          beginSerialFramePayload(leds * 3, true);
         }
-
-        hasAny = outText.length() > 0;
+        break;
       }
+      case SerialFrameState::Tpm2Header:
+        gSerialHeader[gSerialHeaderLength++] = *data;
+        data++;
+        length--;
+        if (gSerialHeaderLength == kTpm2HeaderLength) {
+          const uint32_t size = (static_cast<uint32_t>(gSerialHeader[2]) << 8) | gSerialHeader[3];
+          gSerialTpm2 = true;
+          if (gSerialHeader[1] == kTpm2TypeData || gSerialHeader[1] == kTpm2TypeCommand) {
+            beginSerialFramePayload(size, gSerialHeader[1] == kTpm2TypeData);
+          } else {
+            gSerialInvalid++;
+            gSerialState = SerialFrameState::Sync;
+          }
+        }
+        break;
+      case SerialFrameState::Sync:
+      default:
+        if (*data == 'A') {
+          gSerialState = SerialFrameState::AdalightHeader;
+        } else if (*data == kTpm2Start) {
+          gSerialState = SerialFrameState::Tpm2Header;
+        }
+        gSerialHeader[0] = *data;
+        gSerialHeaderLength = 1;
+        data++;
+        length--;
+        break;
     }
+  }
+}
 
-    if (separator < 0) {
-      break;
+// Reads whatever the CDC driver has buffered, up to a chunk at a time, and
+// parses it under the matrix lock.
+void serialIngestTask(void *arg) {
+  (void)arg;
+  static uint8_t chunk[kSerialChunkBytes];
+  for (;;) {
+    if (!gSerialIngestEnabled) {
+      vTaskDelay(pdMS_TO_TICKS(50));
+      continue;
+    }
+    const int available = Serial.available();
+    if (available <= 0) {
+      if (gSerialState != SerialFrameState::Sync && millis() - gSerialLastByteMs > kSerialResyncMs) {
+        MatrixLock lock;
+        gSerialInvalid++;
+        resetSerialFrameParser();
+      }
+      vTaskDelay(1);
+      continue;
+    }
+    const size_t wanted = (static_cast<size_t>(available) < kSerialChunkBytes) ? available : kSerialChunkBytes;
+    const size_t length = Serial.read(chunk, wanted);
+    gSerialLastByteMs = millis();
+    MatrixLock lock;
+    if (!gMatrixReady || !gSerialIngestEnabled) {
+      continue;
     }
-    start = separator + 1;
+    gSerialBytes += length;
+    parseSerialFrameBytes(chunk, length);
   }
+}
 
-  return hasAny;
+bool startSerialIngest() {
+  if (gSerialIngestTask == nullptr &&
+      xTaskCreatePinnedToCore(serialIngestTask, "serial_ingest", 3072, nullptr, 1, &gSerialIngestTask,
+                              MATRIX_RENDER_CORE) != pdPASS) {
+    gSerialIngestTask = nullptr;
+    Serial.println("[FAIL] Serial frame ingest task did not start.");
+    return false;
+  }
+  resetSerialFrameParser();
+  gSerialIngestEnabled = true;
+  // Adalight hosts look for this greeting when they open the port.
+  Serial.print("Ada\n");
+  Serial.printf("[OK] Serial frame ingest enabled (Adalight/TPM2) | pixels=%u | log=%s\n",
+                static_cast<unsigned>(static_cast<uint32_t>(matrixWidth()) * matrixHeight()),
+                serialLogPolicyToString(gSerialLogPolicy));
+  return true;
 }
 
-void renderMatrixScrollFrame() {
-  if (!gMatrixReady || !gMatrixScrollRunning) {
+void stopSerialIngest() {
+  if (!gSerialIngestEnabled) {
     return;
   }
+  gSerialIngestEnabled = false;
+  resetSerialFrameParser();
+  if (gMatrixStreamSource == MatrixStreamSource::Serial) {
+    releaseMatrixStream();
+  }
+  Serial.println("[OK] Serial frame ingest disabled.");
+}
 
-  clearMatrixBuffer();
+void releaseMatrixControllers(Adafruit_NeoPixel *controllers[MATRIX_OUTPUT_COUNT]) {
+  for (uint8_t output = 0; output < MATRIX_OUTPUT_COUNT; output++) {
+    if (controllers[output] != nullptr) {
+      controllers[output]->clear();
+      controllers[output]->show();
+      delete controllers[output];
+      controllers[output] = nullptr;
+    }
+  }
+}
 
-  const int16_t yOffset = MATRIX_HEIGHT > kScrollFontHeight ? (MATRIX_HEIGHT - kScrollFontHeight) / 2 : 0;
-  const uint32_t color = packColor(gLedColor.r, gLedColor.g, gLedColor.b);
-  const int16_t textWidth = scrollTextPixelWidth(gMatrixScrollText);
-  const int16_t period = scrollLoopPeriodPx(gMatrixScrollText);
-  if (textWidth <= 0 || period <= 0) {
-    showMatrix();
-    return;
+#if MATRIX_PARALLEL_OUTPUT
+bool IRAM_ATTR onParallelTxDone(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *event, void *ctx) {
+  (void)io;
+  (void)event;
+  (void)ctx;
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(gParallelTxIdle, &woken);
+  return woken == pdTRUE;
+}
+
+void releaseParallelMatrixDriver() {
+  if (gParallelIo != nullptr && gParallelTxIdle != nullptr) {
+    // Never pull the DMA buffer from under a frame still on the wire.
+    if (xSemaphoreTake(gParallelTxIdle, pdMS_TO_TICKS(500)) == pdTRUE) {
+      xSemaphoreGive(gParallelTxIdle);
+    }
+  }
+  if (gParallelIo != nullptr) {
+    esp_lcd_panel_io_del(gParallelIo);
+    gParallelIo = nullptr;
   }
+  if (gParallelBus != nullptr) {
+    esp_lcd_del_i80_bus(gParallelBus);
+    gParallelBus = nullptr;
+  }
+  if (gParallelDmaBuffer != nullptr) {
+    heap_caps_free(gParallelDmaBuffer);
+    gParallelDmaBuffer = nullptr;
+  }
+  gParallelDmaBytes = 0;
+  gParallelDmaInPsram = false;
+  gParallelLaneLeds = 0;
+}
 
-  if (gMatrixScrollDirection == ScrollDirection::Right) {
-    for (int16_t baseX = gMatrixScrollOffsetX; baseX + textWidth >= 0; baseX -= period) {
-      for (size_t i = 0; i < gMatrixScrollText.length(); i++) {
-        const int16_t x = baseX + static_cast<int16_t>(i * (kScrollGlyphWidth + kScrollGlyphSpacing));
-        if (x > (matrixWidth() - 1) || (x + kScrollGlyphWidth) < 0) {
-          continue;
-        }
-        const uint32_t glyphColor =
-          (gMatrixScrollUseCharColors && i < kScrollTextMaxLength) ? gMatrixScrollCharColors[i] : color;
-        drawGlyphAt(x, yOffset, gMatrixScrollText.charAt(i), glyphColor);
-      }
+bool createParallelMatrixDriver(const uint8_t pins[MATRIX_OUTPUT_COUNT],
+                                uint8_t activeOutputs,
+                                const uint16_t counts[MATRIX_OUTPUT_COUNT]) {
+  if (!isValidMatrixPin(MATRIX_PARALLEL_WR_PIN) || !isValidMatrixPin(MATRIX_PARALLEL_DC_PIN)) {
+    Serial.println("[FAIL] Parallel output needs valid WR/DC pins.");
+    return false;
+  }
+  uint16_t longest = 0;
+  for (uint8_t output = 0; output < activeOutputs; output++) {
+    if (pins[output] == MATRIX_PARALLEL_WR_PIN || pins[output] == MATRIX_PARALLEL_DC_PIN) {
+      Serial.printf("[FAIL] Matrix pin %u collides with the parallel WR/DC pins.\n",
+                    static_cast<unsigned>(pins[output]));
+      return false;
     }
-  } else {
-    for (int16_t baseX = gMatrixScrollOffsetX; baseX < matrixWidth(); baseX += period) {
-      for (size_t i = 0; i < gMatrixScrollText.length(); i++) {
-        const int16_t x = baseX + static_cast<int16_t>(i * (kScrollGlyphWidth + kScrollGlyphSpacing));
-        if (x > (matrixWidth() - 1) || (x + kScrollGlyphWidth) < 0) {
-          continue;
-        }
-        const uint32_t glyphColor =
-          (gMatrixScrollUseCharColors && i < kScrollTextMaxLength) ? gMatrixScrollCharColors[i] : color;
-        drawGlyphAt(x, yOffset, gMatrixScrollText.charAt(i), glyphColor);
-      }
+    if (counts[output] > longest) {
+      longest = counts[output];
     }
   }
+  if (longest == 0) {
+    return false;
+  }
 
-  showMatrix();
-}
-
-bool startMatrixScrollCore(String text, uint16_t speedMs) {
-  if (!gMatrixReady || gMatrixActiveLedCount == 0) {
+  // Small walls keep the DMA buffer in internal RAM; big ones go to PSRAM so
+  // the encode buffer does not eat into the heap reserved for Wi-Fi.
+  // Rounded up to whole cache lines so the PSRAM write-back covers the buffer
+  // exactly; esp_cache_msync rejects lengths that are not.
+  const size_t encodedBytes = static_cast<size_t>(longest) * kParallelBytesPerLed + kParallelResetBytes;
+  const size_t dmaBytes = (encodedBytes + kParallelCacheLineBytes - 1) & ~(kParallelCacheLineBytes - 1);
+  if (dmaBytes <= kParallelInternalDmaMaxBytes) {
+    gParallelDmaBuffer = static_cast<uint8_t *>(
+      heap_caps_aligned_alloc(4, dmaBytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL));
+  }
+  if (gParallelDmaBuffer == nullptr) {
+    gParallelDmaBuffer = static_cast<uint8_t *>(heap_caps_aligned_alloc(kParallelCacheLineBytes, dmaBytes, MALLOC_CAP_SPIRAM));
+    gParallelDmaInPsram = (gParallelDmaBuffer != nullptr);
+  }
+  if (gParallelDmaBuffer == nullptr) {
+    Serial.printf("[FAIL] Parallel DMA buffer allocation failed (%u bytes)\n", static_cast<unsigned>(dmaBytes));
+    releaseParallelMatrixDriver();
     return false;
   }
+  gParallelDmaBytes = dmaBytes;
+  gParallelLaneLeds = longest;
 
-  text.replace("\r", "");
-  text.replace("\n", " ");
-  if (text.length() == 0) {
+  esp_lcd_i80_bus_config_t busConfig = {};
+  busConfig.dc_gpio_num = MATRIX_PARALLEL_DC_PIN;
+  busConfig.wr_gpio_num = MATRIX_PARALLEL_WR_PIN;
+#if ESP_IDF_VERSION_MAJOR >= 5
+  busConfig.clk_src = LCD_CLK_SRC_DEFAULT;
+#endif
+  for (uint8_t lane = 0; lane < kParallelLaneCount; lane++) {
+    // Unused lanes are parked on the D/C pin, whose own signal is routed last
+    // and wins, so they never steal a real output.
+    busConfig.data_gpio_nums[lane] = (lane < activeOutputs) ? pins[lane] : MATRIX_PARALLEL_DC_PIN;
+  }
+  busConfig.bus_width = kParallelLaneCount;
+  busConfig.max_transfer_bytes = dmaBytes;
+  busConfig.psram_trans_align = kParallelCacheLineBytes;
+  busConfig.sram_trans_align = 4;
+  esp_err_t err = esp_lcd_new_i80_bus(&busConfig, &gParallelBus);
+  if (err != ESP_OK) {
+    Serial.printf("[FAIL] Parallel i80 bus init failed: %s\n", esp_err_to_name(err));
+    gParallelBus = nullptr;
+    releaseParallelMatrixDriver();
     return false;
   }
 
-  if (text.length() > kScrollTextMaxLength) {
-    text.remove(kScrollTextMaxLength);
+  if (gParallelTxIdle == nullptr) {
+    gParallelTxIdle = xSemaphoreCreateBinary();
+    if (gParallelTxIdle == nullptr) {
+      releaseParallelMatrixDriver();
+      return false;
+    }
   }
 
-  gMatrixScrollText = text;
-  gMatrixScrollStepMs = static_cast<uint16_t>(constrain(static_cast<int>(speedMs), 40, 1000));
-  gMatrixScrollOffsetX = scrollStartOffsetX(gMatrixScrollDirection, gMatrixScrollText);
-  gMatrixScrollLastStepMs = millis();
-  gMatrixScrollRunning = true;
-  gMatrixTestRunning = false;
-  renderMatrixScrollFrame();
-  Serial.printf("[OK] Scroll text started: \"%s\" | speed=%u ms | dir=%s\n",
-                gMatrixScrollText.c_str(),
-                gMatrixScrollStepMs,
-                scrollDirectionToString(gMatrixScrollDirection));
+  esp_lcd_panel_io_i80_config_t ioConfig = {};
+  ioConfig.cs_gpio_num = -1;
+  ioConfig.pclk_hz = kParallelPixelClockHz;
+  ioConfig.trans_queue_depth = 1;
+  ioConfig.on_color_trans_done = onParallelTxDone;
+  ioConfig.user_ctx = nullptr;
+  ioConfig.lcd_cmd_bits = 0;
+  ioConfig.lcd_param_bits = 0;
+  ioConfig.dc_levels.dc_idle_level = 0;
+  ioConfig.dc_levels.dc_cmd_level = 0;
+  ioConfig.dc_levels.dc_dummy_level = 0;
+  ioConfig.dc_levels.dc_data_level = 0;
+  err = esp_lcd_new_panel_io_i80(gParallelBus, &ioConfig, &gParallelIo);
+  if (err != ESP_OK) {
+    Serial.printf("[FAIL] Parallel panel IO init failed: %s\n", esp_err_to_name(err));
+    gParallelIo = nullptr;
+    releaseParallelMatrixDriver();
+    return false;
+  }
+  // Drain a stale completion from a previous driver instance, then mark idle.
+  xSemaphoreTake(gParallelTxIdle, 0);
+  xSemaphoreGive(gParallelTxIdle);
   return true;
 }
 
-bool startMatrixScroll(String text, uint16_t speedMs) {
-  gMatrixScrollUseCharColors = false;
-  return startMatrixScrollCore(text, speedMs);
-}
+void showParallelMatrix(uint8_t *const frame[MATRIX_OUTPUT_COUNT], const uint8_t *const luts[MATRIX_OUTPUT_COUNT]) {
+  if (gParallelIo == nullptr || gParallelDmaBuffer == nullptr) {
+    return;
+  }
 
-bool startMatrixScrollSegments(String payload, uint16_t speedMs) {
-  String multicolorText;
-  if (!buildMulticolorScrollText(payload, multicolorText)) {
-    return false;
+  // Wait for the previous frame to leave the DMA buffer before re-encoding it.
+  xSemaphoreTake(gParallelTxIdle, portMAX_DELAY);
+
+  const uint8_t *lanes[kParallelLaneCount] = {nullptr};
+  const uint8_t *laneLuts[kParallelLaneCount] = {nullptr};
+  uint16_t counts[kParallelLaneCount] = {0};
+  for (uint8_t output = 0; output < gMatrixActiveOutputs && output < kParallelLaneCount; output++) {
+    lanes[output] = frame[output];
+    laneLuts[output] = luts[output];
+    counts[output] = gMatrixLedsPerOutput[output];
+  }
+  const size_t bytes = encodeParallelWs2812Frame(lanes, counts, gParallelLaneLeds, laneLuts, gParallelDmaBuffer);
+
+  if (gParallelDmaInPsram) {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    const esp_err_t err = esp_cache_msync(gParallelDmaBuffer, gParallelDmaBytes, ESP_CACHE_MSYNC_FLAG_DIR_C2M);
+    if (err != ESP_OK) {
+      // DMA would read stale PSRAM; dropping the frame beats sending garbage.
+      static bool reported = false;
+      if (!reported) {
+        Serial.printf("[FAIL] Parallel DMA cache write-back failed: %s\n", esp_err_to_name(err));
+        reported = true;
+      }
+      xSemaphoreGive(gParallelTxIdle);
+      return;
+    }
+#else
+    Cache_WriteBack_Addr(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(gParallelDmaBuffer)), gParallelDmaBytes);
+#endif
   }
-  gMatrixScrollUseCharColors = true;
-  return startMatrixScrollCore(multicolorText, speedMs);
-}
 
-void stopMatrixScroll() {
-  if (!gMatrixScrollRunning) {
-    return;
+  if (esp_lcd_panel_io_tx_color(gParallelIo, -1, gParallelDmaBuffer, bytes) != ESP_OK) {
+    xSemaphoreGive(gParallelTxIdle);
   }
-  gMatrixScrollRunning = false;
-  applyMatrixSolidColor(gLedColor);
-  Serial.println("[OK] Scroll text stopped.");
 }
+#endif
 
-void tickMatrixScroll() {
-  if (!gMatrixReady || !gMatrixScrollRunning) {
-    return;
+// Sum of every channel byte, a word at a time: each 32-bit add carries two
+// 16-bit byte-pair sums, flushed every 128 words before they can overflow.
+uint32_t sumMatrixChannels(const uint8_t *data, size_t bytes) {
+  uint32_t total = 0;
+  while (bytes > 0 && (reinterpret_cast<uintptr_t>(data) & 0x03) != 0) {
+    total += *data++;
+    bytes--;
   }
 
-  const unsigned long now = millis();
-  if ((now - gMatrixScrollLastStepMs) < gMatrixScrollStepMs) {
-    return;
+  const uint32_t *words = reinterpret_cast<const uint32_t *>(data);
+  size_t wordCount = bytes / 4;
+  while (wordCount > 0) {
+    const size_t chunk = wordCount < 128 ? wordCount : 128;
+    uint32_t pairs = 0;
+    for (size_t i = 0; i < chunk; i++) {
+      const uint32_t word = words[i];
+      pairs += (word & 0x00FF00FFUL) + ((word >> 8) & 0x00FF00FFUL);
+    }
+    total += (pairs & 0xFFFF) + (pairs >> 16);
+    words += chunk;
+    wordCount -= chunk;
   }
-  gMatrixScrollLastStepMs = now;
 
-  const int16_t period = scrollLoopPeriodPx(gMatrixScrollText);
-  if (period <= 0) {
-    return;
+  data = reinterpret_cast<const uint8_t *>(words);
+  for (size_t i = 0; i < (bytes & 0x03); i++) {
+    total += data[i];
   }
-  if (gMatrixScrollDirection == ScrollDirection::Right) {
-    gMatrixScrollOffsetX++;
-    if (gMatrixScrollOffsetX >= period) {
-      gMatrixScrollOffsetX -= period;
+  return total;
+}
+
+// Estimates the frame's draw and picks the LUT each output is encoded with,
+// scaled (in 1/256) to fit its own budget and then the global one. Gamma only
+// ever dims a channel below value * brightness / 255, so the estimate errs high.
+void limitMatrixCurrent(uint8_t *const frame[MATRIX_OUTPUT_COUNT], const uint8_t *luts[MATRIX_OUTPUT_COUNT]) {
+  const int64_t start = esp_timer_get_time();
+  uint32_t idleMa[MATRIX_OUTPUT_COUNT] = {0};
+  uint32_t channelMa[MATRIX_OUTPUT_COUNT] = {0};
+  uint16_t scale[MATRIX_OUTPUT_COUNT] = {0};
+  uint32_t estimateMa = 0;
+  for (uint8_t output = 0; output < MATRIX_OUTPUT_COUNT; output++) {
+    luts[output] = gMatrixOutputLut;
+    scale[output] = 256;
+    gMatrixOutputEstimateMa[output] = 0;
+    if (output >= gMatrixActiveOutputs || frame[output] == nullptr) {
+      continue;
     }
-  } else {
-    gMatrixScrollOffsetX--;
-    if (gMatrixScrollOffsetX <= -period) {
-      gMatrixScrollOffsetX += period;
+
+    const uint16_t leds = gMatrixLedsPerOutput[output];
+    const uint32_t sum = sumMatrixChannels(frame[output], static_cast<size_t>(leds) * kMatrixBytesPerLed);
+    idleMa[output] = static_cast<uint32_t>(leds) * MATRIX_LED_IDLE_MA;
+    channelMa[output] = static_cast<uint32_t>((static_cast<uint64_t>(sum) * gMatrixBrightness * MATRIX_LED_CHANNEL_MA) /
+                                              (255UL * 255UL));
+    gMatrixOutputEstimateMa[output] = idleMa[output] + channelMa[output];
+    estimateMa += gMatrixOutputEstimateMa[output];
+
+    const uint32_t budget = gMatrixOutputBudgetMa[output];
+    if (budget != 0 && gMatrixOutputEstimateMa[output] > budget) {
+      // Idle draw does not dim, so only the channel share is scaled.
+      scale[output] = budget > idleMa[output]
+                        ? static_cast<uint16_t>((static_cast<uint64_t>(budget - idleMa[output]) * 256) / channelMa[output])
+                        : 0;
     }
   }
 
-  renderMatrixScrollFrame();
-}
+  uint32_t idleTotal = 0;
+  uint32_t scaledChannels = 0;
+  for (uint8_t output = 0; output < gMatrixActiveOutputs; output++) {
+    idleTotal += idleMa[output];
+    scaledChannels += (channelMa[output] * scale[output]) >> 8;
+  }
+  if (gMatrixCurrentBudgetMa != 0 && idleTotal + scaledChannels > gMatrixCurrentBudgetMa) {
+    const uint32_t global = gMatrixCurrentBudgetMa > idleTotal
+                              ? static_cast<uint32_t>((static_cast<uint64_t>(gMatrixCurrentBudgetMa - idleTotal) * 256) /
+                                                      scaledChannels)
+                              : 0;
+    scaledChannels = 0;
+    for (uint8_t output = 0; output < gMatrixActiveOutputs; output++) {
+      scale[output] = static_cast<uint16_t>((scale[output] * global) >> 8);
+      scaledChannels += (channelMa[output] * scale[output]) >> 8;
+    }
+  }
 
-void startMatrixTest() {
-  if (!gMatrixReady || gMatrixActiveLedCount == 0) {
-    return;
+  uint16_t lowest = 256;
+  for (uint8_t output = 0; output < gMatrixActiveOutputs; output++) {
+    if (scale[output] >= 256) {
+      continue;
+    }
+    uint8_t *lut = gMatrixLimitedLuts[output];
+    for (uint16_t value = 0; value < 256; value++) {
+      lut[value] = static_cast<uint8_t>((gMatrixOutputLut[value] * scale[output]) >> 8);
+    }
+    luts[output] = lut;
+    if (scale[output] < lowest) {
+      lowest = scale[output];
+    }
   }
-  gMatrixScrollRunning = false;
-  gMatrixTestRunning = true;
-  gMatrixTestIndex = 0;
-  gMatrixLastStepMs = 0;
-  Serial.println("[OK] Matrix test started.");
+
+  gMatrixCurrentEstimateMa = estimateMa;
+  gMatrixCurrentLimitedMa = idleTotal + scaledChannels;
+  gMatrixCurrentScale = lowest;
+  gMatrixCurrentSumUs = static_cast<uint32_t>(esp_timer_get_time() - start);
 }
 
-void tickMatrixTest() {
-  if (!gMatrixReady || !gMatrixTestRunning) {
+void transmitMatrixFrame(uint8_t *const frame[MATRIX_OUTPUT_COUNT]) {
+  const uint8_t *luts[MATRIX_OUTPUT_COUNT] = {nullptr};
+  limitMatrixCurrent(frame, luts);
+#if MATRIX_PARALLEL_OUTPUT
+  if (gMatrixDriver == MatrixDriver::Parallel) {
+    showParallelMatrix(frame, luts);
     return;
   }
-
-  const unsigned long now = millis();
-  if (now - gMatrixLastStepMs < 55) {
-    return;
+#endif
+  for (uint8_t output = 0; output < gMatrixActiveOutputs; output++) {
+    Adafruit_NeoPixel *strip = gMatrixStrips[output];
+    if (strip == nullptr || frame[output] == nullptr) {
+      continue;
+    }
+    const uint8_t *source = frame[output];
+    const uint8_t *lut = luts[output];
+    uint8_t *wire = strip->getPixels();
+    const size_t bytes = static_cast<size_t>(gMatrixLedsPerOutput[output]) * kMatrixBytesPerLed;
+    for (size_t i = 0; i < bytes; i++) {
+      wire[i] = lut[source[i]];
+    }
+    strip->show();
   }
-  gMatrixLastStepMs = now;
+}
 
-  clearMatrixBuffer();
-  uint8_t wheel = 0;
-  if (gMatrixActiveLedCount > 1) {
-    wheel = static_cast<uint8_t>((gMatrixTestIndex * 255) / (gMatrixActiveLedCount - 1));
+uint8_t *allocateMatrixFrameBuffer(size_t bytes) {
+  uint8_t *buffer = nullptr;
+#ifdef BOARD_HAS_PSRAM
+  // Two frames per output would eat the heap Wi-Fi needs on big walls.
+  buffer = static_cast<uint8_t *>(heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+#endif
+  if (buffer == nullptr) {
+    buffer = static_cast<uint8_t *>(heap_caps_malloc(bytes, MALLOC_CAP_8BIT));
   }
-  const uint16_t x = static_cast<uint16_t>(gMatrixTestIndex % matrixWidth());
-  const uint8_t y = static_cast<uint8_t>(gMatrixTestIndex / matrixWidth());
-  setMatrixPixel(x, y, colorWheel(wheel));
-  showMatrix();
-
-  gMatrixTestIndex++;
-  if (gMatrixTestIndex >= gMatrixActiveLedCount) {
-    gMatrixTestRunning = false;
-    applyMatrixSolidColor(gLedColor);
-    Serial.println("[OK] Matrix test completed.");
+  if (buffer != nullptr) {
+    memset(buffer, 0, bytes);
   }
+  return buffer;
 }
 
-void releaseMatrixControllers(Adafruit_NeoPixel *controllers[MATRIX_OUTPUT_COUNT]) {
+void releaseMatrixFrameBuffers() {
   for (uint8_t output = 0; output < MATRIX_OUTPUT_COUNT; output++) {
-    if (controllers[output] != nullptr) {
-      controllers[output]->clear();
-      controllers[output]->show();
-      delete controllers[output];
-      controllers[output] = nullptr;
+    if (gMatrixPixels[output] != nullptr) {
+      heap_caps_free(gMatrixPixels[output]);
+      gMatrixPixels[output] = nullptr;
+    }
+    if (gMatrixFrontPixels[output] != nullptr) {
+      heap_caps_free(gMatrixFrontPixels[output]);
+      gMatrixFrontPixels[output] = nullptr;
     }
   }
 }
 
-void releaseMatrixBuffers(uint32_t *buffers[MATRIX_OUTPUT_COUNT]) {
-  for (uint8_t output = 0; output < MATRIX_OUTPUT_COUNT; output++) {
-    if (buffers[output] != nullptr) {
-      delete[] buffers[output];
-      buffers[output] = nullptr;
+bool createMatrixFrameBuffers(uint8_t activeOutputs, const uint16_t counts[MATRIX_OUTPUT_COUNT]) {
+  for (uint8_t output = 0; output < activeOutputs; output++) {
+    const size_t bytes = static_cast<size_t>(counts[output]) * kMatrixBytesPerLed;
+    gMatrixPixels[output] = allocateMatrixFrameBuffer(bytes);
+    gMatrixFrontPixels[output] = allocateMatrixFrameBuffer(bytes);
+    if (gMatrixPixels[output] == nullptr || gMatrixFrontPixels[output] == nullptr) {
+      Serial.printf("[FAIL] Matrix buffer allocation failed on output %u (count=%u)\n",
+                    static_cast<unsigned>(output),
+                    static_cast<unsigned>(counts[output]));
+      releaseMatrixFrameBuffers();
+      return false;
     }
   }
+  return true;
+}
+
+void releaseMatrixOutputs() {
+  waitMatrixTransmitIdle();
+#if MATRIX_PARALLEL_OUTPUT
+  releaseParallelMatrixDriver();
+#endif
+  releaseMatrixControllers(gMatrixStrips);
+  releaseMatrixFrameBuffers();
+  gMatrixDriver = MatrixDriver::NeoPixel;
 }
 
 bool createMatrixResources(const uint8_t pins[MATRIX_OUTPUT_COUNT],
                            uint8_t activeOutputs,
                            const uint16_t counts[MATRIX_OUTPUT_COUNT],
-                           Adafruit_NeoPixel *controllers[MATRIX_OUTPUT_COUNT],
-                           uint32_t *buffers[MATRIX_OUTPUT_COUNT]) {
+                           Adafruit_NeoPixel *controllers[MATRIX_OUTPUT_COUNT]) {
   for (uint8_t output = 0; output < MATRIX_OUTPUT_COUNT; output++) {
     controllers[output] = nullptr;
-    buffers[output] = nullptr;
   }
 
   for (uint8_t output = 0; output < activeOutputs; output++) {
@@ -1845,7 +4715,6 @@ bool createMatrixResources(const uint8_t pins[MATRIX_OUTPUT_COUNT],
                     static_cast<unsigned>(output),
                     static_cast<unsigned>(pin));
       releaseMatrixControllers(controllers);
-      releaseMatrixBuffers(buffers);
       return false;
     }
 
@@ -1853,31 +4722,25 @@ bool createMatrixResources(const uint8_t pins[MATRIX_OUTPUT_COUNT],
       Serial.printf("[FAIL] Invalid LED count on output %u\n",
                     static_cast<unsigned>(output));
       releaseMatrixControllers(controllers);
-      releaseMatrixBuffers(buffers);
-      return false;
-    }
-
-    buffers[output] = new (std::nothrow) uint32_t[ledCount];
-    if (buffers[output] == nullptr) {
-      Serial.printf("[FAIL] Matrix buffer allocation failed on output %u (count=%u)\n",
-                    static_cast<unsigned>(output),
-                    static_cast<unsigned>(ledCount));
-      releaseMatrixControllers(controllers);
-      releaseMatrixBuffers(buffers);
       return false;
     }
-    for (uint16_t i = 0; i < ledCount; i++) {
-      buffers[output][i] = 0;
-    }
 
     controllers[output] = new (std::nothrow) Adafruit_NeoPixel(
-      ledCount, pin, NEO_GRB + NEO_KHZ800);
+      ledCount, pin, kMatrixPixelType);
     if (controllers[output] == nullptr) {
       Serial.printf("[FAIL] Matrix strip allocation failed on output %u (pin=%u)\n",
                     static_cast<unsigned>(output),
                     static_cast<unsigned>(pin));
       releaseMatrixControllers(controllers);
-      releaseMatrixBuffers(buffers);
+      return false;
+    }
+    // Adafruit_NeoPixel leaves its pixel memory null (and numPixels() at 0)
+    // when its own allocation fails.
+    if (controllers[output]->getPixels() == nullptr || controllers[output]->numPixels() != ledCount) {
+      Serial.printf("[FAIL] Matrix buffer allocation failed on output %u (count=%u)\n",
+                    static_cast<unsigned>(output),
+                    static_cast<unsigned>(ledCount));
+      releaseMatrixControllers(controllers);
       return false;
     }
 
@@ -1903,32 +4766,51 @@ bool initMatrix() {
     return false;
   }
 
-  Adafruit_NeoPixel *newControllers[MATRIX_OUTPUT_COUNT] = {nullptr};
-  uint32_t *newBuffers[MATRIX_OUTPUT_COUNT] = {nullptr};
-  if (!createMatrixResources(gMatrixPins, gMatrixActiveOutputs, gMatrixLedsPerOutput, newControllers, newBuffers)) {
-    gMatrixReady = false;
+  // Both backends claim the output pins, so the old one goes first. Callers
+  // already retry initMatrix() with the previous settings on failure.
+  gMatrixReady = false;
+  releaseMatrixOutputs();
+  rebuildMatrixOutputLut();
+  if (!createMatrixFrameBuffers(gMatrixActiveOutputs, gMatrixLedsPerOutput)) {
     return false;
   }
 
-  releaseMatrixControllers(gMatrixStrips);
-  releaseMatrixBuffers(gMatrixBuffer);
-  for (uint8_t output = 0; output < MATRIX_OUTPUT_COUNT; output++) {
-    gMatrixStrips[output] = newControllers[output];
-    gMatrixBuffer[output] = newBuffers[output];
-    newControllers[output] = nullptr;
-    newBuffers[output] = nullptr;
+  bool parallelReady = false;
+#if MATRIX_PARALLEL_OUTPUT
+  parallelReady = createParallelMatrixDriver(gMatrixPins, gMatrixActiveOutputs, gMatrixLedsPerOutput);
+  if (parallelReady) {
+    gMatrixDriver = MatrixDriver::Parallel;
+  } else {
+    Serial.println("[WARN] Parallel LCD output unavailable, falling back to Adafruit_NeoPixel.");
+  }
+#endif
+
+  if (!parallelReady) {
+    Adafruit_NeoPixel *newControllers[MATRIX_OUTPUT_COUNT] = {nullptr};
+    if (!createMatrixResources(gMatrixPins, gMatrixActiveOutputs, gMatrixLedsPerOutput, newControllers)) {
+      releaseMatrixFrameBuffers();
+      return false;
+    }
+    for (uint8_t output = 0; output < MATRIX_OUTPUT_COUNT; output++) {
+      gMatrixStrips[output] = newControllers[output];
+      newControllers[output] = nullptr;
+    }
+    gMatrixDriver = MatrixDriver::NeoPixel;
   }
 
   gMatrixDataPin = gMatrixPins[0];
   gMatrixReady = true;
   clearMatrixBuffer();
   showMatrix();
-  Serial.printf("[OK] Parallel WS2812 matrix ready | outputs=%u/%u | pins=[%s] | counts=[%s] | width=%u | leds=%u | brightness=%u\n",
+  Serial.printf("[OK] Parallel WS2812 matrix ready | driver=%s | outputs=%u/%u | pins=[%s] | counts=[%s] | heights=[%s] | width=%u | height=%u | leds=%u | brightness=%u\n",
+                matrixDriverToString(gMatrixDriver),
                 static_cast<unsigned>(gMatrixActiveOutputs),
                 static_cast<unsigned>(MATRIX_OUTPUT_COUNT),
                 matrixPinsCsv().c_str(),
                 matrixCountsCsv().c_str(),
+                matrixHeightsCsv().c_str(),
                 static_cast<unsigned>(matrixWidth()),
+                static_cast<unsigned>(matrixHeight()),
                 static_cast<unsigned>(gMatrixActiveLedCount),
                 gMatrixBrightness);
   return true;
@@ -1974,25 +4856,24 @@ bool applyMatrixPins(const uint8_t newPins[MATRIX_OUTPUT_COUNT]) {
 
   if (wasScrollRunning) {
     gMatrixScrollRunning = true;
-    gMatrixScrollOffsetX = scrollStartOffsetX(gMatrixScrollDirection, gMatrixScrollText);
-    gMatrixScrollLastStepMs = millis();
+    resetMatrixScrollPosition();
     renderMatrixScrollFrame();
-  } else {
+  } else if (gMatrixEffect == nullptr) {
     applyMatrixSolidColor(gLedColor);
   }
   Serial.printf("[OK] Matrix pins updated to [%s]\n", matrixPinsCsv().c_str());
   return true;
 }
 
-bool applyMatrixCounts(const uint16_t newCounts[MATRIX_OUTPUT_COUNT]) {
+bool applyMatrixCounts(const uint16_t newCounts[MATRIX_OUTPUT_COUNT], const uint8_t newHeights[MATRIX_OUTPUT_COUNT]) {
   String errorCode;
-  if (!matrixCountsAreValid(newCounts, gMatrixActiveOutputs, errorCode)) {
+  if (!matrixCountsAreValid(newCounts, newHeights, gMatrixActiveOutputs, errorCode)) {
     return false;
   }
 
   bool changed = false;
   for (uint8_t i = 0; i < gMatrixActiveOutputs; i++) {
-    if (gMatrixLedsPerOutput[i] != newCounts[i]) {
+    if (gMatrixLedsPerOutput[i] != newCounts[i] || gMatrixHeights[i] != newHeights[i]) {
       changed = true;
       break;
     }
@@ -2002,9 +4883,12 @@ bool applyMatrixCounts(const uint16_t newCounts[MATRIX_OUTPUT_COUNT]) {
   }
 
   uint16_t previousCounts[MATRIX_OUTPUT_COUNT] = {0};
+  uint8_t previousHeights[MATRIX_OUTPUT_COUNT] = {0};
   for (uint8_t i = 0; i < gMatrixActiveOutputs; i++) {
     previousCounts[i] = gMatrixLedsPerOutput[i];
+    previousHeights[i] = gMatrixHeights[i];
     gMatrixLedsPerOutput[i] = newCounts[i];
+    gMatrixHeights[i] = newHeights[i];
   }
 
   const bool wasScrollRunning = gMatrixScrollRunning;
@@ -2014,6 +4898,7 @@ bool applyMatrixCounts(const uint16_t newCounts[MATRIX_OUTPUT_COUNT]) {
   if (!initMatrix()) {
     for (uint8_t i = 0; i < gMatrixActiveOutputs; i++) {
       gMatrixLedsPerOutput[i] = previousCounts[i];
+      gMatrixHeights[i] = previousHeights[i];
     }
     if (!initMatrix()) {
       gMatrixReady = false;
@@ -2023,13 +4908,59 @@ bool applyMatrixCounts(const uint16_t newCounts[MATRIX_OUTPUT_COUNT]) {
 
   if (wasScrollRunning) {
     gMatrixScrollRunning = true;
-    gMatrixScrollOffsetX = scrollStartOffsetX(gMatrixScrollDirection, gMatrixScrollText);
-    gMatrixScrollLastStepMs = millis();
+    resetMatrixScrollPosition();
     renderMatrixScrollFrame();
-  } else {
+  } else if (gMatrixEffect == nullptr) {
+    applyMatrixSolidColor(gLedColor);
+  }
+  Serial.printf("[OK] Matrix LED counts updated to [%s] | heights=[%s]\n",
+                matrixCountsCsv().c_str(),
+                matrixHeightsCsv().c_str());
+  return true;
+}
+
+bool applyMatrixLayout(const String &spec, String &errorCode) {
+  MatrixPanel nextPanels[kMatrixLayoutMaxPanels];
+  uint8_t nextCount = 0;
+  const bool clearing = (spec == "none" || spec == "0");
+  if (!clearing && !parseMatrixLayout(spec, gMatrixLedsPerOutput, nextPanels, nextCount, errorCode)) {
+    return false;
+  }
+
+  // Buffers are sized by counts, so a new layout only recompiles the XY table.
+  // The geometry reads the live panel list, so the old one is kept aside and
+  // put back if the new layout does not build.
+  MatrixPanel previousPanels[kMatrixLayoutMaxPanels];
+  const uint8_t previousCount = gMatrixPanelCount;
+  for (uint8_t i = 0; i < previousCount; i++) {
+    previousPanels[i] = gMatrixPanels[i];
+  }
+  for (uint8_t i = 0; i < nextCount; i++) {
+    gMatrixPanels[i] = nextPanels[i];
+  }
+  gMatrixPanelCount = nextCount;
+  if (!rebuildMatrixGeometry(gMatrixLedsPerOutput, gMatrixActiveOutputs, errorCode)) {
+    for (uint8_t i = 0; i < previousCount; i++) {
+      gMatrixPanels[i] = previousPanels[i];
+    }
+    gMatrixPanelCount = previousCount;
+    String restoreError;
+    rebuildMatrixGeometry(gMatrixLedsPerOutput, gMatrixActiveOutputs, restoreError);
+    return false;
+  }
+  gMatrixLayoutSpec = clearing ? String("") : spec;
+
+  if (gMatrixScrollRunning) {
+    resetMatrixScrollPosition();
+    renderMatrixScrollFrame();
+  } else if (gMatrixEffect == nullptr) {
     applyMatrixSolidColor(gLedColor);
   }
-  Serial.printf("[OK] Matrix LED counts updated to [%s]\n", matrixCountsCsv().c_str());
+  Serial.printf("[OK] Matrix layout %s | panels=%u | canvas=%ux%u\n",
+                clearing ? "cleared" : "applied",
+                static_cast<unsigned>(gMatrixPanelCount),
+                static_cast<unsigned>(matrixWidth()),
+                static_cast<unsigned>(matrixHeight()));
   return true;
 }
 
@@ -2043,7 +4974,7 @@ bool applyMatrixActiveOutputs(uint8_t newActiveOutputs, String &errorCode) {
     errorCode = "duplicate_pins_for_active_outputs";
     return false;
   }
-  if (!matrixCountsAreValid(gMatrixLedsPerOutput, newActiveOutputs, errorCode)) {
+  if (!matrixCountsAreValid(gMatrixLedsPerOutput, gMatrixHeights, newActiveOutputs, errorCode)) {
     return false;
   }
 
@@ -2065,18 +4996,175 @@ bool applyMatrixActiveOutputs(uint8_t newActiveOutputs, String &errorCode) {
     return false;
   }
 
-  if (wasScrollRunning) {
-    gMatrixScrollRunning = true;
-    gMatrixScrollOffsetX = scrollStartOffsetX(gMatrixScrollDirection, gMatrixScrollText);
-    gMatrixScrollLastStepMs = millis();
-    renderMatrixScrollFrame();
-  } else {
-    applyMatrixSolidColor(gLedColor);
+  if (wasScrollRunning) {
+    gMatrixScrollRunning = true;
+    resetMatrixScrollPosition();
+    renderMatrixScrollFrame();
+  } else if (gMatrixEffect == nullptr) {
+    applyMatrixSolidColor(gLedColor);
+  }
+
+  Serial.printf("[OK] Active outputs updated to %u/%u\n",
+                static_cast<unsigned>(gMatrixActiveOutputs),
+                static_cast<unsigned>(MATRIX_OUTPUT_COUNT));
+  return true;
+}
+
+void matrixTransmitTask(void *arg) {
+  (void)arg;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    int64_t streamUs = 0;
+    {
+      // Only the hand-off runs under the lock, never the wire time.
+      MatrixLock lock;
+      if (gMatrixFramePending) {
+        swapMatrixFrontBuffer();
+      }
+      if (gMatrixCurvePending) {
+        rebuildMatrixOutputLut();
+        gMatrixCurvePending = false;
+      }
+      streamUs = gMatrixFrontStreamUs;
+      gMatrixFrontStreamUs = 0;
+      // Taken before the lock drops so a resize cannot free the front buffer
+      // while it is being sent.
+      xSemaphoreTake(gMatrixFrontFree, portMAX_DELAY);
+    }
+    transmitMatrixFrame(gMatrixFrontPixels);
+    xSemaphoreGive(gMatrixFrontFree);
+    if (streamUs != 0) {
+      // The next frame waits for the wire anyway, so this costs no throughput.
+      waitMatrixWireIdle();
+      recordMatrixStreamLatency(streamUs);
+    }
+  }
+}
+
+int64_t matrixFramePeriodUs() {
+  return 1000000LL / gMatrixTargetFps;
+}
+
+void resetMatrixFrameStats() {
+  gMatrixFrameCount = 0;
+  gMatrixFrameMissed = 0;
+  gMatrixFrameLateMaxUs = 0;
+  memset(gMatrixFrameLateHist, 0, sizeof(gMatrixFrameLateHist));
+}
+
+void recordMatrixFrameLateness(int64_t lateUs, uint32_t missed) {
+  const uint32_t late = lateUs > 0 ? static_cast<uint32_t>(lateUs) : 0;
+  uint8_t bucket = 0;
+  while (bucket < kFrameLateBucketCount - 1 && late >= kFrameLateBucketUs[bucket]) {
+    bucket++;
+  }
+  gMatrixFrameLateHist[bucket]++;
+  gMatrixFrameCount++;
+  gMatrixFrameMissed += missed;
+  if (late > gMatrixFrameLateMaxUs) {
+    gMatrixFrameLateMaxUs = late;
+  }
+}
+
+void onMatrixFrameTimer(void *arg) {
+  (void)arg;
+  xTaskNotifyGive(gMatrixRenderTask);
+}
+
+void matrixRenderTask(void *arg) {
+  (void)arg;
+  for (;;) {
+    // One notification per timer period; more than one means frames were missed.
+    const uint32_t due = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (due == 0) {
+      // Woken by a stream receiver with a finished frame.
+      MatrixLock lock;
+      showPendingMatrixStreamFrame();
+      continue;
+    }
+
+    MatrixLock lock;
+    const int64_t periodUs = matrixFramePeriodUs();
+    gMatrixFrameDeadlineUs += periodUs * due;
+    // Measured after taking the lock so stalls behind web handlers count too.
+    recordMatrixFrameLateness(esp_timer_get_time() - gMatrixFrameDeadlineUs, due - 1);
+    gMatrixFrameClockUs += periodUs * (gMatrixFramePolicy == FramePolicy::CatchUp ? due : 1);
+    if (gMatrixStreamSource == MatrixStreamSource::None) {
+      tickMatrixScroll();
+      tickMatrixEffect();
+      tickMatrixTest();
+    }
+    showPendingMatrixStreamFrame();
+    tickMatrixStream();
+  }
+}
+
+bool restartMatrixFrameTimer() {
+  if (gMatrixFrameTimer == nullptr) {
+    return true;
+  }
+  esp_timer_stop(gMatrixFrameTimer);
+  resetMatrixFrameStats();
+  gMatrixFrameDeadlineUs = esp_timer_get_time();
+  return esp_timer_start_periodic(gMatrixFrameTimer, static_cast<uint64_t>(matrixFramePeriodUs())) == ESP_OK;
+}
+
+bool setMatrixTargetFps(uint16_t fps) {
+  gMatrixTargetFps = fps;
+  return restartMatrixFrameTimer();
+}
+
+bool startMatrixPipeline() {
+  if (gMatrixPipelineRunning) {
+    return true;
+  }
+
+  gMatrixFrontFree = xSemaphoreCreateBinary();
+  if (gMatrixFrontFree == nullptr) {
+    Serial.println("[FAIL] Matrix pipeline semaphore allocation failed.");
+    return false;
+  }
+  xSemaphoreGive(gMatrixFrontFree);
+
+  if (xTaskCreatePinnedToCore(matrixTransmitTask, "matrix_tx", 4096, nullptr, 3, &gMatrixTransmitTask,
+                              MATRIX_TRANSMIT_CORE) != pdPASS) {
+    Serial.println("[FAIL] Matrix transmit task did not start.");
+    return false;
+  }
+  {
+    MatrixLock lock;
+    gMatrixFrameClockUs = esp_timer_get_time();
+    gMatrixPipelineRunning = true;
+  }
+  // Above loop() priority so HTTP handling can no longer stall the animation.
+  if (xTaskCreatePinnedToCore(matrixRenderTask, "matrix_render", 4096, nullptr, 2, &gMatrixRenderTask,
+                              MATRIX_RENDER_CORE) != pdPASS) {
+    Serial.println("[FAIL] Matrix render task did not start.");
+    return false;
   }
 
-  Serial.printf("[OK] Active outputs updated to %u/%u\n",
-                static_cast<unsigned>(gMatrixActiveOutputs),
-                static_cast<unsigned>(MATRIX_OUTPUT_COUNT));
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = onMatrixFrameTimer;
+  timerArgs.dispatch_method = ESP_TIMER_TASK;
+  timerArgs.name = "matrix_frame";
+  if (esp_timer_create(&timerArgs, &gMatrixFrameTimer) != ESP_OK) {
+    gMatrixFrameTimer = nullptr;
+    Serial.println("[FAIL] Matrix frame timer allocation failed.");
+    return false;
+  }
+  {
+    MatrixLock lock;
+    if (!restartMatrixFrameTimer()) {
+      Serial.println("[FAIL] Matrix frame timer did not start.");
+      return false;
+    }
+  }
+
+  Serial.printf("[OK] Matrix pipeline running | render core=%d | transmit core=%d | fps=%u | policy=%s\n",
+                MATRIX_RENDER_CORE,
+                MATRIX_TRANSMIT_CORE,
+                static_cast<unsigned>(gMatrixTargetFps),
+                framePolicyToString(gMatrixFramePolicy));
   return true;
 }
 
@@ -2189,46 +5277,667 @@ bool startMdns() {
   return true;
 }
 
-String buildStateJson() {
-  String json = "{";
-  json += "\"r\":" + String(gLedColor.r) + ",";
-  json += "\"g\":" + String(gLedColor.g) + ",";
-  json += "\"b\":" + String(gLedColor.b) + ",";
-  json += "\"hex\":\"" + ledHexColor() + "\",";
-  json += "\"wifi\":" + String(static_cast<int>(WiFi.status())) + ",";
-  json += "\"ip\":\"" + WiFi.localIP().toString() + "\",";
-  json += "\"sta_connected\":" + String(WiFi.isConnected() ? 1 : 0) + ",";
-  json += "\"wifi_ssid\":\"" + jsonEscape(WiFi.SSID()) + "\",";
-  json += "\"hostname\":\"" + String(DEVICE_HOSTNAME) + "\",";
-  json += "\"safe_mode\":" + String(gSafeMode ? 1 : 0) + ",";
-  json += "\"safe_reason\":\"" + jsonEscape(gSafeModeReason) + "\",";
-  json += "\"boot_attempts\":" + String(gBootGuardAttempts) + ",";
-  json += "\"ap_mode\":" + String(gApMode ? 1 : 0) + ",";
-  json += "\"ap_ssid\":\"" + jsonEscape(gApSsid) + "\",";
-  json += "\"ap_ip\":\"" + WiFi.softAPIP().toString() + "\",";
-  json += "\"matrix_pin\":" + String(gMatrixDataPin) + ",";
-  json += "\"matrix_outputs\":" + String(static_cast<unsigned>(MATRIX_OUTPUT_COUNT)) + ",";
-  json += "\"matrix_active_outputs\":" + String(static_cast<unsigned>(gMatrixActiveOutputs)) + ",";
-  json += "\"matrix_pins\":\"" + matrixPinsCsv() + "\",";
-  json += "\"matrix_counts\":\"" + matrixCountsCsv() + "\",";
-  json += "\"matrix_scan\":\"" + String(matrixScanOrderToString(gMatrixScanOrder)) + "\",";
-  json += "\"matrix_x_flip\":" + String(gMatrixXFlip ? 1 : 0) + ",";
-  json += "\"matrix_y_flip\":" + String(gMatrixYFlip ? 1 : 0) + ",";
-  json += "\"matrix_width\":" + String(matrixWidth()) + ",";
-  json += "\"matrix_count\":" + String(gMatrixActiveLedCount) + ",";
-  json += "\"matrix_max_count\":" + String(gMatrixRuntimeMaxLedCount) + ",";
-  json += "\"matrix_brightness\":" + String(gMatrixBrightness) + ",";
-  json += "\"matrix_test\":" + String(gMatrixTestRunning ? 1 : 0) + ",";
-  json += "\"matrix_scroll\":" + String(gMatrixScrollRunning ? 1 : 0) + ",";
-  json += "\"matrix_scroll_speed\":" + String(gMatrixScrollStepMs) + ",";
-  json += "\"matrix_scroll_multicolor\":" + String(gMatrixScrollUseCharColors ? 1 : 0) + ",";
-  json += "\"matrix_scroll_direction\":\"" + String(scrollDirectionToString(gMatrixScrollDirection)) + "\",";
-  json += "\"matrix_scroll_text\":\"" + jsonEscape(gMatrixScrollText) + "\"";
-  json += "}";
-  return json;
-}
-
-void handleRoot() {
+const char *wifiStateToString(WifiState state) {
+  switch (state) {
+    case WifiState::Connecting:
+      return "connecting";
+    case WifiState::Connected:
+      return "connected";
+    case WifiState::Waiting:
+      return "waiting";
+    case WifiState::Idle:
+    default:
+      return "idle";
+  }
+}
+
+const char *wifiJobStatusToString(WifiJobStatus status) {
+  switch (status) {
+    case WifiJobStatus::Pending:
+      return "pending";
+    case WifiJobStatus::Connected:
+      return "connected";
+    case WifiJobStatus::Failed:
+      return "failed";
+    case WifiJobStatus::None:
+    default:
+      return "none";
+  }
+}
+
+const char *wifiJoinModeToString(WifiJoinMode mode) {
+  switch (mode) {
+    case WifiJoinMode::Bssid:
+      return "bssid";
+    case WifiJoinMode::Lease:
+      return "lease";
+    case WifiJoinMode::Scan:
+    default:
+      return "scan";
+  }
+}
+
+// Runs on the Wi-Fi event task.
+void handleWifiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+  if (event == ARDUINO_EVENT_WIFI_STA_CONNECTED) {
+    memcpy(gWifiEventBssid, info.wifi_sta_connected.bssid, sizeof(gWifiEventBssid));
+    gWifiEventChannel = info.wifi_sta_connected.channel;
+    gWifiAssocAtMs = millis();
+  } else if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+    gWifiGotIpAtMs = millis();
+    gWifiGotIp = true;
+  } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+    gWifiDisconnectReason = info.wifi_sta_disconnected.reason;
+    gWifiLinkLost = true;
+  }
+  markStateChanged();
+}
+
+WifiJoinMode fastestWifiJoinMode(const WifiNetwork &net) {
+  if (net.channel == 0) {
+    return WifiJoinMode::Scan;
+  }
+  return (WIFI_REUSE_LEASE != 0 && net.ip != 0) ? WifiJoinMode::Lease : WifiJoinMode::Bssid;
+}
+
+void beginWifiJoin(WifiJoinMode mode) {
+  const WifiNetwork &net = gWifiCurrent;
+  gWifiJoinMode = mode;
+  gWifiAttempts++;
+  Serial.printf("Connecting to Wi-Fi: %s (%s)\n", net.ssid.c_str(), wifiJoinModeToString(mode));
+  WiFi.mode(gApMode ? WIFI_AP_STA : WIFI_STA);
+  WiFi.setAutoReconnect(false);
+  WiFi.persistent(false);
+  if (mode == WifiJoinMode::Lease) {
+    WiFi.config(IPAddress(net.ip), IPAddress(net.gateway), IPAddress(net.subnet), IPAddress(net.dns));
+  } else {
+    WiFi.config(IPAddress(), IPAddress(), IPAddress());
+  }
+  gWifiGotIp = false;
+  gWifiLinkLost = false;
+  gWifiAssocAtMs = 0;
+  gWifiState = WifiState::Connecting;
+  gWifiStateMs = millis();
+  if (mode == WifiJoinMode::Scan) {
+    WiFi.begin(net.ssid.c_str(), net.password.c_str());
+  } else {
+    WiFi.begin(net.ssid.c_str(), net.password.c_str(), net.channel, net.bssid);
+  }
+}
+
+void startWifiCandidate(uint8_t index) {
+  gWifiCandidate = static_cast<int8_t>(index);
+  gWifiCurrent = gWifiNetworks[index];
+  beginWifiJoin(fastestWifiJoinMode(gWifiCurrent));
+}
+
+// Stored networks, or the one from wifi_secrets.h when none are.
+void beginConfiguredWifi() {
+  WiFi.onEvent(handleWifiEvent);
+  loadWifiNetworks();
+  if (gWifiNetworkCount == 0 && strlen(WIFI_SSID) > 0) {
+    gWifiNetworks[0] = WifiNetwork();
+    gWifiNetworks[0].ssid = WIFI_SSID;
+    gWifiNetworks[0].password = WIFI_PASSWORD;
+    gWifiNetworkCount = 1;
+  }
+  if (gWifiNetworkCount == 0) {
+    Serial.println("[INFO] Wi-Fi not configured (no saved credentials and empty WIFI_SSID).");
+    startConfigAp();
+    return;
+  }
+  rankWifiNetworks();
+  startWifiCandidate(0);
+}
+
+// A stale cache falls back to a scan of the same network, then the next
+// network is tried; once all have failed the config AP comes up and the
+// round starts over after gWifiRetryMs.
+void failWifiJoin(const char *why) {
+  Serial.printf("[FAIL] Wi-Fi did not connect (%s, %s, reason=%u)\n",
+                why,
+                wifiJoinModeToString(gWifiJoinMode),
+                static_cast<unsigned>(gWifiDisconnectReason));
+  WiFi.disconnect();
+  if (gWifiJobStatus == WifiJobStatus::Pending) {
+    gWifiJobStatus = WifiJobStatus::Failed;
+    if (gWifiNetworkCount > 0) {
+      rankWifiNetworks();
+      startWifiCandidate(0);
+    } else {
+      gWifiState = WifiState::Idle;
+    }
+    return;
+  }
+  if (gWifiJoinMode != WifiJoinMode::Scan) {
+    gWifiCurrent.channel = 0;
+    gWifiCurrent.ip = 0;
+    beginWifiJoin(WifiJoinMode::Scan);
+    return;
+  }
+  const uint8_t next = (gWifiCandidate < 0) ? 0 : static_cast<uint8_t>(gWifiCandidate + 1);
+  if (next < gWifiNetworkCount) {
+    startWifiCandidate(next);
+    return;
+  }
+  startConfigAp();
+  gWifiState = WifiState::Waiting;
+  gWifiStateMs = millis();
+}
+
+void finishWifiJoin() {
+  gWifiState = WifiState::Connected;
+  // A disconnect reported before the address belongs to the join, not to
+  // the link that just came up.
+  gWifiLinkLost = false;
+  gWifiRetryMs = kWifiRetryMinMs;
+  const unsigned long gotIpAt = gWifiGotIpAtMs;
+  const unsigned long assocAt = (gWifiAssocAtMs != 0) ? gWifiAssocAtMs : gotIpAt;
+  gWifiAssocMs = assocAt - gWifiStateMs;
+  gWifiDhcpMs = gotIpAt - assocAt;
+  gWifiConnectMs = gotIpAt - gWifiStateMs;
+  if (gWifiOnlineAtMs == 0) {
+    gWifiOnlineAtMs = gotIpAt;
+  }
+  Serial.println("[OK] Wi-Fi connected.");
+  Serial.printf("SSID: %s\n", WiFi.SSID().c_str());
+  Serial.printf("IP: %s\n", WiFi.localIP().toString().c_str());
+  Serial.printf("RSSI: %d dBm\n", WiFi.RSSI());
+  Serial.printf("Join: %s | assoc=%u ms | dhcp=%u ms | total=%u ms | since boot=%lu ms\n",
+                wifiJoinModeToString(gWifiJoinMode),
+                static_cast<unsigned>(gWifiAssocMs),
+                static_cast<unsigned>(gWifiDhcpMs),
+                static_cast<unsigned>(gWifiConnectMs),
+                gotIpAt);
+
+  memcpy(gWifiCurrent.bssid, gWifiEventBssid, sizeof(gWifiCurrent.bssid));
+  gWifiCurrent.channel = gWifiEventChannel;
+  gWifiCurrent.rssi = static_cast<int8_t>(WiFi.RSSI());
+  if (gWifiJoinMode != WifiJoinMode::Lease) {
+    gWifiCurrent.ip = static_cast<uint32_t>(WiFi.localIP());
+    gWifiCurrent.gateway = static_cast<uint32_t>(WiFi.gatewayIP());
+    gWifiCurrent.subnet = static_cast<uint32_t>(WiFi.subnetMask());
+    gWifiCurrent.dns = static_cast<uint32_t>(WiFi.dnsIP());
+  }
+  const bool job = (gWifiJobStatus == WifiJobStatus::Pending);
+  if (job) {
+    gWifiJobStatus = WifiJobStatus::Connected;
+  }
+  if (!job || gWifiJobSave) {
+    storeWifiNetwork(gWifiCurrent);
+  }
+
+  if (!gMdnsStarted) {
+    gMdnsStarted = startMdns();
+  }
+  stopConfigAp();
+  Serial.printf("Open: http://%s.local or http://%s\n", DEVICE_HOSTNAME, WiFi.localIP().toString().c_str());
+}
+
+void tickWifi() {
+  const unsigned long now = millis();
+  const WifiState before = gWifiState;
+  const uint32_t attempts = gWifiAttempts;
+  switch (gWifiState) {
+    case WifiState::Connecting: {
+      const unsigned long timeoutMs =
+        (gWifiJoinMode == WifiJoinMode::Scan) ? kWifiJoinTimeoutMs : kWifiFastJoinTimeoutMs;
+      if (gWifiGotIp) {
+        finishWifiJoin();
+      } else if (gWifiLinkLost && gWifiDisconnectReason != WIFI_REASON_ASSOC_LEAVE) {
+        failWifiJoin("rejected");
+      } else if (gWifiLinkLost) {
+        // Our own disconnect from the previous network reports ASSOC_LEAVE;
+        // left set, it would read as a lost link once connected.
+        gWifiLinkLost = false;
+      } else if (now - gWifiStateMs >= timeoutMs) {
+        failWifiJoin("timeout");
+      }
+      break;
+    }
+    case WifiState::Connected:
+      if (gWifiLinkLost) {
+        Serial.printf("[WARN] Wi-Fi link lost (reason=%u), reconnecting.\n",
+                      static_cast<unsigned>(gWifiDisconnectReason));
+        gWifiCandidate = -1;
+        gWifiState = WifiState::Waiting;
+        gWifiStateMs = now;
+        gWifiRetryMs = kWifiRetryMinMs;
+      }
+      break;
+    case WifiState::Waiting:
+      if (now - gWifiStateMs >= gWifiRetryMs) {
+        gWifiRetryMs = (gWifiRetryMs * 2 < kWifiRetryMaxMs) ? gWifiRetryMs * 2 : kWifiRetryMaxMs;
+        if (gWifiCandidate < 0 && gWifiCurrent.ssid.length() > 0) {
+          beginWifiJoin(fastestWifiJoinMode(gWifiCurrent));
+        } else if (gWifiNetworkCount > 0) {
+          rankWifiNetworks();
+          startWifiCandidate(0);
+        } else {
+          gWifiState = WifiState::Idle;
+        }
+      }
+      break;
+    case WifiState::Idle:
+    default:
+      break;
+  }
+  if (gWifiState != before || gWifiAttempts != attempts) {
+    markStateChanged();
+  }
+}
+
+// Fields and order match what the UI and tools have always read; counters
+// and rates are marked live so they keep the document out of the ETag.
+void writeStateJson(JsonWriter &json) {
+  char hex[8];
+  snprintf(hex, sizeof(hex), "#%02X%02X%02X", gLedColor.r, gLedColor.g, gLedColor.b);
+  json.beginObject();
+  json.addNumber("r", gLedColor.r);
+  json.addNumber("g", gLedColor.g);
+  json.addNumber("b", gLedColor.b);
+  json.addString("hex", hex);
+  json.addSigned("wifi", static_cast<int32_t>(WiFi.status()));
+  json.addIp("ip", WiFi.localIP());
+  json.addFlag("sta_connected", WiFi.isConnected());
+  json.addString("wifi_ssid", WiFi.isConnected() ? gWifiCurrent.ssid.c_str() : "");
+  json.addString("wifi_state", wifiStateToString(gWifiState));
+  json.addNumber("wifi_attempts", gWifiAttempts);
+  json.addNumber("wifi_reason", gWifiDisconnectReason);
+  json.addNumber("wifi_job", gWifiJobId);
+  json.addString("wifi_job_status", wifiJobStatusToString(gWifiJobStatus));
+  json.addString("wifi_join_mode", wifiJoinModeToString(gWifiJoinMode));
+  json.addNumber("wifi_assoc_ms", gWifiAssocMs);
+  json.addNumber("wifi_dhcp_ms", gWifiDhcpMs);
+  json.addNumber("wifi_connect_ms", gWifiConnectMs);
+  json.addNumber("wifi_online_ms", gWifiOnlineAtMs);
+  json.addNumber("http_first_ms", gHttpFirstAtMs);
+  if (json.key("wifi_networks")) {
+    json.beginArray();
+    for (uint8_t i = 0; i < gWifiNetworkCount; i++) {
+      const WifiNetwork &net = gWifiNetworks[i];
+      json.beginObject();
+      json.addString("ssid", net.ssid.c_str());
+      json.addSigned("rssi", net.rssi);
+      json.addNumber("channel", net.channel);
+      if (json.key("lease")) {
+        if (net.ip != 0) {
+          json.ip(IPAddress(net.ip));
+        } else {
+          json.string("");
+        }
+      }
+      json.endObject();
+    }
+    json.endArray();
+  }
+  json.addString("hostname", DEVICE_HOSTNAME);
+  json.addFlag("safe_mode", gSafeMode);
+  json.addString("safe_reason", gSafeModeReason.c_str());
+  json.addNumber("boot_attempts", gBootGuardAttempts);
+  json.addFlag("ap_mode", gApMode);
+  json.addString("ap_ssid", gApSsid.c_str());
+  json.addIp("ap_ip", WiFi.softAPIP());
+  json.addSigned("matrix_pin", gMatrixDataPin);
+  json.addNumber("matrix_outputs", MATRIX_OUTPUT_COUNT);
+  json.addString("matrix_driver", matrixDriverToString(gMatrixDriver));
+  json.addNumber("matrix_active_outputs", gMatrixActiveOutputs);
+  json.addCsv("matrix_pins", gMatrixPins, gMatrixActiveOutputs);
+  json.addCsv("matrix_counts", gMatrixLedsPerOutput, gMatrixActiveOutputs);
+  json.addString("matrix_scan", matrixScanOrderToString(gMatrixScanOrder));
+  json.addFlag("matrix_x_flip", gMatrixXFlip);
+  json.addFlag("matrix_y_flip", gMatrixYFlip);
+  json.addNumber("matrix_width", matrixWidth());
+  json.addNumber("matrix_height", matrixHeight());
+  json.addCsv("matrix_heights", gMatrixHeights, gMatrixActiveOutputs);
+  json.addString("matrix_layout", gMatrixLayoutSpec.c_str());
+  json.addNumber("matrix_panels", gMatrixPanelCount);
+  json.addNumber("matrix_count", gMatrixActiveLedCount);
+  json.addNumber("matrix_max_count", gMatrixRuntimeMaxLedCount);
+  json.addNumber("matrix_brightness", gMatrixBrightness);
+  json.addFixed("matrix_gamma", gMatrixGamma, 2);
+  json.addNumber("matrix_current_limit_ma", gMatrixCurrentBudgetMa);
+  json.addCsv("matrix_output_current_limit_ma", gMatrixOutputBudgetMa, gMatrixActiveOutputs);
+  json.addNumber("matrix_current_ma", gMatrixCurrentEstimateMa, true);
+  json.addNumber("matrix_current_limited_ma", gMatrixCurrentLimitedMa, true);
+  json.addCsv("matrix_output_current_ma", gMatrixOutputEstimateMa, gMatrixActiveOutputs, true);
+  json.addFixed("matrix_current_scale", gMatrixCurrentScale / 256.0f, 3, true);
+  json.addNumber("matrix_current_sum_us", gMatrixCurrentSumUs, true);
+  json.addString("stream_source", matrixStreamSourceToString(gMatrixStreamSource));
+  json.addNumber("stream_universes_per_output", gMatrixStreamUniversesPerOutput);
+  json.addNumber("stream_universes", matrixStreamUniverseCount());
+  json.addNumber("stream_frames", gMatrixStreamFrames, true);
+  json.addNumber("stream_latency_us", gMatrixStreamLatencyUs, true);
+  json.addNumber("stream_latency_avg_us", gMatrixStreamLatencyAvgUs, true);
+  json.addNumber("stream_latency_max_us", gMatrixStreamLatencyMaxUs, true);
+  json.addFlag("e131_enabled", gE131Enabled);
+  json.addFlag("e131_listening", gE131Listening);
+  json.addNumber("e131_universe", gE131StartUniverse);
+  json.addNumber("e131_pps", gE131Pps, true);
+  json.addNumber("e131_packets", gE131Packets, true);
+  json.addNumber("e131_dropped", gE131Dropped, true);
+  json.addNumber("e131_out_of_order", gE131OutOfOrder, true);
+  json.addNumber("e131_invalid", gE131Invalid, true);
+  json.addFlag("artnet_enabled", gArtNetEnabled);
+  json.addFlag("artnet_listening", gArtNetListening);
+  json.addNumber("artnet_universe", gArtNetStartPort);
+  json.addFlag("artnet_sync", gArtNetSyncMode, true);
+  json.addNumber("artnet_pps", gArtNetPps, true);
+  json.addNumber("artnet_packets", gArtNetPackets, true);
+  json.addNumber("artnet_syncs", gArtNetSyncs, true);
+  json.addNumber("artnet_polls", gArtNetPolls, true);
+  json.addNumber("artnet_dropped", gArtNetDropped, true);
+  json.addNumber("artnet_out_of_order", gArtNetOutOfOrder, true);
+  json.addNumber("artnet_invalid", gArtNetInvalid, true);
+  json.addFlag("ddp_enabled", gDdpEnabled);
+  json.addFlag("ddp_listening", gDdpListening);
+  json.addNumber("ddp_pps", gDdpPps, true);
+  json.addNumber("ddp_packets", gDdpPackets, true);
+  json.addNumber("ddp_queries", gDdpQueries, true);
+  json.addNumber("ddp_dropped", gDdpDropped, true);
+  json.addNumber("ddp_out_of_order", gDdpOutOfOrder, true);
+  json.addNumber("ddp_invalid", gDdpInvalid, true);
+  json.addFlag("serial_enabled", gSerialIngestEnabled);
+  json.addString("serial_log", serialLogPolicyToString(gSerialLogPolicy));
+  json.addNumber("serial_bytes", gSerialBytes, true);
+  json.addNumber("serial_bps", gSerialBps, true);
+  json.addNumber("serial_invalid", gSerialInvalid, true);
+  json.addNumber("websocket_clients", gWebSocket.count(), true);
+  json.addNumber("websocket_messages", gWebSocketMessages, true);
+  json.addNumber("websocket_invalid", gWebSocketInvalid, true);
+  json.addNumber("events_clients", gEvents.count(), true);
+  json.addNumber("events_pushes", gStateEventPushes, true);
+  json.addFlag("matrix_test", gMatrixTestRunning, true);
+  json.addFlag("matrix_scroll", gMatrixScrollRunning);
+  json.addNumber("matrix_scroll_speed", matrixScrollStepMs(gMatrixScrollLines[0]));
+  json.addFixed("matrix_scroll_pps", gMatrixScrollLines[0].speedMpps / 1000.0f, 2);
+  json.addFlag("matrix_scroll_multicolor", gMatrixScrollLines[0].useCharColors);
+  json.addString("matrix_scroll_direction", scrollDirectionToString(gMatrixScrollDirection));
+  json.addString("matrix_scroll_text", gMatrixScrollLines[0].text.c_str());
+  json.addString("matrix_scroll_text2", gMatrixScrollLines[1].text.c_str());
+  json.addFixed("matrix_scroll_pps2", gMatrixScrollLines[1].speedMpps / 1000.0f, 2);
+  json.addFlag("matrix_scroll_line2_visible", matrixScrollLineVisible(1));
+  json.addString("matrix_effect", gMatrixEffect != nullptr ? gMatrixEffect->name : "none");
+  if (json.key("matrix_effects")) {
+    json.csvNames(kMatrixEffects, kMatrixEffectCount);
+  }
+  json.addNumber("matrix_effect_budget_us", gMatrixEffectBudgetUs);
+  json.addNumber("matrix_effect_render_us", gMatrixEffectRenderUs, true);
+  json.addNumber("matrix_effect_cell", gMatrixEffectCell);
+  json.addNumber("matrix_effect_divider", gMatrixEffectDivider);
+  json.addNumber("frame_fps", gMatrixTargetFps);
+  json.addString("frame_policy", framePolicyToString(gMatrixFramePolicy));
+  json.addNumber("frame_count", gMatrixFrameCount, true);
+  json.addNumber("frame_missed", gMatrixFrameMissed, true);
+  json.addNumber("frame_late_max_us", gMatrixFrameLateMaxUs, true);
+  if (json.key("frame_late_bounds_us")) {
+    json.beginArray();
+    for (uint8_t i = 0; i < kFrameLateBucketCount - 1; i++) {
+      json.number(kFrameLateBucketUs[i]);
+    }
+    json.endArray();
+  }
+  if (json.key("frame_late_hist", true)) {
+    json.beginArray();
+    for (uint8_t i = 0; i < kFrameLateBucketCount; i++) {
+      json.number(gMatrixFrameLateHist[i]);
+    }
+    json.endArray();
+  }
+  json.addNumber("state_version", gStateVersion.load());
+  json.addNumber("state_json_bytes", gStateJsonBytes, true);
+  json.addNumber("state_json_us", gStateJsonUs, true);
+  json.addNumber("state_not_modified", gStateJsonNotModified, true);
+  json.endObject();
+}
+
+void markStateChanged() {
+  gStateVersion.fetch_add(1);
+}
+
+int8_t acquireStateJsonSlot() {
+  for (uint8_t i = 0; i < kStateJsonSlots; i++) {
+    StateJsonSlot &slot = gStateJsonSlots[i];
+    if (slot.owner != 0) {
+      continue;
+    }
+    if (slot.data == nullptr) {
+      slot.data = static_cast<char *>(heap_caps_malloc(kStateJsonMaxBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+      if (slot.data == nullptr) {
+        slot.data = static_cast<char *>(malloc(kStateJsonMaxBytes));
+      }
+      if (slot.data == nullptr) {
+        return -1;
+      }
+    }
+    gStateJsonOwnerCounter = (gStateJsonOwnerCounter == UINT32_MAX) ? 1 : gStateJsonOwnerCounter + 1;
+    slot.owner = gStateJsonOwnerCounter;
+    slot.length = 0;
+    return static_cast<int8_t>(i);
+  }
+  return -1;
+}
+
+void releaseStateJsonSlot(uint8_t index, uint32_t owner) {
+  MatrixLock lock;
+  if (gStateJsonSlots[index].owner == owner) {
+    gStateJsonSlots[index].owner = 0;
+  }
+}
+
+// Renders into a slot; false when the selection does not fit.
+bool renderStateJson(StateJsonSlot &slot, const char *fields, bool &live) {
+  const int64_t start = esp_timer_get_time();
+  JsonWriter json(slot.data, kStateJsonMaxBytes, fields);
+  writeStateJson(json);
+  slot.length = json.length;
+  live = json.live;
+  gStateJsonUs = static_cast<uint32_t>(esp_timer_get_time() - start);
+  gStateJsonBytes = json.length;
+  return !json.overflow;
+}
+
+uint32_t stateFieldsHash(const char *fields) {
+  uint32_t hash = 2166136261u;
+  for (; fields != nullptr && *fields != '\0'; fields++) {
+    hash = (hash ^ static_cast<uint8_t>(*fields)) * 16777619u;
+  }
+  return hash;
+}
+
+// Sends the state (or the fields= part of it) straight from a slot. The
+// ETag is the state version plus the selection, so If-None-Match on an
+// unchanged document answers 304 without rendering it.
+void sendStateJson(AsyncWebServerRequest *request) {
+  const bool filtered = request->hasArg("fields");
+  const String &fieldsArg = request->arg("fields");
+  const char *fields = filtered ? fieldsArg.c_str() : nullptr;
+  MatrixLock lock;
+  char etag[24];
+  snprintf(etag, sizeof(etag), "\"%lx-%lx\"", static_cast<unsigned long>(gStateVersion.load()),
+           static_cast<unsigned long>(stateFieldsHash(fields)));
+  if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == etag) {
+    gStateJsonNotModified++;
+    AsyncWebServerResponse *response = request->beginResponse(304);
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+    return;
+  }
+
+  const int8_t index = acquireStateJsonSlot();
+  if (index < 0) {
+    request->send(503, "application/json", "{\"error\":\"busy\"}");
+    return;
+  }
+  StateJsonSlot &slot = gStateJsonSlots[index];
+  const uint32_t owner = slot.owner;
+  bool live = false;
+  if (!renderStateJson(slot, fields, live)) {
+    slot.owner = 0;
+    request->send(500, "application/json", "{\"error\":\"state_too_large\"}");
+    return;
+  }
+
+  AsyncWebServerResponse *response = request->beginResponse(
+      "application/json", slot.length, [index, owner](uint8_t *buffer, size_t maxLen, size_t offset) -> size_t {
+        MatrixLock lock;
+        StateJsonSlot &sending = gStateJsonSlots[index];
+        if (sending.owner != owner || offset >= sending.length) {
+          return 0;
+        }
+        const size_t remaining = sending.length - offset;
+        const size_t count = (remaining < maxLen) ? remaining : maxLen;
+        memcpy(buffer, sending.data + offset, count);
+        if (offset + count >= sending.length) {
+          sending.owner = 0;
+        }
+        return count;
+      });
+  if (!live) {
+    response->addHeader("ETag", etag);
+  }
+  response->addHeader("Cache-Control", "no-cache");
+  request->onDisconnect([index, owner]() { releaseStateJsonSlot(index, owner); });
+  request->send(response);
+}
+
+void sendStateJson(AsyncWebSocketClient *client) {
+  MatrixLock lock;
+  const int8_t index = acquireStateJsonSlot();
+  if (index < 0) {
+    return;
+  }
+  StateJsonSlot &slot = gStateJsonSlots[index];
+  bool live = false;
+  if (renderStateJson(slot, nullptr, live)) {
+    client->text(slot.data, slot.length);
+  }
+  slot.owner = 0;
+}
+
+// End of the top-level "key":value pair that starts at pos in a document
+// from JsonWriter: the ',' or '}' after it.
+size_t stateJsonPairEnd(const char *doc, size_t length, size_t pos) {
+  uint8_t depth = 0;
+  bool quoted = false;
+  for (; pos < length; pos++) {
+    const char c = doc[pos];
+    if (quoted) {
+      if (c == '\\') {
+        pos++;
+      } else if (c == '"') {
+        quoted = false;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == '[' || c == '{') {
+      depth++;
+    } else if (c == ']' || c == '}') {
+      if (depth == 0) {
+        return pos;
+      }
+      depth--;
+    } else if (c == ',' && depth == 0) {
+      return pos;
+    }
+  }
+  return pos;
+}
+
+// Writes an object with the pairs of next that differ from prev; both come
+// from the same field list, so their pairs line up one to one. Returns the
+// delta length (2 for "{}"), or 0 when it does not fit.
+size_t buildStateDelta(const char *prev,
+                       size_t prevLength,
+                       const char *next,
+                       size_t nextLength,
+                       char *delta,
+                       size_t capacity) {
+  size_t out = 0;
+  delta[out++] = '{';
+  size_t p = 1;
+  size_t n = 1;
+  while (n < nextLength && next[n] != '}') {
+    const size_t nextEnd = stateJsonPairEnd(next, nextLength, n);
+    size_t prevEnd = p;
+    bool same = false;
+    if (p < prevLength && prev[p] != '}') {
+      prevEnd = stateJsonPairEnd(prev, prevLength, p);
+      same = (prevEnd - p == nextEnd - n) && memcmp(prev + p, next + n, nextEnd - n) == 0;
+    }
+    if (!same) {
+      const size_t pairLength = nextEnd - n;
+      if (out + pairLength + 3 > capacity) {
+        return 0;
+      }
+      if (out > 1) {
+        delta[out++] = ',';
+      }
+      memcpy(delta + out, next + n, pairLength);
+      out += pairLength;
+    }
+    n = nextEnd + 1;
+    p = prevEnd + 1;
+  }
+  delta[out++] = '}';
+  delta[out] = '\0';
+  return out;
+}
+
+// Runs on the AsyncTCP task: a new client starts from all event fields.
+void handleStateEventsConnect(AsyncEventSourceClient *client) {
+  MatrixLock lock;
+  const int8_t index = acquireStateJsonSlot();
+  if (index < 0) {
+    return;
+  }
+  StateJsonSlot &slot = gStateJsonSlots[index];
+  const uint32_t version = gStateVersion.load();
+  bool live = false;
+  if (renderStateJson(slot, kStateEventFields, live)) {
+    client->send(slot.data, "state", version);
+  }
+  slot.owner = 0;
+}
+
+// Called from loop(). Nothing is rendered while the state is unchanged or
+// nobody listens; changes closer together than 1/STATE_EVENTS_PER_SECOND
+// go out merged in the next push.
+void tickStateEvents() {
+  const unsigned long now = millis();
+  if (gStateEventVersion == gStateVersion.load() || now - gStateEventMs < 1000UL / STATE_EVENTS_PER_SECOND ||
+      gEvents.count() == 0) {
+    return;
+  }
+  MatrixLock lock;
+  const int8_t index = acquireStateJsonSlot();
+  if (index < 0) {
+    return;
+  }
+  StateJsonSlot &slot = gStateJsonSlots[index];
+  const uint32_t version = gStateVersion.load();
+  bool live = false;
+  if (renderStateJson(slot, kStateEventFields, live) && slot.length < kStateEventMaxBytes) {
+    const size_t deltaLength = buildStateDelta(gStateEventLast,
+                                               gStateEventLastLength,
+                                               slot.data,
+                                               slot.length,
+                                               gStateEventDelta,
+                                               sizeof(gStateEventDelta));
+    if (deltaLength != 2) {
+      gEvents.send(deltaLength > 0 ? gStateEventDelta : slot.data, "state", version);
+      gStateEventPushes++;
+    }
+    memcpy(gStateEventLast, slot.data, slot.length + 1);
+    gStateEventLastLength = slot.length;
+  }
+  slot.owner = 0;
+  gStateEventVersion = version;
+  gStateEventMs = now;
+}
+
+void handleRoot(AsyncWebServerRequest *request) {
   static const char kHtml[] PROGMEM = R"HTML(
 <!doctype html>
 <html lang="en">
@@ -2426,6 +6135,32 @@ void handleRoot() {
     let brightTimer = null;
     let scrollTimer = null;
     let uiInitialized = false;
+    let socket = null;
+    let wifiJob = 0;
+
+    // Slider drags go over the WebSocket as binary controls; the HTTP API is
+    // the fallback while it is not connected.
+    function openSocket() {
+      socket = new WebSocket(`ws://${location.host}/ws`);
+      socket.binaryType = 'arraybuffer';
+      socket.onclose = () => {
+        socket = null;
+        setTimeout(openSocket, 2000);
+      };
+    }
+
+    function sendControl(bytes) {
+      if (!socket || socket.readyState !== WebSocket.OPEN) {
+        return false;
+      }
+      socket.send(new Uint8Array(bytes));
+      return true;
+    }
+
+    function sendColorControl(hex) {
+      const v = parseInt(hex.slice(1), 16);
+      return sendControl([0x10, (v >> 16) & 255, (v >> 8) & 255, v & 255]);
+    }
 
     function toggleScrollMode() {
       segmentsPanel.style.display = matrixScrollMode.value === 'multi' ? 'block' : 'none';
@@ -2464,9 +6199,23 @@ void handleRoot() {
       return parts.join('|');
     }
 
+    // Only what the page shows (the same list /api/events pushes); with no
+    // counters in it the reply carries an ETag and can come back as 304.
+    const stateFields = 'hex,wifi,wifi_ssid,wifi_state,wifi_job*,ip,hostname,safe_*,boot_attempts,ap_*,' +
+      'matrix_pin,matrix_pins,matrix_outputs,matrix_active_outputs,matrix_scan,matrix_x_flip,matrix_y_flip,' +
+      'matrix_counts,matrix_count,matrix_max_count,matrix_width,matrix_brightness,matrix_scroll,' +
+      'matrix_scroll_text,matrix_scroll_multicolor,matrix_scroll_speed,matrix_scroll_direction';
+
+    let state = {};
+
     async function fetchState() {
-      const res = await fetch('/api/state');
-      const st = await res.json();
+      const res = await fetch('/api/state?fields=' + stateFields);
+      applyState(await res.json());
+    }
+
+    // Pushes from /api/events only carry the keys that changed.
+    function applyState(delta) {
+      const st = Object.assign(state, delta);
       picker.value = st.hex;
       dot.style.background = st.hex;
       brightness.value = st.matrix_brightness;
@@ -2500,11 +6249,17 @@ void handleRoot() {
       matrixScrollDirection.value = st.matrix_scroll_direction || 'left';
       recoverRow.style.display = st.safe_mode ? 'flex' : 'none';
       wifiSsid.value = st.wifi_ssid || '';
+      if (wifiJob && st.wifi_job === wifiJob && st.wifi_job_status !== 'pending') {
+        if (st.wifi_job_status === 'failed') {
+          alert('Wi-Fi connection failed');
+        }
+        wifiJob = 0;
+      }
       const safePrefix = st.safe_mode
         ? `SAFE MODE (${st.safe_reason || 'unstable boot'}, attempts=${st.boot_attempts}) | `
         : '';
       statusEl.textContent =
-        safePrefix + `STA IP: ${st.ip} | Wi-Fi: ${st.wifi} | AP: ${st.ap_mode ? (st.ap_ssid + ' @ ' + st.ap_ip) : 'off'} | DNS: http://${st.hostname}.local | Color: ${st.hex} | Matrix: ${st.matrix_count}/${st.matrix_max_count} LEDs, width=${st.matrix_width}, outputs=${st.matrix_active_outputs || 1}/${st.matrix_outputs || 1} [pins=${st.matrix_pins || st.matrix_pin}] [counts=${st.matrix_counts || '-'}] (${st.matrix_scan || 'column'} map, flipX=${st.matrix_x_flip ? 1 : 0}, flipY=${st.matrix_y_flip ? 1 : 0}) | Brightness: ${st.matrix_brightness} | Scroll: ${st.matrix_scroll ? ('on "' + (st.matrix_scroll_text || '') + '" @ ' + st.matrix_scroll_speed + ' ms / ' + (st.matrix_scroll_direction || 'left') + (st.matrix_scroll_multicolor ? ' / multicolor' : ' / single')) : 'off'}`;
+        safePrefix + `STA IP: ${st.ip} | Wi-Fi: ${st.wifi_state || st.wifi} | AP: ${st.ap_mode ? (st.ap_ssid + ' @ ' + st.ap_ip) : 'off'} | DNS: http://${st.hostname}.local | Color: ${st.hex} | Matrix: ${st.matrix_count}/${st.matrix_max_count} LEDs, width=${st.matrix_width}, outputs=${st.matrix_active_outputs || 1}/${st.matrix_outputs || 1} [pins=${st.matrix_pins || st.matrix_pin}] [counts=${st.matrix_counts || '-'}] (${st.matrix_scan || 'column'} map, flipX=${st.matrix_x_flip ? 1 : 0}, flipY=${st.matrix_y_flip ? 1 : 0}) | Brightness: ${st.matrix_brightness} | Scroll: ${st.matrix_scroll ? ('on "' + (st.matrix_scroll_text || '') + '" @ ' + st.matrix_scroll_speed + ' ms / ' + (st.matrix_scroll_direction || 'left') + (st.matrix_scroll_multicolor ? ' / multicolor' : ' / single')) : 'off'}`;
     }
 
     async function sendColor(hex) {
@@ -2634,18 +6389,32 @@ void handleRoot() {
 
     picker.addEventListener('input', () => {
       clearTimeout(colorTimer);
+      if (sendColorControl(picker.value)) {
+        dot.style.background = picker.value;
+        colorTimer = setTimeout(fetchState, 500);
+        return;
+      }
       colorTimer = setTimeout(() => sendColor(picker.value), 120);
     });
 
     brightness.addEventListener('input', () => {
       brightnessVal.textContent = brightness.value;
       clearTimeout(brightTimer);
+      if (sendControl([0x11, parseInt(brightness.value, 10)])) {
+        brightTimer = setTimeout(fetchState, 500);
+        return;
+      }
       brightTimer = setTimeout(() => setMatrixBrightness(brightness.value), 120);
     });
 
     matrixScrollSpeed.addEventListener('input', () => {
       matrixScrollSpeedVal.textContent = matrixScrollSpeed.value;
       clearTimeout(scrollTimer);
+      const speed = parseInt(matrixScrollSpeed.value, 10);
+      if (sendControl([0x12, 0, speed >> 8, speed & 255])) {
+        scrollTimer = setTimeout(fetchState, 500);
+        return;
+      }
       scrollTimer = setTimeout(() => setScrollSpeed(matrixScrollSpeed.value), 120);
     });
 
@@ -2735,13 +6504,15 @@ void handleRoot() {
         alert('Please provide an SSID.');
         return;
       }
-      statusEl.textContent = 'Connecting to Wi-Fi...';
       const res = await fetch('/api/wifi?ssid=' + encodeURIComponent(ssid) + '&password=' + encodeURIComponent(pass) + '&save=1');
       const data = await res.json();
       if (!res.ok) {
         alert(data.error || 'Failed to configure Wi-Fi');
+        fetchState();
+        return;
       }
-      fetchState();
+      wifiJob = data.job;
+      statusEl.textContent = `Connecting to Wi-Fi (job ${data.job})...`;
     });
 
     document.getElementById('wifiForget').addEventListener('click', async () => {
@@ -2780,153 +6551,508 @@ void handleRoot() {
       await fetch('/api/recover');
     });
 
-    fetchState();
-    setInterval(fetchState, 2000);
+    function openEvents() {
+      if (!window.EventSource) {
+        fetchState();
+        setInterval(fetchState, 2000);
+        return;
+      }
+      const events = new EventSource('/api/events');
+      events.addEventListener('state', e => applyState(JSON.parse(e.data)));
+    }
+
+    openSocket();
+    openEvents();
   </script>
 </body>
 </html>
 )HTML";
-  gWebServer.send_P(200, "text/html; charset=utf-8", kHtml);
+  request->send(200, "text/html; charset=utf-8", kHtml);
+}
+
+void queueDeferredCommand(DeferredCommand command) {
+  MatrixLock lock;
+  if (gDeferredCommand == DeferredCommand::Restart) {
+    return;
+  }
+  gDeferredCommand = command;
+  gDeferredCommandMs = millis();
+}
+
+void runDeferredCommand() {
+  DeferredCommand command = DeferredCommand::None;
+  String ssid;
+  String password;
+  bool save = false;
+  uint32_t job = 0;
+  {
+    MatrixLock lock;
+    if (gDeferredCommand == DeferredCommand::None || millis() - gDeferredCommandMs < kDeferredCommandDelayMs) {
+      return;
+    }
+    command = gDeferredCommand;
+    ssid = gDeferredSsid;
+    password = gDeferredPassword;
+    save = gDeferredSave;
+    job = gDeferredWifiJob;
+    gDeferredCommand = DeferredCommand::None;
+    gDeferredPassword = "";
+  }
+
+  switch (command) {
+    case DeferredCommand::WifiConnect: {
+      gWifiJobId = job;
+      gWifiJobSave = save;
+      // Already on that network with those credentials: rejoining would only
+      // drop the link the request came in on.
+      if (gWifiState == WifiState::Connected && WiFi.isConnected() && WiFi.SSID() == ssid &&
+          gWifiCurrent.password == password) {
+        gWifiJobStatus = WifiJobStatus::Connected;
+        if (save) {
+          storeWifiNetwork(gWifiCurrent);
+        }
+        break;
+      }
+      // The AP keeps the page reachable while the station switches networks.
+      startConfigAp();
+      gWifiJobStatus = WifiJobStatus::Pending;
+      gWifiCandidate = -1;
+      // A stored network with the same password keeps its cached join.
+      const int8_t stored = findWifiNetwork(ssid);
+      gWifiCurrent = (stored >= 0 && gWifiNetworks[stored].password == password) ? gWifiNetworks[stored] : WifiNetwork();
+      gWifiCurrent.ssid = ssid;
+      gWifiCurrent.password = password;
+      beginWifiJoin(fastestWifiJoinMode(gWifiCurrent));
+      break;
+    }
+    case DeferredCommand::WifiForget:
+      clearWifiNetworks();
+      WiFi.disconnect(true, true);
+      gWifiState = WifiState::Idle;
+      gWifiCandidate = -1;
+      gWifiCurrent = WifiNetwork();
+      startConfigAp();
+      gMdnsStarted = false;
+      break;
+    case DeferredCommand::WifiRemove:
+      removeWifiNetwork(ssid);
+      break;
+    case DeferredCommand::Restart:
+      ESP.restart();
+      break;
+    case DeferredCommand::None:
+    default:
+      break;
+  }
+  markStateChanged();
 }
 
-void handleApiState() {
-  gWebServer.send(200, "application/json", buildStateJson());
+void handleApiState(AsyncWebServerRequest *request) {
+  sendStateJson(request);
 }
 
-void handleApiRecover() {
+void handleApiRecover(AsyncWebServerRequest *request) {
   clearBootGuard();
   gRecoveryBootToken = kRecoveryBootMagic;
   gSafeMode = false;
   gSafeModeReason = "";
-  gWebServer.send(200, "application/json", "{\"ok\":true,\"message\":\"restarting\"}");
-  delay(300);
-  ESP.restart();
+  markStateChanged();
+  request->send(200, "application/json", "{\"ok\":true,\"message\":\"restarting\"}");
+  queueDeferredCommand(DeferredCommand::Restart);
 }
 
-void handleApiWifi() {
-  if (gWebServer.hasArg("forget") && gWebServer.arg("forget") != "0") {
-    clearWifiSettings();
-    WiFi.disconnect(true, true);
-    startConfigAp();
-    gMdnsStarted = false;
-    gWebServer.send(200, "application/json", "{\"ok\":true,\"forgot\":true}");
+void handleApiWifi(AsyncWebServerRequest *request) {
+  if (request->hasArg("forget") && request->arg("forget") != "0") {
+    queueDeferredCommand(DeferredCommand::WifiForget);
+    request->send(200, "application/json", "{\"ok\":true,\"forgot\":true}");
+    return;
+  }
+
+  if (request->hasArg("remove")) {
+    {
+      MatrixLock lock;
+      gDeferredSsid = request->arg("remove");
+    }
+    queueDeferredCommand(DeferredCommand::WifiRemove);
+    request->send(200, "application/json", "{\"ok\":true,\"removed\":true}");
+    return;
+  }
+
+  if (!request->hasArg("ssid")) {
+    sendStateJson(request);
+    return;
+  }
+
+  const String ssid = request->arg("ssid");
+  const String password = request->hasArg("password") ? request->arg("password") : "";
+  const bool save = !request->hasArg("save") || request->arg("save") != "0";
+
+  if (ssid.length() == 0) {
+    request->send(400, "application/json", "{\"error\":\"ssid_empty\"}");
+    return;
+  }
+
+  // Progress shows up in /api/state as wifi_job / wifi_job_status.
+  uint32_t job = 0;
+  {
+    MatrixLock lock;
+    gDeferredSsid = ssid;
+    gDeferredPassword = password;
+    gDeferredSave = save;
+    job = ++gWifiJobCounter;
+    gDeferredWifiJob = job;
+  }
+  queueDeferredCommand(DeferredCommand::WifiConnect);
+  request->send(202, "application/json", "{\"ok\":true,\"job\":" + String(job) + "}");
+}
+
+void handleApiUpdateFinished(AsyncWebServerRequest *request) {
+  if (gOtaHasError || Update.hasError()) {
+    request->send(500, "application/json", "{\"error\":\"ota_failed\"}");
+    return;
+  }
+
+  request->send(200, "application/json", "{\"ok\":true,\"message\":\"restarting\"}");
+  queueDeferredCommand(DeferredCommand::Restart);
+}
+
+// Called per received chunk; a client that dropped mid-upload leaves the
+// update running, so the next upload starts over.
+void handleApiUpdateUpload(AsyncWebServerRequest *request,
+                           const String &filename,
+                           size_t index,
+                           uint8_t *data,
+                           size_t length,
+                           bool final) {
+  if (index == 0) {
+    if (Update.isRunning()) {
+      Update.abort();
+    }
+    gOtaHasError = !Update.begin(UPDATE_SIZE_UNKNOWN, U_FLASH);
+  }
+  if (!gOtaHasError && length > 0 && Update.write(data, length) != length) {
+    gOtaHasError = true;
+  }
+  if (final && !gOtaHasError) {
+    gOtaHasError = !Update.end(true);
+  }
+}
+
+void handleApiLed(AsyncWebServerRequest *request) {
+  MatrixLock lock;
+  RgbColor next = gLedColor;
+  bool changed = false;
+
+  if (request->hasArg("hex")) {
+    changed = parseHexColor(request->arg("hex"), next);
+  } else if (request->hasArg("r") && request->hasArg("g") && request->hasArg("b")) {
+    next.r = static_cast<uint8_t>(constrain(request->arg("r").toInt(), 0, 255));
+    next.g = static_cast<uint8_t>(constrain(request->arg("g").toInt(), 0, 255));
+    next.b = static_cast<uint8_t>(constrain(request->arg("b").toInt(), 0, 255));
+    changed = true;
+  }
+
+  if (!changed) {
+    request->send(400, "application/json", "{\"error\":\"invalid_color\"}");
+    return;
+  }
+
+  setLedColor(next.r, next.g, next.b);
+  saveSettings();
+  markStateChanged();
+  sendStateJson(request);
+}
+
+void handleApiMatrix(AsyncWebServerRequest *request) {
+  MatrixLock lock;
+  if (gSafeMode) {
+    request->send(503, "application/json", "{\"error\":\"safe_mode_active\"}");
     return;
   }
+  // Bumped up front so early error returns after a partial update count too.
+  markStateChanged();
+
+  bool changed = false;
+  bool savePersistentSettings = false;
+
+  if (request->hasArg("brightness")) {
+    const int br = constrain(request->arg("brightness").toInt(), 0, 255);
+    setMatrixBrightness(static_cast<uint8_t>(br));
+    changed = true;
+    savePersistentSettings = true;
+  }
 
-  if (!gWebServer.hasArg("ssid")) {
-    gWebServer.send(200, "application/json", buildStateJson());
-    return;
+  if (request->hasArg("gamma")) {
+    String gammaArg = request->arg("gamma");
+    gammaArg.trim();
+    char *endPtr = nullptr;
+    const float gammaVal = strtof(gammaArg.c_str(), &endPtr);
+    if (endPtr == gammaArg.c_str() || endPtr == nullptr || *endPtr != '\0' || !isValidMatrixGamma(gammaVal)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_gamma\"}");
+      return;
+    }
+    setMatrixGamma(gammaVal);
+    changed = true;
+    savePersistentSettings = true;
   }
 
-  const String ssid = gWebServer.arg("ssid");
-  const String password = gWebServer.hasArg("password") ? gWebServer.arg("password") : "";
-  const bool save = !gWebServer.hasArg("save") || gWebServer.arg("save") != "0";
-
-  if (ssid.length() == 0) {
-    gWebServer.send(400, "application/json", "{\"error\":\"ssid_empty\"}");
-    return;
+  if (request->hasArg("fps")) {
+    String fpsArg = request->arg("fps");
+    fpsArg.trim();
+    char *endPtr = nullptr;
+    const long fpsVal = strtol(fpsArg.c_str(), &endPtr, 10);
+    if (endPtr == fpsArg.c_str() || endPtr == nullptr || *endPtr != '\0') {
+      request->send(400, "application/json", "{\"error\":\"invalid_fps\"}");
+      return;
+    }
+    if (fpsVal < kMatrixFpsMin || fpsVal > kMatrixFpsMax) {
+      request->send(400, "application/json", "{\"error\":\"fps_out_of_range\"}");
+      return;
+    }
+    if (!setMatrixTargetFps(static_cast<uint16_t>(fpsVal))) {
+      request->send(500, "application/json", "{\"error\":\"frame_timer_restart_failed\"}");
+      return;
+    }
+    changed = true;
+    savePersistentSettings = true;
   }
 
-  if (!gApMode) {
-    startConfigAp();
+  if (request->hasArg("frame_policy")) {
+    FramePolicy nextPolicy = gMatrixFramePolicy;
+    if (!parseFramePolicy(request->arg("frame_policy"), nextPolicy)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_frame_policy\"}");
+      return;
+    }
+    if (nextPolicy != gMatrixFramePolicy) {
+      gMatrixFramePolicy = nextPolicy;
+      resetMatrixFrameStats();
+      savePersistentSettings = true;
+    }
+    changed = true;
   }
 
-  if (!connectWifiWithCredentials(ssid, password, 20000)) {
-    gWebServer.send(502, "application/json", "{\"error\":\"wifi_connect_failed\"}");
-    return;
+  if (request->hasArg("frame_stats")) {
+    if (request->arg("frame_stats") == "reset") {
+      resetMatrixFrameStats();
+    }
+    changed = true;
   }
 
-  if (save) {
-    saveWifiSettings(ssid, password);
+  if (request->hasArg("effect_budget_us")) {
+    String budgetArg = request->arg("effect_budget_us");
+    budgetArg.trim();
+    char *endPtr = nullptr;
+    const long budgetVal = strtol(budgetArg.c_str(), &endPtr, 10);
+    if (endPtr == budgetArg.c_str() || endPtr == nullptr || *endPtr != '\0' ||
+        budgetVal < kMatrixEffectBudgetMinUs || budgetVal > kMatrixEffectBudgetMaxUs) {
+      request->send(400, "application/json", "{\"error\":\"invalid_effect_budget\"}");
+      return;
+    }
+    gMatrixEffectBudgetUs = static_cast<uint16_t>(budgetVal);
+    changed = true;
+    savePersistentSettings = true;
   }
 
-  if (!gMdnsStarted) {
-    gMdnsStarted = startMdns();
+  if (request->hasArg("current_limit_ma")) {
+    String limitArg = request->arg("current_limit_ma");
+    limitArg.trim();
+    char *endPtr = nullptr;
+    const long limitVal = strtol(limitArg.c_str(), &endPtr, 10);
+    if (endPtr == limitArg.c_str() || endPtr == nullptr || *endPtr != '\0' || limitVal < 0) {
+      request->send(400, "application/json", "{\"error\":\"invalid_current_limit\"}");
+      return;
+    }
+    gMatrixCurrentBudgetMa = static_cast<uint32_t>(limitVal);
+    changed = true;
+    savePersistentSettings = true;
   }
 
-  stopConfigAp();
-  gWebServer.send(200, "application/json", buildStateJson());
-}
+  if (request->hasArg("output_current_ma")) {
+    uint16_t nextBudgets[MATRIX_OUTPUT_COUNT] = {0};
+    String budgetError;
+    if (!parseMatrixOutputBudgetsCsv(request->arg("output_current_ma"), gMatrixActiveOutputs, nextBudgets,
+                                     budgetError)) {
+      request->send(400, "application/json", "{\"error\":\"" + budgetError + "\"}");
+      return;
+    }
+    for (uint8_t i = 0; i < gMatrixActiveOutputs; i++) {
+      gMatrixOutputBudgetMa[i] = nextBudgets[i];
+    }
+    changed = true;
+    savePersistentSettings = true;
+  }
 
-void handleApiUpdateFinished() {
-  if (gOtaHasError || Update.hasError()) {
-    gWebServer.send(500, "application/json", "{\"error\":\"ota_failed\"}");
-    return;
+  if (request->hasArg("e131_universe")) {
+    String universeArg = request->arg("e131_universe");
+    universeArg.trim();
+    char *endPtr = nullptr;
+    const long universeVal = strtol(universeArg.c_str(), &endPtr, 10);
+    if (endPtr == universeArg.c_str() || endPtr == nullptr || *endPtr != '\0' || universeVal < 1 ||
+        universeVal > kE131MaxUniverse) {
+      request->send(400, "application/json", "{\"error\":\"invalid_e131_universe\"}");
+      return;
+    }
+    gE131StartUniverse = static_cast<uint16_t>(universeVal);
+    resetE131Frame();
+    changed = true;
+    savePersistentSettings = true;
   }
 
-  gWebServer.send(200, "application/json", "{\"ok\":true,\"message\":\"restarting\"}");
-  delay(300);
-  ESP.restart();
-}
+  if (request->hasArg("universes_per_output")) {
+    String perOutputArg = request->arg("universes_per_output");
+    perOutputArg.trim();
+    char *endPtr = nullptr;
+    const long perOutputVal = strtol(perOutputArg.c_str(), &endPtr, 10);
+    if (endPtr == perOutputArg.c_str() || endPtr == nullptr || *endPtr != '\0' || perOutputVal < 0 ||
+        perOutputVal > kMatrixStreamMaxUniverses) {
+      request->send(400, "application/json", "{\"error\":\"invalid_universes_per_output\"}");
+      return;
+    }
+    gMatrixStreamUniversesPerOutput = static_cast<uint8_t>(perOutputVal);
+    resetE131Frame();
+    resetArtNetFrame();
+    changed = true;
+    savePersistentSettings = true;
+  }
 
-void handleApiUpdateUpload() {
-  HTTPUpload &upload = gWebServer.upload();
-  if (upload.status == UPLOAD_FILE_START) {
-    gOtaHasError = !Update.begin(UPDATE_SIZE_UNKNOWN, U_FLASH);
-  } else if (upload.status == UPLOAD_FILE_WRITE) {
-    if (!gOtaHasError && Update.write(upload.buf, upload.currentSize) != upload.currentSize) {
-      gOtaHasError = true;
+  if (request->hasArg("e131")) {
+    bool nextEnabled = gE131Enabled;
+    if (!parseBoolArg(request->arg("e131"), nextEnabled)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_e131\"}");
+      return;
     }
-  } else if (upload.status == UPLOAD_FILE_END) {
-    if (!gOtaHasError) {
-      gOtaHasError = !Update.end(true);
+    if (nextEnabled) {
+      if (!startE131Receiver()) {
+        request->send(500, "application/json", "{\"error\":\"e131_listen_failed\"}");
+        return;
+      }
+    } else {
+      stopE131Receiver();
     }
-  } else if (upload.status == UPLOAD_FILE_ABORTED) {
-    gOtaHasError = true;
-    Update.abort();
+    gE131Enabled = nextEnabled;
+    changed = true;
+    savePersistentSettings = true;
   }
-}
-
-void handleApiLed() {
-  RgbColor next = gLedColor;
-  bool changed = false;
 
-  if (gWebServer.hasArg("hex")) {
-    changed = parseHexColor(gWebServer.arg("hex"), next);
-  } else if (gWebServer.hasArg("r") && gWebServer.hasArg("g") && gWebServer.hasArg("b")) {
-    next.r = static_cast<uint8_t>(constrain(gWebServer.arg("r").toInt(), 0, 255));
-    next.g = static_cast<uint8_t>(constrain(gWebServer.arg("g").toInt(), 0, 255));
-    next.b = static_cast<uint8_t>(constrain(gWebServer.arg("b").toInt(), 0, 255));
+  if (request->hasArg("artnet_universe")) {
+    String portArg = request->arg("artnet_universe");
+    portArg.trim();
+    char *endPtr = nullptr;
+    const long portVal = strtol(portArg.c_str(), &endPtr, 10);
+    if (endPtr == portArg.c_str() || endPtr == nullptr || *endPtr != '\0' || portVal < 0 ||
+        portVal > kArtNetMaxPortAddress) {
+      request->send(400, "application/json", "{\"error\":\"invalid_artnet_universe\"}");
+      return;
+    }
+    gArtNetStartPort = static_cast<uint16_t>(portVal);
+    resetArtNetFrame();
     changed = true;
+    savePersistentSettings = true;
   }
 
-  if (!changed) {
-    gWebServer.send(400, "application/json", "{\"error\":\"invalid_color\"}");
-    return;
+  if (request->hasArg("artnet")) {
+    bool nextEnabled = gArtNetEnabled;
+    if (!parseBoolArg(request->arg("artnet"), nextEnabled)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_artnet\"}");
+      return;
+    }
+    if (nextEnabled) {
+      if (!startArtNetReceiver()) {
+        request->send(500, "application/json", "{\"error\":\"artnet_listen_failed\"}");
+        return;
+      }
+    } else {
+      stopArtNetReceiver();
+    }
+    gArtNetEnabled = nextEnabled;
+    changed = true;
+    savePersistentSettings = true;
   }
 
-  setLedColor(next.r, next.g, next.b);
-  saveSettings();
-  gWebServer.send(200, "application/json", buildStateJson());
-}
+  if (request->hasArg("ddp")) {
+    bool nextEnabled = gDdpEnabled;
+    if (!parseBoolArg(request->arg("ddp"), nextEnabled)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_ddp\"}");
+      return;
+    }
+    if (nextEnabled) {
+      if (!startDdpReceiver()) {
+        request->send(500, "application/json", "{\"error\":\"ddp_listen_failed\"}");
+        return;
+      }
+    } else {
+      stopDdpReceiver();
+    }
+    gDdpEnabled = nextEnabled;
+    changed = true;
+    savePersistentSettings = true;
+  }
 
-void handleApiMatrix() {
-  if (gSafeMode) {
-    gWebServer.send(503, "application/json", "{\"error\":\"safe_mode_active\"}");
-    return;
+  if (request->hasArg("serial_log")) {
+    SerialLogPolicy nextPolicy = gSerialLogPolicy;
+    if (!parseSerialLogPolicy(request->arg("serial_log"), nextPolicy)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_serial_log\"}");
+      return;
+    }
+    gSerialLogPolicy = nextPolicy;
+    changed = true;
+    savePersistentSettings = true;
   }
 
-  bool changed = false;
-  bool savePersistentSettings = false;
+  if (request->hasArg("serial")) {
+    bool nextEnabled = gSerialIngestEnabled;
+    if (!parseBoolArg(request->arg("serial"), nextEnabled)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_serial\"}");
+      return;
+    }
+    if (nextEnabled) {
+      if (!gMatrixReady) {
+        request->send(409, "application/json", "{\"error\":\"matrix_not_ready\"}");
+        return;
+      }
+      if (!startSerialIngest()) {
+        request->send(500, "application/json", "{\"error\":\"serial_ingest_start_failed\"}");
+        return;
+      }
+    } else {
+      stopSerialIngest();
+    }
+    changed = true;
+    savePersistentSettings = true;
+  }
 
-  if (gWebServer.hasArg("brightness")) {
-    const int br = constrain(gWebServer.arg("brightness").toInt(), 0, 255);
-    setMatrixBrightness(static_cast<uint8_t>(br));
+  if (request->hasArg("effect")) {
+    String effectArg = request->arg("effect");
+    effectArg.trim();
+    if (effectArg.equalsIgnoreCase("none") || effectArg == "0") {
+      stopMatrixEffect();
+    } else {
+      const MatrixEffect *effect = findMatrixEffect(effectArg);
+      if (effect == nullptr) {
+        request->send(400, "application/json", "{\"error\":\"unknown_effect\"}");
+        return;
+      }
+      if (!gMatrixReady) {
+        request->send(409, "application/json", "{\"error\":\"matrix_not_ready\"}");
+        return;
+      }
+      startMatrixEffect(effect);
+    }
     changed = true;
     savePersistentSettings = true;
   }
 
-  if (gWebServer.hasArg("test")) {
-    if (gWebServer.arg("test") != "0") {
+  if (request->hasArg("test")) {
+    if (request->arg("test") != "0") {
       startMatrixTest();
     }
     changed = true;
   }
 
-  if (gWebServer.hasArg("hex")) {
+  if (request->hasArg("hex")) {
     RgbColor next = gLedColor;
-    if (!parseHexColor(gWebServer.arg("hex"), next)) {
-      gWebServer.send(400, "application/json", "{\"error\":\"invalid_color\"}");
+    if (!parseHexColor(request->arg("hex"), next)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_color\"}");
       return;
     }
     setLedColor(next.r, next.g, next.b);
@@ -2934,36 +7060,64 @@ void handleApiMatrix() {
     savePersistentSettings = true;
   }
 
-  if (gWebServer.hasArg("scroll_speed")) {
-    String speedArg = gWebServer.arg("scroll_speed");
+  // Ticker line the text/segments/scroll/speed params below apply to.
+  uint8_t scrollLine = 0;
+  if (request->hasArg("line")) {
+    String lineArg = request->arg("line");
+    lineArg.trim();
+    char *endPtr = nullptr;
+    const long lineVal = strtol(lineArg.c_str(), &endPtr, 10);
+    if (endPtr == lineArg.c_str() || endPtr == nullptr || *endPtr != '\0' || lineVal < 1 ||
+        lineVal > kMatrixScrollLineCount) {
+      request->send(400, "application/json", "{\"error\":\"invalid_line\"}");
+      return;
+    }
+    scrollLine = static_cast<uint8_t>(lineVal - 1);
+  }
+  MatrixScrollLine &targetLine = gMatrixScrollLines[scrollLine];
+
+  if (request->hasArg("scroll_speed")) {
+    String speedArg = request->arg("scroll_speed");
     speedArg.trim();
     char *endPtr = nullptr;
     const long speedVal = strtol(speedArg.c_str(), &endPtr, 10);
     if (endPtr == speedArg.c_str() || endPtr == nullptr || *endPtr != '\0') {
-      gWebServer.send(400, "application/json", "{\"error\":\"invalid_scroll_speed\"}");
+      request->send(400, "application/json", "{\"error\":\"invalid_scroll_speed\"}");
       return;
     }
 
-    gMatrixScrollStepMs = static_cast<uint16_t>(constrain(static_cast<int>(speedVal), 40, 1000));
-    if (gMatrixScrollRunning) {
-      gMatrixScrollLastStepMs = millis();
-      renderMatrixScrollFrame();
+    const uint16_t stepMs = static_cast<uint16_t>(constrain(static_cast<int>(speedVal), 40, 1000));
+    setMatrixScrollSpeedMpps(targetLine, 1000000UL / stepMs);
+    changed = true;
+  }
+
+  if (request->hasArg("scroll_pps")) {
+    String ppsArg = request->arg("scroll_pps");
+    ppsArg.trim();
+    char *endPtr = nullptr;
+    const float ppsVal = strtof(ppsArg.c_str(), &endPtr);
+    if (endPtr == ppsArg.c_str() || endPtr == nullptr || *endPtr != '\0' || !(ppsVal > 0.0f)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_scroll_pps\"}");
+      return;
     }
+
+    const float mpps = constrain(ppsVal * 1000.0f, static_cast<float>(kScrollSpeedMinMpps),
+                                 static_cast<float>(kScrollSpeedMaxMpps));
+    setMatrixScrollSpeedMpps(targetLine, static_cast<uint32_t>(lroundf(mpps)));
     changed = true;
   }
 
-  if (gWebServer.hasArg("scroll_dir")) {
+  if (request->hasArg("scroll_dir")) {
     ScrollDirection nextDirection = gMatrixScrollDirection;
-    if (!parseScrollDirection(gWebServer.arg("scroll_dir"), nextDirection)) {
-      gWebServer.send(400, "application/json", "{\"error\":\"invalid_scroll_direction\"}");
+    if (!parseScrollDirection(request->arg("scroll_dir"), nextDirection)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_scroll_direction\"}");
       return;
     }
 
     if (nextDirection != gMatrixScrollDirection) {
       gMatrixScrollDirection = nextDirection;
       if (gMatrixScrollRunning) {
-        gMatrixScrollOffsetX = scrollStartOffsetX(gMatrixScrollDirection, gMatrixScrollText);
-        gMatrixScrollLastStepMs = millis();
+        resetMatrixScrollPosition();
         renderMatrixScrollFrame();
       }
       savePersistentSettings = true;
@@ -2971,10 +7125,10 @@ void handleApiMatrix() {
     changed = true;
   }
 
-  if (gWebServer.hasArg("map")) {
+  if (request->hasArg("map")) {
     MatrixScanOrder nextOrder = gMatrixScanOrder;
-    if (!parseMatrixScanOrder(gWebServer.arg("map"), nextOrder)) {
-      gWebServer.send(400, "application/json", "{\"error\":\"invalid_matrix_map\"}");
+    if (!parseMatrixScanOrder(request->arg("map"), nextOrder)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_matrix_map\"}");
       return;
     }
     if (nextOrder != gMatrixScanOrder) {
@@ -2984,16 +7138,16 @@ void handleApiMatrix() {
     changed = true;
   }
 
-  if (gWebServer.hasArg("xflip") || gWebServer.hasArg("yflip")) {
+  if (request->hasArg("xflip") || request->hasArg("yflip")) {
     bool nextXFlip = gMatrixXFlip;
     bool nextYFlip = gMatrixYFlip;
 
-    if (gWebServer.hasArg("xflip") && !parseBoolArg(gWebServer.arg("xflip"), nextXFlip)) {
-      gWebServer.send(400, "application/json", "{\"error\":\"invalid_xflip\"}");
+    if (request->hasArg("xflip") && !parseBoolArg(request->arg("xflip"), nextXFlip)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_xflip\"}");
       return;
     }
-    if (gWebServer.hasArg("yflip") && !parseBoolArg(gWebServer.arg("yflip"), nextYFlip)) {
-      gWebServer.send(400, "application/json", "{\"error\":\"invalid_yflip\"}");
+    if (request->hasArg("yflip") && !parseBoolArg(request->arg("yflip"), nextYFlip)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_yflip\"}");
       return;
     }
 
@@ -3004,17 +7158,17 @@ void handleApiMatrix() {
     changed = true;
   }
 
-  if (gWebServer.hasArg("active_outputs")) {
-    String outputsArg = gWebServer.arg("active_outputs");
+  if (request->hasArg("active_outputs")) {
+    String outputsArg = request->arg("active_outputs");
     outputsArg.trim();
     char *endPtr = nullptr;
     const long outputsVal = strtol(outputsArg.c_str(), &endPtr, 10);
     if (endPtr == outputsArg.c_str() || endPtr == nullptr || *endPtr != '\0') {
-      gWebServer.send(400, "application/json", "{\"error\":\"invalid_active_outputs\"}");
+      request->send(400, "application/json", "{\"error\":\"invalid_active_outputs\"}");
       return;
     }
     if (outputsVal < 1 || outputsVal > MATRIX_OUTPUT_COUNT) {
-      gWebServer.send(400, "application/json", "{\"error\":\"active_outputs_out_of_range\"}");
+      request->send(400, "application/json", "{\"error\":\"active_outputs_out_of_range\"}");
       return;
     }
 
@@ -3023,38 +7177,38 @@ void handleApiMatrix() {
       if (outputsError.length() == 0) {
         outputsError = "matrix_active_outputs_apply_failed";
       }
-      gWebServer.send(500, "application/json", "{\"error\":\"" + outputsError + "\"}");
+      request->send(500, "application/json", "{\"error\":\"" + outputsError + "\"}");
       return;
     }
     changed = true;
     savePersistentSettings = true;
   }
 
-  if (gWebServer.hasArg("pins")) {
+  if (request->hasArg("pins")) {
     uint8_t nextPins[MATRIX_OUTPUT_COUNT] = {0};
     String pinError;
-    if (!parseMatrixPinsCsv(gWebServer.arg("pins"), gMatrixActiveOutputs, nextPins, pinError)) {
-      gWebServer.send(400, "application/json", "{\"error\":\"" + pinError + "\"}");
+    if (!parseMatrixPinsCsv(request->arg("pins"), gMatrixActiveOutputs, nextPins, pinError)) {
+      request->send(400, "application/json", "{\"error\":\"" + pinError + "\"}");
       return;
     }
 
     if (!applyMatrixPins(nextPins)) {
-      gWebServer.send(500, "application/json", "{\"error\":\"matrix_pin_apply_failed\"}");
+      request->send(500, "application/json", "{\"error\":\"matrix_pin_apply_failed\"}");
       return;
     }
     changed = true;
     savePersistentSettings = true;
-  } else if (gWebServer.hasArg("pin")) {
-    String pinArg = gWebServer.arg("pin");
+  } else if (request->hasArg("pin")) {
+    String pinArg = request->arg("pin");
     pinArg.trim();
     char *endPtr = nullptr;
     const long pinVal = strtol(pinArg.c_str(), &endPtr, 10);
     if (endPtr == pinArg.c_str() || endPtr == nullptr || *endPtr != '\0') {
-      gWebServer.send(400, "application/json", "{\"error\":\"invalid_pin\"}");
+      request->send(400, "application/json", "{\"error\":\"invalid_pin\"}");
       return;
     }
     if (!isValidMatrixPin(static_cast<int>(pinVal))) {
-      gWebServer.send(400, "application/json", "{\"error\":\"pin_out_of_range\"}");
+      request->send(400, "application/json", "{\"error\":\"pin_out_of_range\"}");
       return;
     }
 
@@ -3065,77 +7219,103 @@ void handleApiMatrix() {
     nextPins[0] = static_cast<uint8_t>(pinVal);
 
     if (!matrixPinsAreUnique(nextPins, gMatrixActiveOutputs)) {
-      gWebServer.send(400, "application/json", "{\"error\":\"duplicate_pins\"}");
+      request->send(400, "application/json", "{\"error\":\"duplicate_pins\"}");
       return;
     }
 
     if (!applyMatrixPins(nextPins)) {
-      gWebServer.send(500, "application/json", "{\"error\":\"matrix_pin_apply_failed\"}");
+      request->send(500, "application/json", "{\"error\":\"matrix_pin_apply_failed\"}");
       return;
     }
     changed = true;
     savePersistentSettings = true;
   }
 
-  if (gWebServer.hasArg("counts")) {
+  if (request->hasArg("counts") || request->hasArg("heights")) {
+    // Either list may come alone; the other one keeps its current values.
     uint16_t nextCounts[MATRIX_OUTPUT_COUNT] = {0};
+    uint8_t nextHeights[MATRIX_OUTPUT_COUNT] = {0};
+    for (uint8_t i = 0; i < MATRIX_OUTPUT_COUNT; i++) {
+      nextCounts[i] = gMatrixLedsPerOutput[i];
+      nextHeights[i] = gMatrixHeights[i];
+    }
     String countsError;
-    if (!parseMatrixCountsCsv(gWebServer.arg("counts"), gMatrixActiveOutputs, nextCounts, countsError)) {
-      gWebServer.send(400, "application/json", "{\"error\":\"" + countsError + "\"}");
+    if (request->hasArg("counts") &&
+        !parseMatrixCountsCsv(request->arg("counts"), gMatrixActiveOutputs, nextCounts, countsError)) {
+      request->send(400, "application/json", "{\"error\":\"" + countsError + "\"}");
+      return;
+    }
+    if (request->hasArg("heights") &&
+        !parseMatrixHeightsCsv(request->arg("heights"), gMatrixActiveOutputs, nextHeights, countsError)) {
+      request->send(400, "application/json", "{\"error\":\"" + countsError + "\"}");
       return;
     }
-    if (!matrixCountsAreValid(nextCounts, gMatrixActiveOutputs, countsError)) {
-      gWebServer.send(400, "application/json", "{\"error\":\"" + countsError + "\"}");
+    if (!matrixCountsAreValid(nextCounts, nextHeights, gMatrixActiveOutputs, countsError)) {
+      request->send(400, "application/json", "{\"error\":\"" + countsError + "\"}");
       return;
     }
 
-    if (!applyMatrixCounts(nextCounts)) {
-      gWebServer.send(500, "application/json", "{\"error\":\"matrix_counts_apply_failed\"}");
+    if (!applyMatrixCounts(nextCounts, nextHeights)) {
+      request->send(500, "application/json", "{\"error\":\"matrix_counts_apply_failed\"}");
       return;
     }
     changed = true;
     savePersistentSettings = true;
-  } else if (gWebServer.hasArg("count")) {
-    gWebServer.send(400, "application/json", "{\"error\":\"use_counts_csv\"}");
+  } else if (request->hasArg("count")) {
+    request->send(400, "application/json", "{\"error\":\"use_counts_csv\"}");
     return;
   }
 
-  const bool hasTextArg = gWebServer.hasArg("text");
-  const bool hasSegmentsArg = gWebServer.hasArg("segments");
-  if (gWebServer.hasArg("scroll")) {
-    if (gWebServer.arg("scroll") != "0") {
+  if (request->hasArg("layout")) {
+    String layoutArg = request->arg("layout");
+    layoutArg.trim();
+    String layoutError;
+    if (!applyMatrixLayout(layoutArg, layoutError)) {
+      request->send(400, "application/json", "{\"error\":\"" + layoutError + "\"}");
+      return;
+    }
+    changed = true;
+    savePersistentSettings = true;
+  }
+
+  const bool hasTextArg = request->hasArg("text");
+  const bool hasSegmentsArg = request->hasArg("segments");
+  if (request->hasArg("scroll")) {
+    if (request->arg("scroll") != "0") {
       if (hasSegmentsArg) {
-        if (!startMatrixScrollSegments(gWebServer.arg("segments"), gMatrixScrollStepMs)) {
-          gWebServer.send(400, "application/json", "{\"error\":\"invalid_segments\"}");
+        if (!startMatrixScrollSegments(scrollLine, request->arg("segments"), targetLine.speedMpps)) {
+          request->send(400, "application/json", "{\"error\":\"invalid_segments\"}");
           return;
         }
       } else {
-        const String text = hasTextArg ? gWebServer.arg("text") : gMatrixScrollText;
-        if (!startMatrixScroll(text, gMatrixScrollStepMs)) {
-          gWebServer.send(400, "application/json", "{\"error\":\"text_empty\"}");
+        const String text = hasTextArg ? request->arg("text") : targetLine.text;
+        if (!startMatrixScroll(scrollLine, text, targetLine.speedMpps)) {
+          request->send(400, "application/json", "{\"error\":\"text_empty\"}");
           return;
         }
       }
+    } else if (scrollLine > 0) {
+      clearMatrixScrollLine(scrollLine);
     } else {
       stopMatrixScroll();
     }
     changed = true;
   } else if (hasSegmentsArg) {
-    if (!startMatrixScrollSegments(gWebServer.arg("segments"), gMatrixScrollStepMs)) {
-      gWebServer.send(400, "application/json", "{\"error\":\"invalid_segments\"}");
+    if (!startMatrixScrollSegments(scrollLine, request->arg("segments"), targetLine.speedMpps)) {
+      request->send(400, "application/json", "{\"error\":\"invalid_segments\"}");
       return;
     }
     changed = true;
   } else if (hasTextArg) {
-    if (!startMatrixScroll(gWebServer.arg("text"), gMatrixScrollStepMs)) {
-      gWebServer.send(400, "application/json", "{\"error\":\"text_empty\"}");
+    if (!startMatrixScroll(scrollLine, request->arg("text"), targetLine.speedMpps)) {
+      request->send(400, "application/json", "{\"error\":\"text_empty\"}");
       return;
     }
     changed = true;
   }
 
   if (!changed) {
-    gWebServer.send(400, "application/json", "{\"error\":\"invalid_params\"}");
+    request->send(400, "application/json", "{\"error\":\"invalid_params\"}");
     return;
   }
 
@@ -3143,10 +7323,225 @@ void handleApiMatrix() {
     saveSettings();
   }
 
-  gWebServer.send(200, "application/json", buildStateJson());
+  sendStateJson(request);
+}
+
+void scheduleSettingsSave() {
+  gSettingsSavePending = true;
+  gSettingsSaveMs = millis();
+}
+
+void flushPendingSettings() {
+  if (!gSettingsSavePending || millis() - gSettingsSaveMs < kSettingsSaveDelayMs) {
+    return;
+  }
+  MatrixLock lock;
+  gSettingsSavePending = false;
+  saveSettings();
+}
+
+// [op][flags][first pixel, u32 BE][payload], pixels in canvas order like DDP.
+// kWebSocketOpRgb carries RGB triplets, kWebSocketOpRle runs of
+// [count][r][g][b] with count 0 meaning 256. The frame is shown on
+// kWebSocketFramePush; canvases past one message split it over several.
+bool handleWebSocketFrame(const uint8_t *data, size_t length) {
+  if (length < kWebSocketFrameHeaderLength) {
+    return false;
+  }
+  if (!gMatrixReady || !claimMatrixStream(MatrixStreamSource::WebSocket)) {
+    return true;
+  }
+  const uint8_t *payload = data + kWebSocketFrameHeaderLength;
+  const size_t payloadLength = length - kWebSocketFrameHeaderLength;
+  uint32_t pixel = e131ReadU32(data + 2);
+  markMatrixStreamArrival();
+  if (data[0] == kWebSocketOpRgb) {
+    writeMatrixCanvasPixels(pixel, payload, static_cast<uint32_t>(payloadLength / 3));
+  } else {
+    const uint32_t canvas = static_cast<uint32_t>(matrixWidth()) * matrixHeight();
+    for (size_t i = 0; i + 4 <= payloadLength && pixel < canvas; i += 4) {
+      const uint32_t run = (payload[i] == 0) ? 256 : payload[i];
+      for (uint32_t j = 0; j < run; j++) {
+        writeMatrixCanvasPixels(pixel + j, payload + i + 1, 1);
+      }
+      pixel += run;
+    }
+  }
+  if ((data[1] & kWebSocketFramePush) != 0) {
+    presentMatrixStreamFrame();
+  }
+  return true;
+}
+
+// Controls, applied like their /api counterparts:
+//   kWebSocketOpColor [r][g][b]
+//   kWebSocketOpBrightness [value]
+//   kWebSocketOpScrollSpeed [line][step ms, u16 BE]
+//   kWebSocketOpScrollDirection [0 = left, 1 = right]
+bool handleWebSocketBinary(const uint8_t *data, size_t length) {
+  if (length == 0) {
+    return false;
+  }
+  const uint8_t op = data[0];
+  if (op == kWebSocketOpRgb || op == kWebSocketOpRle) {
+    return handleWebSocketFrame(data, length);
+  }
+  markStateChanged();
+  if (op == kWebSocketOpColor) {
+    if (length != 4) {
+      return false;
+    }
+    setLedColor(data[1], data[2], data[3]);
+    scheduleSettingsSave();
+    return true;
+  }
+  if (gSafeMode) {
+    return true;
+  }
+  if (op == kWebSocketOpBrightness) {
+    if (length != 2) {
+      return false;
+    }
+    setMatrixBrightness(data[1]);
+    scheduleSettingsSave();
+    return true;
+  }
+  if (op == kWebSocketOpScrollSpeed) {
+    if (length != 4 || data[1] >= kMatrixScrollLineCount) {
+      return false;
+    }
+    const uint16_t stepMs = static_cast<uint16_t>(constrain(static_cast<int>(e131ReadU16(data + 2)), 40, 1000));
+    setMatrixScrollSpeedMpps(gMatrixScrollLines[data[1]], 1000000UL / stepMs);
+    scheduleSettingsSave();
+    return true;
+  }
+  if (op == kWebSocketOpScrollDirection) {
+    if (length != 2 || data[1] > static_cast<uint8_t>(ScrollDirection::Right)) {
+      return false;
+    }
+    const ScrollDirection nextDirection = static_cast<ScrollDirection>(data[1]);
+    if (nextDirection != gMatrixScrollDirection) {
+      gMatrixScrollDirection = nextDirection;
+      if (gMatrixScrollRunning) {
+        resetMatrixScrollPosition();
+        renderMatrixScrollFrame();
+      }
+      scheduleSettingsSave();
+    }
+    return true;
+  }
+  return false;
+}
+
+// Reassembly buffer of clientId, taken from a free slot and allocated on the
+// first message that needs it. nullptr when all slots are busy or the
+// allocation fails.
+uint8_t *webSocketReassemblyBuffer(uint32_t clientId) {
+  WebSocketReassembly *freeSlot = nullptr;
+  for (WebSocketReassembly &slot : gWebSocketReassembly) {
+    if (slot.buffer != nullptr && slot.clientId == clientId) {
+      return slot.buffer;
+    }
+    if (slot.buffer == nullptr && freeSlot == nullptr) {
+      freeSlot = &slot;
+    }
+  }
+  if (freeSlot == nullptr) {
+    return nullptr;
+  }
+  uint8_t *buffer =
+    static_cast<uint8_t *>(heap_caps_malloc(kWebSocketMessageMaxBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  if (buffer == nullptr) {
+    buffer = static_cast<uint8_t *>(heap_caps_malloc(kWebSocketMessageMaxBytes, MALLOC_CAP_8BIT));
+  }
+  if (buffer != nullptr) {
+    freeSlot->clientId = clientId;
+    freeSlot->buffer = buffer;
+  }
+  return buffer;
+}
+
+void releaseWebSocketReassembly(uint32_t clientId) {
+  for (WebSocketReassembly &slot : gWebSocketReassembly) {
+    if (slot.buffer != nullptr && slot.clientId == clientId) {
+      heap_caps_free(slot.buffer);
+      slot.buffer = nullptr;
+    }
+  }
+}
+
+// Runs on the AsyncTCP task. A client gets the state JSON on connect and for
+// the text message "state"; binary messages get no reply. Messages split
+// into several WebSocket frames are not supported.
+void handleWebSocketEvent(AsyncWebSocket *server,
+                          AsyncWebSocketClient *client,
+                          AwsEventType type,
+                          void *arg,
+                          uint8_t *data,
+                          size_t length) {
+  MatrixLock lock;
+  if (type == WS_EVT_CONNECT) {
+    sendStateJson(client);
+    return;
+  }
+  if (type == WS_EVT_DISCONNECT) {
+    releaseWebSocketReassembly(client->id());
+    return;
+  }
+  if (type != WS_EVT_DATA) {
+    return;
+  }
+  const AwsFrameInfo *info = static_cast<const AwsFrameInfo *>(arg);
+  if (info->index == 0) {
+    gWebSocketMessages++;
+  }
+  if (!info->final || info->num != 0 || info->len > kWebSocketMessageMaxBytes) {
+    if (info->index == 0) {
+      gWebSocketInvalid++;
+    }
+    return;
+  }
+  const uint8_t *message = data;
+  if (info->len != length) {
+    uint8_t *buffer = webSocketReassemblyBuffer(client->id());
+    if (buffer == nullptr) {
+      if (info->index == 0) {
+        gWebSocketInvalid++;
+      }
+      return;
+    }
+    memcpy(buffer + info->index, data, length);
+    if (info->index + length < info->len) {
+      return;
+    }
+    message = buffer;
+  }
+
+  if (info->opcode == WS_BINARY) {
+    if (!handleWebSocketBinary(message, static_cast<size_t>(info->len))) {
+      gWebSocketInvalid++;
+    }
+    return;
+  }
+  if (info->len != 5 || memcmp(message, "state", 5) != 0) {
+    gWebSocketInvalid++;
+    return;
+  }
+  sendStateJson(client);
 }
 
 bool startWebServer() {
+  gWebServer.addMiddleware([](AsyncWebServerRequest *request, ArMiddlewareNext next) {
+    if (gHttpFirstAtMs == 0) {
+      gHttpFirstAtMs = millis();
+      markStateChanged();
+    }
+    next();
+  });
+  gWebSocket.onEvent(handleWebSocketEvent);
+  gWebServer.addHandler(&gWebSocket);
+  gEvents.onConnect(handleStateEventsConnect);
+  gWebServer.addHandler(&gEvents);
   gWebServer.on("/", HTTP_GET, handleRoot);
   gWebServer.on("/api/state", HTTP_GET, handleApiState);
   gWebServer.on("/api/recover", HTTP_GET, handleApiRecover);
@@ -3154,17 +7549,12 @@ bool startWebServer() {
   gWebServer.on("/api/matrix", HTTP_GET, handleApiMatrix);
   gWebServer.on("/api/wifi", HTTP_GET, handleApiWifi);
   gWebServer.on("/api/update", HTTP_POST, handleApiUpdateFinished, handleApiUpdateUpload);
-  gWebServer.onNotFound([]() {
-    gWebServer.send(404, "text/plain", "Not found");
+  gWebServer.onNotFound([](AsyncWebServerRequest *request) {
+    request->send(404, "text/plain", "Not found");
   });
   gWebServer.begin();
 
-  Serial.println("[OK] Web server started.");
-  if (WiFi.isConnected()) {
-    Serial.printf("Open: http://%s.local or http://%s\n",
-                  DEVICE_HOSTNAME,
-                  WiFi.localIP().toString().c_str());
-  }
+  Serial.println("[OK] Web server started (WebSocket at /ws).");
   if (gApMode) {
     Serial.printf("Config AP: SSID=%s password=%s URL=http://%s\n",
                   gApSsid.c_str(),
@@ -3177,8 +7567,13 @@ bool startWebServer() {
 }  // namespace
 
 void setup() {
+  // Must precede begin(); frames stream in faster than the default buffer drains.
+  Serial.setRxBufferSize(kSerialRxBufferBytes);
   Serial.begin(115200);
+#if BOOT_DIAGNOSTICS
   delay(800);
+#endif
+  gMatrixMutex = xSemaphoreCreateRecursiveMutex();
 
   const esp_reset_reason_t resetReason = esp_reset_reason();
   const bool recoveryBoot = (gRecoveryBootToken == kRecoveryBootMagic);
@@ -3213,8 +7608,13 @@ void setup() {
   pinMode(kLedPin, OUTPUT);
 #endif
 
+  // Joins in the background while the rest of setup runs; tickWifi() in
+  // loop() finishes it.
+  beginConfiguredWifi();
+
   Serial.println();
   printSystemInfo();
+#if BOOT_DIAGNOSTICS
   if (!gSafeMode && !recoveryBoot) {
     rgbTest();
     psramPatternTest();
@@ -3222,9 +7622,11 @@ void setup() {
   } else {
     Serial.println("[SAFE] Diagnostic stress tests skipped.");
   }
+#endif
 
   gMatrixRuntimeMaxLedCount = detectRuntimeMaxLedCount();
   loadDefaultMatrixCounts();
+  loadDefaultMatrixHeights();
   String bootGeometryError;
   (void)rebuildMatrixGeometry(gMatrixLedsPerOutput, gMatrixActiveOutputs, bootGeometryError);
   Serial.printf("[OK] Automatic runtime LED limit: %u (compiled ceiling: %u)\n",
@@ -3235,6 +7637,10 @@ void setup() {
   if (!gSafeMode) {
     if (initMatrix()) {
       applyMatrixSolidColor(gLedColor);
+      if (gMatrixEffect != nullptr) {
+        startMatrixEffect(gMatrixEffect);
+      }
+      startMatrixPipeline();
     } else {
       gSafeMode = true;
       gSafeModeReason = "matrix_init_failed";
@@ -3250,27 +7656,33 @@ void setup() {
     Serial.println("[SAFE] Matrix output disabled for recovery.");
   }
 
-  if (connectConfiguredWifi()) {
-    gMdnsStarted = startMdns();
-    (void)gMdnsStarted;
-  } else {
-    startConfigAp();
-  }
-
   gWebServerStarted = startWebServer();
+  if (gE131Enabled && gMatrixReady) {
+    startE131Receiver();
+  }
+  if (gArtNetEnabled && gMatrixReady) {
+    startArtNetReceiver();
+  }
+  if (gDdpEnabled && gMatrixReady) {
+    startDdpReceiver();
+  }
+  if (gSerialIngestEnabled && gMatrixReady) {
+    startSerialIngest();
+  }
 
   Serial.println("=== END DIAGNOSTICS ===");
 }
 
 void loop() {
-  if (gWebServerStarted) {
-    gWebServer.handleClient();
-  }
-
-  if (!gSafeMode) {
-    tickMatrixScroll();
-    tickMatrixTest();
+  static unsigned long lastClientCleanup = 0;
+  if (gWebServerStarted && millis() - lastClientCleanup >= 1000) {
+    lastClientCleanup = millis();
+    gWebSocket.cleanupClients();
   }
+  runDeferredCommand();
+  tickWifi();
+  flushPendingSettings();
+  tickStateEvents();
 
   static unsigned long lastPrint = 0;
   const unsigned long now = millis();
@@ -3280,7 +7692,7 @@ void loop() {
     Serial.println("[BOOT] Marked as stable, boot guard reset.");
   }
 
-  if (now - lastPrint >= 3000) {
+  if (now - lastPrint >= 3000 && serialHeartbeatEnabled()) {
     lastPrint = now;
     Serial.printf(
       "Heartbeat | uptime=%lu ms | heap=%u | psram_free=%u | wifi=%d | ip=%s | led=%s | matrix_br=%u | matrix_test=%d | matrix_scroll=%d | scroll_dir=%s | safe_mode=%d\n",
@@ -0,0 +1,432 @@
+// The 5x6 glyph switch that rendered scroll text before the packed font,
+// kept verbatim as the baseline for the glyph benchmark.
+#pragma once
+
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace legacy {
+
+static const uint8_t kScrollFontHeight = 6;
+static const uint8_t kScrollGlyphWidth = 5;
+
+bool loadGlyphRows(char c, uint8_t rows[kScrollFontHeight]) {
+  memset(rows, 0, kScrollFontHeight);
+
+  // 5x6 lowercase glyphs.
+  switch (c) {
+    case 'a': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'b': {
+      const uint8_t data[kScrollFontHeight] = {0x10, 0x10, 0x1E, 0x11, 0x11, 0x1E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'c': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x0E, 0x11, 0x10, 0x11, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'd': {
+      const uint8_t data[kScrollFontHeight] = {0x01, 0x01, 0x0F, 0x11, 0x11, 0x0F};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'e': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'f': {
+      const uint8_t data[kScrollFontHeight] = {0x06, 0x08, 0x1E, 0x08, 0x08, 0x08};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'g': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x0F, 0x11, 0x0F, 0x01, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'h': {
+      const uint8_t data[kScrollFontHeight] = {0x10, 0x10, 0x1E, 0x11, 0x11, 0x11};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'i': {
+      const uint8_t data[kScrollFontHeight] = {0x04, 0x00, 0x0C, 0x04, 0x04, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'j': {
+      const uint8_t data[kScrollFontHeight] = {0x02, 0x00, 0x02, 0x02, 0x12, 0x0C};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'k': {
+      const uint8_t data[kScrollFontHeight] = {0x10, 0x12, 0x14, 0x18, 0x14, 0x12};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'l': {
+      const uint8_t data[kScrollFontHeight] = {0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'm': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x1A, 0x15, 0x15, 0x15, 0x15};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'n': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x1E, 0x11, 0x11, 0x11, 0x11};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'o': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'p': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x1E, 0x11, 0x1E, 0x10, 0x10};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'q': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x0F, 0x11, 0x0F, 0x01, 0x01};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'r': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x16, 0x19, 0x10, 0x10, 0x10};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 's': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x0F, 0x10, 0x0E, 0x01, 0x1E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 't': {
+      const uint8_t data[kScrollFontHeight] = {0x08, 0x1E, 0x08, 0x08, 0x08, 0x06};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'u': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x11, 0x11, 0x11, 0x13, 0x0D};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'v': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x11, 0x11, 0x11, 0x0A, 0x04};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'w': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x11, 0x11, 0x15, 0x15, 0x0A};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'x': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'y': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x11, 0x11, 0x0F, 0x01, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'z': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    default:
+      break;
+  }
+
+  const char up = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+
+  switch (up) {
+    case 'A': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x1F, 0x11, 0x11, 0x11};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'B': {
+      const uint8_t data[kScrollFontHeight] = {0x1E, 0x11, 0x1E, 0x11, 0x11, 0x1E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'C': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x10, 0x10, 0x11, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'D': {
+      const uint8_t data[kScrollFontHeight] = {0x1E, 0x11, 0x11, 0x11, 0x11, 0x1E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'E': {
+      const uint8_t data[kScrollFontHeight] = {0x1F, 0x10, 0x1E, 0x10, 0x10, 0x1F};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'F': {
+      const uint8_t data[kScrollFontHeight] = {0x1F, 0x10, 0x1E, 0x10, 0x10, 0x10};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'G': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x10, 0x13, 0x11, 0x0F};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'H': {
+      const uint8_t data[kScrollFontHeight] = {0x11, 0x11, 0x1F, 0x11, 0x11, 0x11};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'I': {
+      const uint8_t data[kScrollFontHeight] = {0x1F, 0x04, 0x04, 0x04, 0x04, 0x1F};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'J': {
+      const uint8_t data[kScrollFontHeight] = {0x01, 0x01, 0x01, 0x11, 0x11, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'K': {
+      const uint8_t data[kScrollFontHeight] = {0x11, 0x12, 0x1C, 0x12, 0x11, 0x11};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'L': {
+      const uint8_t data[kScrollFontHeight] = {0x10, 0x10, 0x10, 0x10, 0x10, 0x1F};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'M': {
+      const uint8_t data[kScrollFontHeight] = {0x11, 0x1B, 0x15, 0x11, 0x11, 0x11};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'N': {
+      const uint8_t data[kScrollFontHeight] = {0x11, 0x19, 0x15, 0x13, 0x11, 0x11};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'O': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x11, 0x11, 0x11, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'P': {
+      const uint8_t data[kScrollFontHeight] = {0x1E, 0x11, 0x1E, 0x10, 0x10, 0x10};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'Q': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x11, 0x15, 0x12, 0x0D};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'R': {
+      const uint8_t data[kScrollFontHeight] = {0x1E, 0x11, 0x1E, 0x12, 0x11, 0x11};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'S': {
+      const uint8_t data[kScrollFontHeight] = {0x0F, 0x10, 0x0E, 0x01, 0x11, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'T': {
+      const uint8_t data[kScrollFontHeight] = {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'U': {
+      const uint8_t data[kScrollFontHeight] = {0x11, 0x11, 0x11, 0x11, 0x11, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'V': {
+      const uint8_t data[kScrollFontHeight] = {0x11, 0x11, 0x11, 0x11, 0x0A, 0x04};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'W': {
+      const uint8_t data[kScrollFontHeight] = {0x11, 0x11, 0x11, 0x15, 0x1B, 0x11};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'X': {
+      const uint8_t data[kScrollFontHeight] = {0x11, 0x0A, 0x04, 0x04, 0x0A, 0x11};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'Y': {
+      const uint8_t data[kScrollFontHeight] = {0x11, 0x0A, 0x04, 0x04, 0x04, 0x04};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case 'Z': {
+      const uint8_t data[kScrollFontHeight] = {0x1F, 0x02, 0x04, 0x08, 0x10, 0x1F};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '0': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x13, 0x15, 0x19, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '1': {
+      const uint8_t data[kScrollFontHeight] = {0x04, 0x0C, 0x04, 0x04, 0x04, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '2': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x01, 0x06, 0x08, 0x1F};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '3': {
+      const uint8_t data[kScrollFontHeight] = {0x1E, 0x01, 0x06, 0x01, 0x11, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '4': {
+      const uint8_t data[kScrollFontHeight] = {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '5': {
+      const uint8_t data[kScrollFontHeight] = {0x1F, 0x10, 0x1E, 0x01, 0x11, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '6': {
+      const uint8_t data[kScrollFontHeight] = {0x07, 0x08, 0x1E, 0x11, 0x11, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '7': {
+      const uint8_t data[kScrollFontHeight] = {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '8': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x0E, 0x11, 0x11, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '9': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x0E};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '!': {
+      const uint8_t data[kScrollFontHeight] = {0x04, 0x04, 0x04, 0x04, 0x00, 0x04};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '?': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x02, 0x04, 0x00, 0x04};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '.': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x04};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case ':': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x04, 0x00, 0x00, 0x04, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '-': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x00, 0x1F, 0x00, 0x00, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '_': {
+      const uint8_t data[kScrollFontHeight] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x1F};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '/': {
+      const uint8_t data[kScrollFontHeight] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '\\': {
+      const uint8_t data[kScrollFontHeight] = {0x10, 0x08, 0x04, 0x02, 0x01, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '<': {
+      const uint8_t data[kScrollFontHeight] = {0x02, 0x04, 0x08, 0x04, 0x02, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '>': {
+      const uint8_t data[kScrollFontHeight] = {0x08, 0x04, 0x02, 0x04, 0x08, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '*': {
+      const uint8_t data[kScrollFontHeight] = {0x04, 0x15, 0x0E, 0x15, 0x04, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '"': {
+      const uint8_t data[kScrollFontHeight] = {0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '\'': {
+      const uint8_t data[kScrollFontHeight] = {0x04, 0x04, 0x00, 0x00, 0x00, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '[': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x08, 0x08, 0x08, 0x0E, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case ']': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x02, 0x02, 0x02, 0x0E, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '@': {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x17, 0x15, 0x16, 0x0C};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case '#': {
+      const uint8_t data[kScrollFontHeight] = {0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x00};
+      memcpy(rows, data, kScrollFontHeight);
+      return true;
+    }
+    case ' ': {
+      return true;
+    }
+    default: {
+      const uint8_t data[kScrollFontHeight] = {0x0E, 0x11, 0x02, 0x04, 0x00, 0x04};
+      memcpy(rows, data, kScrollFontHeight);
+      return false;
+    }
+  }
+}
+
+}  // namespace legacy
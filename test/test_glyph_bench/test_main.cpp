@@ -0,0 +1,218 @@
+#include <unity.h>
+
+#include <chrono>
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "legacy_glyph_rows.h"
+#include "scroll_layout.h"
+
+// Glyphs per second through the old switch + per-bit path against the packed
+// font. Both draw into the same mapped RGB canvas the firmware uses, so the
+// difference is the glyph path alone.
+namespace {
+
+static const uint16_t kCanvasWidth = 384;
+static const uint8_t kCanvasHeight = 8;
+static const uint32_t kUnmapped = 0xFFFFFFFFUL;
+static const uint32_t kRounds = 20000;
+static const uint8_t kBatches = 5;
+
+uint32_t gPixelMap[kCanvasWidth * kCanvasHeight];
+uint8_t gPixels[kCanvasWidth * kCanvasHeight * 3];
+volatile uint32_t gSink = 0;
+
+const char kText[] = "The quick brown fox jumps over the lazy dog 0123456789";
+static const size_t kTextLength = sizeof(kText) - 1;
+
+uint8_t gStripMasks[kTextLength * 6];
+uint32_t gStripColors[kTextLength * 6];
+uint32_t gCharColors[kTextLength];
+uint16_t gStripWidth = 0;
+
+void setPixel(uint16_t x, uint8_t y, uint32_t color) {
+  const uint32_t entry = gPixelMap[static_cast<size_t>(y) * kCanvasWidth + x];
+  if (entry == kUnmapped) {
+    return;
+  }
+  uint8_t *pixel = gPixels + static_cast<size_t>(entry) * 3;
+  pixel[0] = static_cast<uint8_t>(color >> 8);
+  pixel[1] = static_cast<uint8_t>(color >> 16);
+  pixel[2] = static_cast<uint8_t>(color);
+}
+
+// drawGlyphAt() as it was before the font atlas.
+void drawLegacyGlyph(int16_t x, int16_t y, char c, uint32_t color) {
+  uint8_t rows[legacy::kScrollFontHeight] = {0};
+  legacy::loadGlyphRows(c, rows);
+  for (uint8_t row = 0; row < legacy::kScrollFontHeight; row++) {
+    const uint8_t rowBits = rows[row];
+    for (uint8_t col = 0; col < legacy::kScrollGlyphWidth; col++) {
+      if ((rowBits & (1 << (legacy::kScrollGlyphWidth - 1 - col))) == 0) {
+        continue;
+      }
+      const int16_t px = x + col;
+      const int16_t py = y + row;
+      if (px < 0 || py < 0 || px >= kCanvasWidth || py >= kCanvasHeight) {
+        continue;
+      }
+      setPixel(static_cast<uint16_t>(px), static_cast<uint8_t>(py), color);
+    }
+  }
+}
+
+// drawMatrixColumnMask() from src/main.cpp on the bench canvas.
+void drawColumnMask(int16_t x, int16_t y, uint32_t mask, uint32_t color) {
+  if (x < 0 || x >= kCanvasWidth || y >= kCanvasHeight) {
+    return;
+  }
+  if (y < 0) {
+    mask = (-y < 32) ? (mask >> -y) : 0;
+    y = 0;
+  }
+  const uint8_t rowsLeft = static_cast<uint8_t>(kCanvasHeight - y);
+  if (rowsLeft < 32) {
+    mask &= (1UL << rowsLeft) - 1;
+  }
+  while (mask != 0) {
+    const uint8_t row = static_cast<uint8_t>(__builtin_ctz(mask));
+    mask &= mask - 1;
+    setPixel(static_cast<uint16_t>(x), static_cast<uint8_t>(y + row), color);
+  }
+}
+
+void drawLegacyText(int16_t x) {
+  for (size_t i = 0; i < kTextLength; i++) {
+    drawLegacyGlyph(static_cast<int16_t>(x + i * (legacy::kScrollGlyphWidth + 1)), 1, kText[i], 0xFFFFFF);
+  }
+}
+
+// Per-frame work of the firmware's scroller: the message was laid out once,
+// so a frame only walks the strip columns.
+void drawStripText(int16_t x) {
+  for (uint16_t column = 0; column < gStripWidth; column++) {
+    drawColumnMask(static_cast<int16_t>(x + column), 0, gStripMasks[column], gStripColors[column]);
+  }
+}
+
+// The packed font looked up per glyph, without the strip cache.
+void drawFontText(int16_t x) {
+  for (size_t i = 0; i < kTextLength;) {
+    const ScrollGlyph glyph = scrollFontGlyph(decodeUtf8(kText, kTextLength, i));
+    for (uint8_t col = 0; col < glyph.width; col++) {
+      drawColumnMask(static_cast<int16_t>(x + col), 0, glyph.columns[col], 0xFFFFFF);
+    }
+    x = static_cast<int16_t>(x + glyph.width + kScrollFont[2]);
+  }
+}
+
+// Best of a few batches, so a preempted batch does not skew the result.
+double glyphsPerSecond(void (*draw)(int16_t)) {
+  double best = 0;
+  for (uint8_t batch = 0; batch < kBatches; batch++) {
+    const auto begin = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < kRounds; round++) {
+      // Scroll across the canvas so clipping is exercised like on the wall.
+      draw(static_cast<int16_t>(kCanvasWidth - static_cast<int16_t>(round % 400)));
+      gSink = gSink + gPixels[round % sizeof(gPixels)];
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    const double rate = static_cast<double>(kRounds) * kTextLength / elapsed.count();
+    if (rate > best) {
+      best = rate;
+    }
+  }
+  return best;
+}
+
+uint16_t litPixels() {
+  uint16_t count = 0;
+  for (size_t i = 0; i < sizeof(gPixels); i += 3) {
+    count += gPixels[i] != 0 ? 1 : 0;
+  }
+  return count;
+}
+
+}  // namespace
+
+void setUp() {
+  // Serpentine columns of 8, like one output of the default wall.
+  for (uint16_t x = 0; x < kCanvasWidth; x++) {
+    for (uint8_t y = 0; y < kCanvasHeight; y++) {
+      const uint8_t row = (x & 1) ? static_cast<uint8_t>(kCanvasHeight - 1 - y) : y;
+      gPixelMap[static_cast<size_t>(y) * kCanvasWidth + x] = static_cast<uint32_t>(x) * kCanvasHeight + row;
+    }
+  }
+  memset(gPixels, 0, sizeof(gPixels));
+  gStripWidth = layoutScrollStrip(kText, kTextLength, gCharColors, gStripMasks, gStripColors,
+                                  sizeof(gStripMasks));
+  for (uint16_t column = 0; column < gStripWidth; column++) {
+    gStripColors[column] = 0xFFFFFF;
+  }
+}
+
+void tearDown() {}
+
+void test_letters_and_digits_keep_their_shapes() {
+  for (int c = 0; c < 128; c++) {
+    if (!isalnum(c)) {
+      continue;
+    }
+    uint8_t rows[legacy::kScrollFontHeight] = {0};
+    legacy::loadGlyphRows(static_cast<char>(c), rows);
+    uint8_t firstColumn = legacy::kScrollGlyphWidth;
+    for (uint8_t row = 0; row < legacy::kScrollFontHeight; row++) {
+      for (uint8_t col = 0; col < legacy::kScrollGlyphWidth; col++) {
+        if ((rows[row] & (1 << (legacy::kScrollGlyphWidth - 1 - col))) != 0 && col < firstColumn) {
+          firstColumn = col;
+        }
+      }
+    }
+    // The packed font trims blank columns and puts the 6 body rows at 1..6.
+    const ScrollGlyph glyph = scrollFontGlyph(static_cast<uint32_t>(c));
+    for (uint8_t row = 0; row < legacy::kScrollFontHeight; row++) {
+      for (uint8_t col = 0; col < legacy::kScrollGlyphWidth; col++) {
+        const bool legacyLit = (rows[row] & (1 << (legacy::kScrollGlyphWidth - 1 - col))) != 0;
+        const int16_t packedCol = static_cast<int16_t>(col) - firstColumn;
+        const bool packedLit = packedCol >= 0 && packedCol < glyph.width &&
+                               ((glyph.columns[packedCol] >> (row + 1)) & 1U) != 0;
+        TEST_ASSERT_EQUAL_MESSAGE(legacyLit, packedLit, "glyph shape changed");
+      }
+    }
+  }
+}
+
+void test_paths_light_the_same_pixels() {
+  drawLegacyText(0);
+  const uint16_t legacyPixels = litPixels();
+  memset(gPixels, 0, sizeof(gPixels));
+  drawStripText(0);
+  TEST_ASSERT_EQUAL_UINT16(legacyPixels, litPixels());
+  memset(gPixels, 0, sizeof(gPixels));
+  drawFontText(0);
+  TEST_ASSERT_EQUAL_UINT16(legacyPixels, litPixels());
+}
+
+void test_glyph_throughput() {
+  const double legacyRate = glyphsPerSecond(drawLegacyText);
+  const double fontRate = glyphsPerSecond(drawFontText);
+  const double stripRate = glyphsPerSecond(drawStripText);
+  char message[160];
+  snprintf(message, sizeof(message),
+           "glyphs/s: legacy switch %.0f, packed font %.0f (x%.2f), cached strip %.0f (x%.2f)",
+           legacyRate, fontRate, fontRate / legacyRate, stripRate, stripRate / legacyRate);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(legacyRate > 0 && fontRate > 0 && stripRate > 0);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_letters_and_digits_keep_their_shapes);
+  RUN_TEST(test_paths_light_the_same_pixels);
+  RUN_TEST(test_glyph_throughput);
+  return UNITY_END();
+}
@@ -0,0 +1,366 @@
+#include <unity.h>
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "matrix_map.h"
+#include "scroll_layout.h"
+
+namespace {
+
+static const uint8_t kMaxOutputs = 8;
+static const uint8_t kStripHeight = 8;
+
+struct Wall {
+  uint8_t outputs;
+  uint16_t cols[kMaxOutputs];
+  uint8_t heights[kMaxOutputs];
+  // 0 means a full cols * height rectangle.
+  uint16_t leds[kMaxOutputs];
+};
+
+const Wall kWalls[] = {
+  {1, {8}, {8}, {0}},
+  {2, {8, 16}, {8, 8}, {0, 0}},
+  {8, {1, 2, 3, 5, 8, 12, 7, 4}, {8, 8, 8, 8, 8, 8, 8, 8}, {0}},
+  {3, {5, 7, 3}, {8, 6, 16}, {0, 0, 0}},
+  {4, {9, 9, 9, 9}, {16, 16, 16, 16}, {0}},
+  {2, {8, 8}, {8, 8}, {60, 0}},
+  {2, {3, 4}, {5, 7}, {0, 26}},
+};
+
+uint8_t gOutputs = 0;
+uint16_t gWidth = 0;
+uint8_t gHeight = 0;
+uint16_t gXOffsets[kMaxOutputs + 1];
+uint16_t gCols[kMaxOutputs];
+uint8_t gHeights[kMaxOutputs];
+uint16_t gLeds[kMaxOutputs];
+
+struct TestGeometry {
+  static uint16_t width() { return gWidth; }
+  static uint8_t height() { return gHeight; }
+  static uint8_t activeOutputs() { return gOutputs; }
+  static uint16_t xOffset(uint8_t output) { return gXOffsets[output]; }
+  static uint16_t outputWidth(uint8_t output) { return gCols[output]; }
+  static uint8_t outputHeight(uint8_t output) { return gHeights[output]; }
+  static uint16_t outputLeds(uint8_t output) { return gLeds[output]; }
+};
+
+// Same arithmetic as rebuildMatrixGeometry().
+void useWall(const Wall &wall) {
+  gOutputs = wall.outputs;
+  gWidth = 0;
+  gHeight = 0;
+  gXOffsets[0] = 0;
+  for (uint8_t i = 0; i < wall.outputs; i++) {
+    gCols[i] = wall.cols[i];
+    gHeights[i] = wall.heights[i];
+    gLeds[i] = wall.leds[i] != 0 ? wall.leds[i] : static_cast<uint16_t>(wall.cols[i] * wall.heights[i]);
+    gWidth = static_cast<uint16_t>(gWidth + wall.cols[i]);
+    gXOffsets[i + 1] = gWidth;
+    if (wall.heights[i] > gHeight) {
+      gHeight = wall.heights[i];
+    }
+  }
+}
+
+bool uniformHeight(uint8_t height) {
+  for (uint8_t i = 0; i < gOutputs; i++) {
+    if (gHeights[i] != height) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool gRefXFlip = false;
+bool gRefYFlip = false;
+bool gRefColumnMajor = false;
+bool gRefSerpentine = false;
+
+// mapMatrixXY() as it was before the specialization: every layout choice is
+// a runtime branch on every pixel.
+bool referenceMapXY(uint16_t x, uint8_t y, uint8_t &output, uint16_t &index) {
+  if (gWidth == 0 || x >= gWidth || y >= gHeight) {
+    return false;
+  }
+
+  uint16_t mappedX = gRefXFlip ? (gWidth - 1 - x) : x;
+  const uint8_t mappedY = gRefYFlip ? (gHeight - 1 - y) : y;
+
+  output = 0;
+  while (output < gOutputs && mappedX >= gXOffsets[output + 1]) {
+    output++;
+  }
+  if (output >= gOutputs) {
+    return false;
+  }
+
+  uint16_t localX = static_cast<uint16_t>(mappedX - gXOffsets[output]);
+  const uint16_t outputWidth = gCols[output];
+  const uint8_t outputHeight = gHeights[output];
+  if (outputWidth == 0 || localX >= outputWidth || mappedY >= outputHeight) {
+    return false;
+  }
+
+  uint8_t localY = mappedY;
+  if (gRefColumnMajor) {
+    if (gRefSerpentine && ((localX & 0x01) != 0)) {
+      localY = outputHeight - 1 - localY;
+    }
+    index = static_cast<uint16_t>(localX) * outputHeight + localY;
+  } else {
+    if (gRefSerpentine && ((localY & 0x01) != 0)) {
+      localX = outputWidth - 1 - localX;
+    }
+    index = static_cast<uint16_t>(localY) * outputWidth + localX;
+  }
+  return index < gLeds[output];
+}
+
+void useVariant(uint8_t variant, bool serpentine) {
+  gRefXFlip = (variant & 0x01) != 0;
+  gRefYFlip = (variant & 0x02) != 0;
+  gRefColumnMajor = (variant & 0x04) != 0;
+  gRefSerpentine = serpentine;
+}
+
+MatrixMapXYFn specialized(uint8_t variant, bool serpentine, bool fixedHeight) {
+  if (serpentine) {
+    return fixedHeight ? matrixMapXYVariant<TestGeometry, true, kStripHeight>(variant)
+                       : matrixMapXYVariant<TestGeometry, true, 0>(variant);
+  }
+  return fixedHeight ? matrixMapXYVariant<TestGeometry, false, kStripHeight>(variant)
+                     : matrixMapXYVariant<TestGeometry, false, 0>(variant);
+}
+
+// Walks the canvas plus a margin and fails on the first cell where the
+// specialized mapping and the reference disagree.
+bool sameMapping(MatrixMapXYFn mapXY, char *failure, size_t failureSize) {
+  for (uint16_t x = 0; x < gWidth + 3; x++) {
+    for (uint8_t y = 0; y < gHeight + 3; y++) {
+      uint8_t refOutput = 0xFF;
+      uint16_t refIndex = 0xFFFF;
+      uint8_t output = 0xFF;
+      uint16_t index = 0xFFFF;
+      const bool refMapped = referenceMapXY(x, y, refOutput, refIndex);
+      const bool mapped = mapXY(x, y, output, index);
+      if (refMapped != mapped || (mapped && (refOutput != output || refIndex != index))) {
+        snprintf(failure, failureSize, "x=%u y=%u: expected %d/%u/%u got %d/%u/%u", x, y, refMapped, refOutput,
+                 refIndex, mapped, output, index);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+uint8_t gFrame[kMaxOutputs][16 * 16 * 3];
+uint8_t gRefFrame[kMaxOutputs][16 * 16 * 3];
+
+// The scroller's per-frame column walk (drawMatrixColumnMask) into per-output
+// LED buffers through the given mapping. Returns the pixels written.
+uint32_t drawStrip(MatrixMapXYFn mapXY, const uint8_t *masks, const uint32_t *colors, uint16_t stripWidth,
+                   int16_t offsetX, uint8_t frame[kMaxOutputs][16 * 16 * 3]) {
+  memset(frame, 0, sizeof(gFrame));
+  uint32_t written = 0;
+  for (uint16_t column = 0; column < stripWidth; column++) {
+    const int16_t x = static_cast<int16_t>(offsetX + column);
+    if (x < 0 || x >= gWidth) {
+      continue;
+    }
+    uint32_t mask = masks[column];
+    if (gHeight < 32) {
+      mask &= (1UL << gHeight) - 1;
+    }
+    while (mask != 0) {
+      const uint8_t row = static_cast<uint8_t>(__builtin_ctz(mask));
+      mask &= mask - 1;
+      uint8_t output = 0;
+      uint16_t index = 0;
+      if (mapXY(static_cast<uint16_t>(x), row, output, index)) {
+        uint8_t *pixel = frame[output] + static_cast<size_t>(index) * 3;
+        pixel[0] = static_cast<uint8_t>(colors[column] >> 8);
+        pixel[1] = static_cast<uint8_t>(colors[column] >> 16);
+        pixel[2] = static_cast<uint8_t>(colors[column]);
+        written++;
+      }
+    }
+  }
+  return written;
+}
+
+uint32_t litLeds(uint8_t frame[kMaxOutputs][16 * 16 * 3]) {
+  uint32_t count = 0;
+  for (uint8_t output = 0; output < kMaxOutputs; output++) {
+    for (size_t i = 0; i < sizeof(frame[output]); i += 3) {
+      count += (frame[output][i] | frame[output][i + 1] | frame[output][i + 2]) != 0 ? 1 : 0;
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_every_instantiation_matches_reference() {
+  char failure[96];
+  char message[192];
+  for (const Wall &wall : kWalls) {
+    useWall(wall);
+    for (uint8_t serpentine = 0; serpentine < 2; serpentine++) {
+      for (uint8_t variant = 0; variant < 8; variant++) {
+        useVariant(variant, serpentine != 0);
+        for (uint8_t fixed = 0; fixed < 2; fixed++) {
+          // The firmware only picks the fixed-height table when it applies.
+          if (fixed != 0 && !uniformHeight(kStripHeight)) {
+            continue;
+          }
+          if (!sameMapping(specialized(variant, serpentine != 0, fixed != 0), failure, sizeof(failure))) {
+            snprintf(message, sizeof(message), "wall %u outputs, variant %u, serpentine %u, fixed %u: %s",
+                     wall.outputs, variant, serpentine, fixed, failure);
+            TEST_FAIL_MESSAGE(message);
+          }
+        }
+      }
+    }
+  }
+}
+
+void test_mapping_is_one_to_one() {
+  for (const Wall &wall : kWalls) {
+    useWall(wall);
+    for (uint8_t variant = 0; variant < 8; variant++) {
+      const MatrixMapXYFn mapXY = specialized(variant, true, false);
+      static bool seen[kMaxOutputs][16 * 16];
+      memset(seen, 0, sizeof(seen));
+      uint32_t mapped = 0;
+      for (uint16_t x = 0; x < gWidth; x++) {
+        for (uint8_t y = 0; y < gHeight; y++) {
+          uint8_t output = 0;
+          uint16_t index = 0;
+          if (!mapXY(x, y, output, index)) {
+            continue;
+          }
+          TEST_ASSERT_FALSE_MESSAGE(seen[output][index], "two cells share one LED");
+          seen[output][index] = true;
+          mapped++;
+        }
+      }
+      uint32_t leds = 0;
+      for (uint8_t i = 0; i < gOutputs; i++) {
+        leds += gLeds[i];
+      }
+      TEST_ASSERT_EQUAL_UINT32(leds, mapped);
+    }
+  }
+}
+
+void test_scroll_strip_renders_through_every_variant() {
+  const char *text = "Olá, mundo! TAVERNA 0123";
+  uint8_t masks[256];
+  uint32_t colors[256];
+  uint32_t charColors[64];
+  for (uint8_t i = 0; i < 64; i++) {
+    charColors[i] = 0x102030UL * (i + 1);
+  }
+  const uint16_t stripWidth = layoutScrollStrip(text, strlen(text), charColors, masks, colors, sizeof(masks));
+  TEST_ASSERT_GREATER_THAN(0, stripWidth);
+
+  const int16_t offsets[] = {-40, -3, 0, 5, 30};
+  for (const Wall &wall : kWalls) {
+    useWall(wall);
+    if (!uniformHeight(kStripHeight)) {
+      continue;
+    }
+    for (uint8_t variant = 0; variant < 8; variant++) {
+      useVariant(variant, true);
+      for (int16_t offset : offsets) {
+        const uint32_t written =
+          drawStrip(specialized(variant, true, true), masks, colors, stripWidth, offset, gFrame);
+        const uint32_t refWritten = drawStrip(referenceMapXY, masks, colors, stripWidth, offset, gRefFrame);
+        TEST_ASSERT_EQUAL_UINT32(refWritten, written);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(gRefFrame, gFrame, sizeof(gFrame));
+
+        // Every lit strip pixel over a wired cell landed on its own LED.
+        uint32_t visible = 0;
+        for (uint16_t column = 0; column < stripWidth; column++) {
+          const int32_t x = offset + column;
+          for (uint8_t row = 0; row < gHeight && x >= 0 && x < gWidth; row++) {
+            uint8_t output = 0;
+            uint16_t index = 0;
+            if (((masks[column] >> row) & 1U) != 0 && referenceMapXY(static_cast<uint16_t>(x), row, output, index)) {
+              visible++;
+            }
+          }
+        }
+        TEST_ASSERT_EQUAL_UINT32(visible, written);
+        TEST_ASSERT_EQUAL_UINT32(visible, litLeds(gFrame));
+      }
+    }
+  }
+}
+
+void test_pixels_per_second() {
+  // 8 outputs of 40x8, the default wall scaled out.
+  Wall wall = {8, {40, 40, 40, 40, 40, 40, 40, 40}, {8, 8, 8, 8, 8, 8, 8, 8}, {0}};
+  useWall(wall);
+  static const uint32_t kPasses = 1000;
+  static const uint8_t kBatches = 5;
+  char message[128];
+  for (int8_t variant = -1; variant < 8; variant++) {
+    MatrixMapXYFn volatile mapXY = referenceMapXY;
+    if (variant >= 0) {
+      mapXY = specialized(static_cast<uint8_t>(variant), true, true);
+    } else {
+      useVariant(0, true);
+    }
+    uint32_t checksum = 0;
+    // Best of a few batches, so a preempted batch does not skew the result.
+    double rate = 0;
+    for (uint8_t batch = 0; batch < kBatches; batch++) {
+      const auto begin = std::chrono::steady_clock::now();
+      for (uint32_t pass = 0; pass < kPasses; pass++) {
+        for (uint8_t y = 0; y < gHeight; y++) {
+          for (uint16_t x = 0; x < gWidth; x++) {
+            uint8_t output = 0;
+            uint16_t index = 0;
+            if (mapXY(x, y, output, index)) {
+              checksum += index + output;
+            }
+          }
+        }
+      }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+      const double batchRate = static_cast<double>(kPasses) * gWidth * gHeight / elapsed.count();
+      if (batchRate > rate) {
+        rate = batchRate;
+      }
+    }
+    if (variant < 0) {
+      snprintf(message, sizeof(message), "runtime flags       %6.1f Mpx/s", rate / 1e6);
+    } else {
+      snprintf(message, sizeof(message), "variant x%u y%u col%u  %6.1f Mpx/s", variant & 1, (variant >> 1) & 1,
+               (variant >> 2) & 1, rate / 1e6);
+    }
+    TEST_MESSAGE(message);
+    TEST_ASSERT_GREATER_THAN(0, checksum);
+  }
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_every_instantiation_matches_reference);
+  RUN_TEST(test_mapping_is_one_to_one);
+  RUN_TEST(test_scroll_strip_renders_through_every_variant);
+  RUN_TEST(test_pixels_per_second);
+  return UNITY_END();
+}
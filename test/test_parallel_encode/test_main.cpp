@@ -0,0 +1,189 @@
+#include <unity.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parallel_ws2812.h"
+
+namespace {
+
+static const uint16_t kMaxLeds = 64;
+static const size_t kMaxBytes = kMaxLeds * kParallelBytesPerLed + kParallelResetBytes;
+
+uint8_t gLaneData[kParallelLaneCount][kMaxLeds * kParallelChannelsPerLed];
+uint8_t gIdentityLut[256];
+uint8_t gHalfLut[256];
+uint8_t gExpected[kMaxBytes];
+uint8_t gActual[kMaxBytes + 16];
+
+// Bit-by-bit reference: for every data bit the bus shows the active lanes
+// high, then each lane's own bit, then everything low.
+size_t referenceEncode(const uint8_t *const lanes[kParallelLaneCount],
+                       const uint16_t counts[kParallelLaneCount],
+                       uint16_t ledCount,
+                       const uint8_t *const luts[kParallelLaneCount],
+                       uint8_t *out) {
+  size_t cursor = 0;
+  for (uint16_t led = 0; led < ledCount; led++) {
+    for (uint8_t channel = 0; channel < kParallelChannelsPerLed; channel++) {
+      for (int bit = 7; bit >= 0; bit--) {
+        uint8_t high = 0;
+        uint8_t data = 0;
+        for (uint8_t lane = 0; lane < kParallelLaneCount; lane++) {
+          if (lanes[lane] == nullptr || led >= counts[lane]) {
+            continue;
+          }
+          high |= static_cast<uint8_t>(1U << lane);
+          const uint8_t value = luts[lane][lanes[lane][led * kParallelChannelsPerLed + channel]];
+          if ((value >> bit) & 1U) {
+            data |= static_cast<uint8_t>(1U << lane);
+          }
+        }
+        out[cursor++] = high;
+        out[cursor++] = data;
+        out[cursor++] = 0;
+      }
+    }
+  }
+  for (size_t i = 0; i < kParallelResetBytes; i++) {
+    out[cursor++] = 0;
+  }
+  return cursor;
+}
+
+void fillLanes(uint32_t seed) {
+  for (uint8_t lane = 0; lane < kParallelLaneCount; lane++) {
+    for (size_t i = 0; i < sizeof(gLaneData[lane]); i++) {
+      seed = seed * 1664525UL + 1013904223UL;
+      gLaneData[lane][i] = static_cast<uint8_t>(seed >> 24);
+    }
+  }
+}
+
+void checkAgainstReference(const uint8_t *const lanes[kParallelLaneCount],
+                           const uint16_t counts[kParallelLaneCount],
+                           uint16_t ledCount,
+                           const uint8_t *const luts[kParallelLaneCount]) {
+  memset(gActual, 0xA5, sizeof(gActual));
+  const size_t expectedBytes = referenceEncode(lanes, counts, ledCount, luts, gExpected);
+  const size_t bytes = encodeParallelWs2812Frame(lanes, counts, ledCount, luts, gActual);
+  TEST_ASSERT_EQUAL_UINT(ledCount * kParallelBytesPerLed + kParallelResetBytes, bytes);
+  TEST_ASSERT_EQUAL_UINT(expectedBytes, bytes);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(gExpected, gActual, bytes);
+  // Nothing past the returned length may be touched.
+  TEST_ASSERT_EQUAL_UINT8(0xA5, gActual[bytes]);
+}
+
+}  // namespace
+
+void setUp() {
+  for (int value = 0; value < 256; value++) {
+    gIdentityLut[value] = static_cast<uint8_t>(value);
+    gHalfLut[value] = static_cast<uint8_t>(value >> 1);
+  }
+}
+
+void tearDown() {}
+
+void test_single_lane_bit_pattern() {
+  const uint8_t pixel[kParallelChannelsPerLed] = {0x80, 0x01, 0xA5};
+  const uint8_t *lanes[kParallelLaneCount] = {nullptr};
+  const uint8_t *luts[kParallelLaneCount] = {nullptr};
+  uint16_t counts[kParallelLaneCount] = {0};
+  lanes[0] = pixel;
+  luts[0] = gIdentityLut;
+  counts[0] = 1;
+
+  const size_t bytes = encodeParallelWs2812Frame(lanes, counts, 1, luts, gActual);
+  TEST_ASSERT_EQUAL_UINT(kParallelBytesPerLed + kParallelResetBytes, bytes);
+  // 0x80: only the first data slot carries lane 0.
+  TEST_ASSERT_EQUAL_UINT8(0x01, gActual[0]);
+  TEST_ASSERT_EQUAL_UINT8(0x01, gActual[1]);
+  TEST_ASSERT_EQUAL_UINT8(0x00, gActual[2]);
+  TEST_ASSERT_EQUAL_UINT8(0x00, gActual[4]);
+  // 0x01: only the last data slot of the second byte.
+  TEST_ASSERT_EQUAL_UINT8(0x00, gActual[24 + 1]);
+  TEST_ASSERT_EQUAL_UINT8(0x01, gActual[24 + 7 * 3 + 1]);
+  checkAgainstReference(lanes, counts, 1, luts);
+}
+
+void test_eight_lanes_unequal_counts() {
+  fillLanes(0x1234);
+  const uint8_t *lanes[kParallelLaneCount];
+  const uint8_t *luts[kParallelLaneCount];
+  uint16_t counts[kParallelLaneCount];
+  uint16_t longest = 0;
+  for (uint8_t lane = 0; lane < kParallelLaneCount; lane++) {
+    lanes[lane] = gLaneData[lane];
+    luts[lane] = gIdentityLut;
+    counts[lane] = static_cast<uint16_t>(kMaxLeds - lane * 7);
+    if (counts[lane] > longest) {
+      longest = counts[lane];
+    }
+  }
+  checkAgainstReference(lanes, counts, longest, luts);
+
+  // Past lane 7's last LED its high slot must drop out of the mask.
+  const size_t lastLed = counts[7];
+  TEST_ASSERT_EQUAL_UINT8(0x7F, gActual[lastLed * kParallelBytesPerLed]);
+}
+
+void test_null_lanes_stay_low() {
+  fillLanes(0xBEEF);
+  const uint8_t *lanes[kParallelLaneCount] = {nullptr};
+  const uint8_t *luts[kParallelLaneCount] = {nullptr};
+  uint16_t counts[kParallelLaneCount] = {0};
+  lanes[1] = gLaneData[1];
+  lanes[6] = gLaneData[6];
+  luts[1] = gIdentityLut;
+  luts[6] = gIdentityLut;
+  counts[1] = 20;
+  counts[6] = 20;
+  // A count without data is still an unused lane.
+  counts[3] = 20;
+  checkAgainstReference(lanes, counts, 20, luts);
+  for (size_t i = 0; i < 20 * kParallelBytesPerLed; i++) {
+    TEST_ASSERT_EQUAL_UINT8(0, gActual[i] & ~0x42);
+  }
+}
+
+void test_lane_luts_are_applied() {
+  fillLanes(0xCAFE);
+  const uint8_t *lanes[kParallelLaneCount];
+  const uint8_t *luts[kParallelLaneCount];
+  uint16_t counts[kParallelLaneCount];
+  for (uint8_t lane = 0; lane < kParallelLaneCount; lane++) {
+    lanes[lane] = gLaneData[lane];
+    luts[lane] = (lane & 1) ? gHalfLut : gIdentityLut;
+    counts[lane] = 16;
+  }
+  checkAgainstReference(lanes, counts, 16, luts);
+}
+
+void test_reset_tail_is_zero() {
+  fillLanes(0x55);
+  const uint8_t *lanes[kParallelLaneCount] = {gLaneData[0]};
+  const uint8_t *luts[kParallelLaneCount] = {gIdentityLut};
+  uint16_t counts[kParallelLaneCount] = {3};
+  memset(gActual, 0xFF, sizeof(gActual));
+  const size_t bytes = encodeParallelWs2812Frame(lanes, counts, 3, luts, gActual);
+  for (size_t i = bytes - kParallelResetBytes; i < bytes; i++) {
+    TEST_ASSERT_EQUAL_UINT8(0, gActual[i]);
+  }
+
+  // An empty frame is only the latch.
+  TEST_ASSERT_EQUAL_UINT(kParallelResetBytes, encodeParallelWs2812Frame(lanes, counts, 0, luts, gActual));
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_single_lane_bit_pattern);
+  RUN_TEST(test_eight_lanes_unequal_counts);
+  RUN_TEST(test_null_lanes_stay_low);
+  RUN_TEST(test_lane_luts_are_applied);
+  RUN_TEST(test_reset_tail_is_zero);
+  return UNITY_END();
+}
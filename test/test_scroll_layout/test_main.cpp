@@ -0,0 +1,225 @@
+#include <unity.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "scroll_layout.h"
+
+namespace {
+
+static const uint16_t kStripColumns = 512;
+static const uint8_t kSpacing = kScrollFont[2];
+
+uint8_t gMasks[kStripColumns];
+uint32_t gColors[kStripColumns];
+uint32_t gCharColors[64];
+
+const char *const kSamples[] = {
+  "Te", "To", "LT", "AV", "fa", "Tu", "F,",
+  "Promoção válida até sábado, 25 de outubro.",
+  "TAVERNA DO VOVÔ - PETISCOS, CAFÉ E AÇAÍ",
+  "Tv, rádio e jornal: vote já no seu favorito.",
+  "LYTTE, Yo! Vale. Tacos? Fe, fo, r.",
+};
+
+uint16_t layout(const char *text) {
+  return layoutScrollStrip(text, strlen(text), gCharColors, gMasks, gColors, kStripColumns);
+}
+
+uint8_t glyphWidth(uint32_t codePoint) {
+  return scrollFontGlyph(codePoint).width;
+}
+
+uint16_t pixelCount(const uint8_t *masks, uint16_t width) {
+  uint16_t count = 0;
+  for (uint16_t x = 0; x < width; x++) {
+    count += static_cast<uint16_t>(__builtin_popcount(masks[x]));
+  }
+  return count;
+}
+
+// Start column of every glyph, recovered from the widths of the text's
+// prefixes: each prefix ends with its last glyph plus spacing.
+uint8_t glyphStarts(const char *text, int32_t starts[64], ScrollGlyph glyphs[64]) {
+  const size_t length = strlen(text);
+  uint8_t count = 0;
+  for (size_t i = 0; i < length;) {
+    glyphs[count] = scrollFontGlyph(decodeUtf8(text, length, i));
+    const uint16_t width = layoutScrollStrip(text, i, gCharColors, gMasks, gColors, kStripColumns);
+    starts[count] = static_cast<int32_t>(width) - kSpacing - glyphs[count].width;
+    count++;
+  }
+  return count;
+}
+
+bool lit(const ScrollGlyph &glyph, int32_t start, int32_t x, int32_t row) {
+  if (x < start || x >= start + glyph.width || row < 0 || row > 7) {
+    return false;
+  }
+  return ((glyph.columns[x - start] >> row) & 1U) != 0;
+}
+
+}  // namespace
+
+void setUp() {
+  memset(gCharColors, 0, sizeof(gCharColors));
+}
+
+void tearDown() {}
+
+void test_utf8_decoding() {
+  size_t index = 0;
+  TEST_ASSERT_EQUAL_UINT32('A', decodeUtf8("A", 1, index));
+  TEST_ASSERT_EQUAL_UINT(1, index);
+
+  index = 0;
+  TEST_ASSERT_EQUAL_UINT32(0xE7, decodeUtf8("\xC3\xA7", 2, index));
+  TEST_ASSERT_EQUAL_UINT(2, index);
+
+  index = 0;
+  TEST_ASSERT_EQUAL_UINT32(0x20AC, decodeUtf8("\xE2\x82\xAC", 3, index));
+  TEST_ASSERT_EQUAL_UINT(3, index);
+
+  // Overlong, truncated and stray bytes each cost exactly one byte.
+  index = 0;
+  TEST_ASSERT_EQUAL_UINT32(0xFFFD, decodeUtf8("\xC0\x80", 2, index));
+  TEST_ASSERT_EQUAL_UINT(1, index);
+  index = 0;
+  TEST_ASSERT_EQUAL_UINT32(0xFFFD, decodeUtf8("\xE2\x82", 2, index));
+  TEST_ASSERT_EQUAL_UINT(1, index);
+  index = 0;
+  TEST_ASSERT_EQUAL_UINT32(0xFFFD, decodeUtf8("\x80", 1, index));
+  TEST_ASSERT_EQUAL_UINT(1, index);
+}
+
+void test_glyph_lookup() {
+  const uint16_t fallback = scrollFontGlyph('?').index;
+  TEST_ASSERT_TRUE(scrollFontGlyph(0xE7).index != fallback);
+  TEST_ASSERT_TRUE(scrollFontGlyph(0xC3).index != fallback);
+  TEST_ASSERT_EQUAL_UINT16(fallback, scrollFontGlyph(0x20AC).index);
+  TEST_ASSERT_EQUAL_UINT8(2, glyphWidth(' '));
+  TEST_ASSERT_LESS_THAN(glyphWidth('A'), glyphWidth('i'));
+}
+
+void test_kerning_magnitude_is_applied() {
+  const uint16_t natural = glyphWidth('T') + glyphWidth('e') + 2 * kSpacing;
+  TEST_ASSERT_EQUAL_INT8(-2, scrollFontKerning(scrollFontGlyph('T').index, scrollFontGlyph('e').index));
+  TEST_ASSERT_EQUAL_UINT16(natural - 2, layout("Te"));
+
+  TEST_ASSERT_EQUAL_UINT16(glyphWidth('T') + glyphWidth('u') + 2 * kSpacing - 1, layout("Tu"));
+
+  // No pair entry: plain advance.
+  TEST_ASSERT_EQUAL_UINT16(glyphWidth('a') + glyphWidth('b') + 2 * kSpacing, layout("ab"));
+}
+
+void test_kerning_stops_before_glyphs_touch() {
+  // A and V would touch side by side one column in, so the pair keeps its
+  // spacing column even though the font asks for -1.
+  TEST_ASSERT_TRUE(scrollFontKerning(scrollFontGlyph('A').index, scrollFontGlyph('V').index) < 0);
+  TEST_ASSERT_EQUAL_UINT16(glyphWidth('A') + glyphWidth('V') + 2 * kSpacing, layout("AV"));
+}
+
+void test_no_glyph_pixels_overlap_or_touch() {
+  for (const char *text : kSamples) {
+    int32_t starts[64];
+    ScrollGlyph glyphs[64];
+    const uint8_t count = glyphStarts(text, starts, glyphs);
+    const uint16_t width = layout(text);
+
+    uint16_t expectedPixels = 0;
+    for (uint8_t g = 0; g < count; g++) {
+      expectedPixels += pixelCount(glyphs[g].columns, glyphs[g].width);
+      if (g > 0) {
+        TEST_ASSERT_TRUE_MESSAGE(starts[g] > starts[g - 1], text);
+        TEST_ASSERT_TRUE_MESSAGE(starts[g] + glyphs[g].width > starts[g - 1] + glyphs[g - 1].width, text);
+      }
+      for (uint8_t other = 0; other < g; other++) {
+        for (int32_t x = starts[g]; x < starts[g] + glyphs[g].width; x++) {
+          for (int32_t row = 0; row < 8; row++) {
+            if (!lit(glyphs[g], starts[g], x, row)) {
+              continue;
+            }
+            const bool touches = lit(glyphs[other], starts[other], x, row) ||
+                                 lit(glyphs[other], starts[other], x - 1, row) ||
+                                 lit(glyphs[other], starts[other], x + 1, row) ||
+                                 lit(glyphs[other], starts[other], x, row - 1) ||
+                                 lit(glyphs[other], starts[other], x, row + 1);
+            TEST_ASSERT_FALSE_MESSAGE(touches, text);
+          }
+        }
+      }
+    }
+    // Nothing was lost or doubled when columns were shared.
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(expectedPixels, pixelCount(gMasks, width), text);
+  }
+}
+
+void test_shared_columns_keep_one_color() {
+  const char *text = "To";
+  const uint16_t sameColor = layout(text);
+  gCharColors[0] = 0xFF0000;
+  gCharColors[1] = 0x0000FF;
+  const uint16_t width = layout(text);
+  TEST_ASSERT_GREATER_OR_EQUAL(sameColor, width);
+
+  int32_t starts[64];
+  ScrollGlyph glyphs[64];
+  glyphStarts(text, starts, glyphs);
+  layout(text);
+  for (int32_t x = 0; x < width; x++) {
+    if (gMasks[x] == 0) {
+      continue;
+    }
+    const bool fromT = x < starts[0] + glyphs[0].width && glyphs[0].columns[x - starts[0]] != 0;
+    const bool fromO = x >= starts[1] && x < starts[1] + glyphs[1].width && glyphs[1].columns[x - starts[1]] != 0;
+    TEST_ASSERT_FALSE(fromT && fromO);
+    TEST_ASSERT_EQUAL_UINT32(fromT ? 0xFF0000 : 0x0000FF, gColors[x]);
+  }
+}
+
+void test_strip_stops_at_max_width() {
+  const char *text = "WWWWWWWWWW";
+  const uint16_t full = layout(text);
+  const uint16_t glyph = glyphWidth('W') + kSpacing;
+  TEST_ASSERT_EQUAL_UINT16(10 * glyph, full);
+  const uint16_t width = layoutScrollStrip(text, strlen(text), gCharColors, gMasks, gColors, 3 * glyph + 2);
+  TEST_ASSERT_EQUAL_UINT16(3 * glyph, width);
+}
+
+void test_portuguese_columns_per_char() {
+  const char *samples[] = {
+    "Promoção válida até sábado, 25 de outubro.",
+    "Atenção: próxima sessão às 19h30 na sala três.",
+    "Você está conectado à rede Wi-Fi do evento.",
+  };
+  uint32_t columns = 0;
+  uint32_t chars = 0;
+  for (const char *text : samples) {
+    columns += layout(text);
+    const size_t length = strlen(text);
+    for (size_t i = 0; i < length; chars++) {
+      decodeUtf8(text, length, i);
+    }
+  }
+  char message[64];
+  snprintf(message, sizeof(message), "%.2f columns per character", static_cast<double>(columns) / chars);
+  TEST_MESSAGE(message);
+  // The fixed font spent 6 columns on every character.
+  TEST_ASSERT_LESS_THAN(chars * 6, columns);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_utf8_decoding);
+  RUN_TEST(test_glyph_lookup);
+  RUN_TEST(test_kerning_magnitude_is_applied);
+  RUN_TEST(test_kerning_stops_before_glyphs_touch);
+  RUN_TEST(test_no_glyph_pixels_overlap_or_touch);
+  RUN_TEST(test_shared_columns_keep_one_color);
+  RUN_TEST(test_strip_stops_at_max_width);
+  RUN_TEST(test_portuguese_columns_per_char);
+  return UNITY_END();
+}
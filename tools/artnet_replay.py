@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+"""Replays captured Art-Net traffic against the matrix node.
+
+  replay   resend the Art-Net payloads (UDP port 6454) of a pcap capture to
+           the node, keeping the captured timing (--speed scales it)
+  poll     send ArtPoll and print the node's ArtPollReply packets
+  synth    write a pcap with a moving rainbow as ArtDmx (+ ArtSync), for
+           when no console capture is at hand
+
+Captures are classic pcap files (tcpdump -w, or Wireshark "pcap" format)
+with Ethernet, Linux cooked or raw IPv4 framing.
+
+Run:
+  python3 tools/artnet_replay.py synth show.pcap --leds 6720 --fps 44 --sync
+  python3 tools/artnet_replay.py replay show.pcap 192.168.1.50 [--loop]
+  python3 tools/artnet_replay.py poll 192.168.1.50
+"""
+
+import argparse
+import colorsys
+import socket
+import struct
+import sys
+import time
+
+PORT = 6454
+ART_NET_ID = b"Art-Net\x00"
+OP_POLL = 0x2000
+OP_POLL_REPLY = 0x2100
+OP_DMX = 0x5000
+OP_SYNC = 0x5200
+LEDS_PER_UNIVERSE = 170
+
+LINKTYPE_ETHERNET = 1
+LINKTYPE_RAW = 101
+LINKTYPE_LINUX_SLL = 113
+
+
+def read_pcap(path):
+    """Yields (timestamp, udp destination port, udp payload) per IPv4 UDP packet."""
+    with open(path, "rb") as f:
+        header = f.read(24)
+        magic = header[:4]
+        if magic in (b"\xd4\xc3\xb2\xa1", b"\x4d\x3c\xb2\xa1"):
+            endian = "<"
+        elif magic in (b"\xa1\xb2\xc3\xd4", b"\xa1\xb2\x3c\x4d"):
+            endian = ">"
+        else:
+            raise SystemExit("%s: not a classic pcap file" % path)
+        nanos = magic in (b"\x4d\x3c\xb2\xa1", b"\xa1\xb2\x3c\x4d")
+        linktype = struct.unpack(endian + "I", header[20:24])[0]
+        while True:
+            record = f.read(16)
+            if len(record) < 16:
+                return
+            sec, frac, incl, _ = struct.unpack(endian + "IIII", record)
+            frame = f.read(incl)
+            if linktype == LINKTYPE_ETHERNET:
+                if len(frame) < 14:
+                    continue
+                ethertype = struct.unpack(">H", frame[12:14])[0]
+                offset = 14
+                if ethertype == 0x8100:
+                    ethertype = struct.unpack(">H", frame[16:18])[0]
+                    offset = 18
+                if ethertype != 0x0800:
+                    continue
+            elif linktype == LINKTYPE_LINUX_SLL:
+                if len(frame) < 16 or struct.unpack(">H", frame[14:16])[0] != 0x0800:
+                    continue
+                offset = 16
+            elif linktype == LINKTYPE_RAW:
+                offset = 0
+            else:
+                raise SystemExit("%s: unsupported link type %d" % (path, linktype))
+            ip = frame[offset:]
+            if len(ip) < 20 or (ip[0] >> 4) != 4 or ip[9] != 17:
+                continue
+            udp = ip[(ip[0] & 0x0F) * 4:]
+            if len(udp) < 8:
+                continue
+            dst_port, udp_length = struct.unpack(">2xHH", udp[:6])
+            timestamp = sec + frac / (1e9 if nanos else 1e6)
+            yield timestamp, dst_port, udp[8:udp_length]
+
+
+def write_pcap(path, packets):
+    """Writes (timestamp, payload) pairs as UDP 6454 broadcasts over raw IPv4."""
+    with open(path, "wb") as f:
+        f.write(struct.pack("<IHHiIII", 0xA1B2C3D4, 2, 4, 0, 0, 65535, LINKTYPE_RAW))
+        for timestamp, payload in packets:
+            udp = struct.pack(">HHHH", PORT, PORT, 8 + len(payload), 0) + payload
+            ip = struct.pack(">BBHHHBBH4s4s", 0x45, 0, 20 + len(udp), 0, 0, 64, 17, 0,
+                             bytes((10, 0, 0, 1)), bytes((10, 255, 255, 255))) + udp
+            sec = int(timestamp)
+            f.write(struct.pack("<IIII", sec, int((timestamp - sec) * 1e6), len(ip), len(ip)))
+            f.write(ip)
+
+
+def art_dmx(port_address, sequence, channels):
+    if len(channels) % 2:
+        channels += b"\x00"
+    # SubUni then Net is the port-address in little-endian order.
+    return (ART_NET_ID + struct.pack("<H", OP_DMX) + struct.pack(">HBB", 14, sequence, 0) +
+            struct.pack("<H", port_address) + struct.pack(">H", len(channels)) + channels)
+
+
+def art_sync():
+    return ART_NET_ID + struct.pack("<H", OP_SYNC) + struct.pack(">HBB", 14, 0, 0)
+
+
+def art_poll():
+    return ART_NET_ID + struct.pack("<H", OP_POLL) + struct.pack(">HBB", 14, 0x02, 0x10)
+
+
+def replay(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    packets = [(t, p) for t, port, p in read_pcap(args.capture) if port == PORT and p.startswith(ART_NET_ID)]
+    if not packets:
+        raise SystemExit("%s: no Art-Net packets" % args.capture)
+    ops = {}
+    for _, payload in packets:
+        op = struct.unpack("<H", payload[8:10])[0]
+        ops[op] = ops.get(op, 0) + 1
+    sys.stderr.write("%d packets, %s\n" % (len(packets), ", ".join(
+        "op 0x%04x x%d" % (op, count) for op, count in sorted(ops.items()))))
+
+    loops = 0
+    while True:
+        first = packets[0][0]
+        started = time.monotonic()
+        for timestamp, payload in packets:
+            delay = (timestamp - first) / args.speed - (time.monotonic() - started)
+            if delay > 0:
+                time.sleep(delay)
+            sock.sendto(payload, (args.host, PORT))
+        loops += 1
+        elapsed = time.monotonic() - started
+        sys.stderr.write("pass %d: %d packets in %.2f s (%.0f pps)\n" %
+                         (loops, len(packets), elapsed, len(packets) / max(elapsed, 1e-6)))
+        if not args.loop:
+            return
+
+
+def poll(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("", PORT))
+    sock.settimeout(0.2)
+    sock.sendto(art_poll(), (args.host, PORT))
+    deadline = time.monotonic() + args.timeout
+    replies = 0
+    while time.monotonic() < deadline:
+        try:
+            payload, sender = sock.recvfrom(1024)
+        except socket.timeout:
+            continue
+        if not payload.startswith(ART_NET_ID) or struct.unpack("<H", payload[8:10])[0] != OP_POLL_REPLY:
+            continue
+        replies += 1
+        ports = payload[173]
+        first = ((payload[18] & 0x7F) << 8) | ((payload[19] & 0x0F) << 4)
+        port_addresses = [first | (payload[190 + i] & 0x0F) for i in range(ports)]
+        print("%s bind=%d ports=%s" % (sender[0], payload[211], port_addresses))
+        print("  short: %s" % payload[26:44].split(b"\x00")[0].decode(errors="replace"))
+        print("  long:  %s" % payload[44:108].split(b"\x00")[0].decode(errors="replace"))
+        print("  report: %s" % payload[108:172].split(b"\x00")[0].decode(errors="replace"))
+    if replies == 0:
+        raise SystemExit("no ArtPollReply from %s" % args.host)
+
+
+def synth(args):
+    universes = (args.leds + LEDS_PER_UNIVERSE - 1) // LEDS_PER_UNIVERSE
+    packets = []
+    timestamp = time.time()
+    sequence = 1
+    for frame in range(args.frames):
+        pixels = bytearray(args.leds * 3)
+        for i in range(args.leds):
+            r, g, b = colorsys.hsv_to_rgb(((i / args.leds) + frame / 200.0) % 1.0, 1.0, 1.0)
+            pixels[i * 3:i * 3 + 3] = bytes((int(r * 255), int(g * 255), int(b * 255)))
+        for u in range(universes):
+            channels = bytes(pixels[u * LEDS_PER_UNIVERSE * 3:(u + 1) * LEDS_PER_UNIVERSE * 3])
+            packets.append((timestamp, art_dmx(args.universe + u, sequence, channels)))
+        if args.sync:
+            packets.append((timestamp, art_sync()))
+        sequence = 1 if sequence == 255 else sequence + 1
+        timestamp += 1.0 / args.fps
+    write_pcap(args.capture, packets)
+    sys.stderr.write("%s: %d frames, %d universes, %d packets\n" % (args.capture, args.frames, universes,
+                                                                  len(packets)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    p = commands.add_parser("replay")
+    p.add_argument("capture")
+    p.add_argument("host")
+    p.add_argument("--speed", type=float, default=1.0, help="timing scale (2 = twice as fast)")
+    p.add_argument("--loop", action="store_true")
+    p.set_defaults(run=replay)
+
+    p = commands.add_parser("poll")
+    p.add_argument("host")
+    p.add_argument("--timeout", type=float, default=1.5)
+    p.set_defaults(run=poll)
+
+    p = commands.add_parser("synth")
+    p.add_argument("capture")
+    p.add_argument("--universe", type=int, default=0, help="first port-address (default 0)")
+    p.add_argument("--leds", type=int, default=128)
+    p.add_argument("--fps", type=float, default=44.0)
+    p.add_argument("--frames", type=int, default=440)
+    p.add_argument("--sync", action="store_true", help="follow every frame with ArtSync")
+    p.set_defaults(run=synth)
+
+    args = parser.parse_args()
+    args.run(args)
+
+
+if __name__ == "__main__":
+    main()
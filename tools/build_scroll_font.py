@@ -0,0 +1,346 @@
+#!/usr/bin/env python3
+"""Builds include/scroll_font.h, the packed proportional font used by the
+matrix scroller.
+
+Glyphs are drawn below as rows of '#' (lit) and '.' (dark). Six rows are the
+body (cell rows 1..6); eight rows also fill row 0 (accents over capitals) and
+row 7 (below the baseline). Blank columns are trimmed, so each glyph's art
+width only matters through its lit pixels.
+
+Blob layout, little-endian, one byte per column with the top row in bit 0:
+  u8 version, u8 height, u8 spacing, u8 range count,
+  u16 glyph count, u16 kerning pair count, u16 fallback glyph
+  ranges:   u16 first code point, u16 count, u16 first glyph
+  glyphs:   u16 column offset per glyph plus one end offset (width = delta)
+  kerning:  u16 left glyph, u16 right glyph, s8 advance adjust (sorted)
+  columns:  the glyph bitmaps
+
+Run: python3 tools/build_scroll_font.py > include/scroll_font.h
+"""
+
+import struct
+import sys
+
+HEIGHT = 8
+SPACING = 1
+# The firmware sizes its scroll strip for at most this many columns per glyph.
+MAX_WIDTH = 5
+SPACE_WIDTH = 2
+
+GLYPHS = {
+    ' ': [".....", ".....", ".....", ".....", ".....", "....."],
+    '!': ["..#..", "..#..", "..#..", "..#..", ".....", "..#.."],
+    '"': [".#.#.", ".#.#.", ".....", ".....", ".....", "....."],
+    '#': [".#.#.", "#####", ".#.#.", "#####", ".#.#.", "....."],
+    "'": ["..#..", "..#..", ".....", ".....", ".....", "....."],
+    '*': ["..#..", "#.#.#", ".###.", "#.#.#", "..#..", "....."],
+    '-': [".....", ".....", "#####", ".....", ".....", "....."],
+    '.': [".....", ".....", ".....", ".....", ".....", "..#.."],
+    '/': ["....#", "...#.", "..#..", ".#...", "#....", "....."],
+    '0': [".###.", "#...#", "#..##", "#.#.#", "##..#", ".###."],
+    '1': ["..#..", ".##..", "..#..", "..#..", "..#..", ".###."],
+    '2': [".###.", "#...#", "....#", "..##.", ".#...", "#####"],
+    '3': ["####.", "....#", "..##.", "....#", "#...#", ".###."],
+    '4': ["...#.", "..##.", ".#.#.", "#..#.", "#####", "...#."],
+    '5': ["#####", "#....", "####.", "....#", "#...#", ".###."],
+    '6': ["..###", ".#...", "####.", "#...#", "#...#", ".###."],
+    '7': ["#####", "....#", "...#.", "..#..", ".#...", ".#..."],
+    '8': [".###.", "#...#", ".###.", "#...#", "#...#", ".###."],
+    '9': [".###.", "#...#", "#...#", ".####", "....#", ".###."],
+    ':': [".....", "..#..", ".....", ".....", "..#..", "....."],
+    '<': ["...#.", "..#..", ".#...", "..#..", "...#.", "....."],
+    '>': [".#...", "..#..", "...#.", "..#..", ".#...", "....."],
+    '?': [".###.", "#...#", "...#.", "..#..", ".....", "..#.."],
+    '@': [".###.", "#...#", "#.###", "#.#.#", "#.##.", ".##.."],
+    'A': [".###.", "#...#", "#####", "#...#", "#...#", "#...#"],
+    'B': ["####.", "#...#", "####.", "#...#", "#...#", "####."],
+    'C': [".###.", "#...#", "#....", "#....", "#...#", ".###."],
+    'D': ["####.", "#...#", "#...#", "#...#", "#...#", "####."],
+    'E': ["#####", "#....", "####.", "#....", "#....", "#####"],
+    'F': ["#####", "#....", "####.", "#....", "#....", "#...."],
+    'G': [".###.", "#...#", "#....", "#..##", "#...#", ".####"],
+    'H': ["#...#", "#...#", "#####", "#...#", "#...#", "#...#"],
+    'I': ["#####", "..#..", "..#..", "..#..", "..#..", "#####"],
+    'J': ["....#", "....#", "....#", "#...#", "#...#", ".###."],
+    'K': ["#...#", "#..#.", "###..", "#..#.", "#...#", "#...#"],
+    'L': ["#....", "#....", "#....", "#....", "#....", "#####"],
+    'M': ["#...#", "##.##", "#.#.#", "#...#", "#...#", "#...#"],
+    'N': ["#...#", "##..#", "#.#.#", "#..##", "#...#", "#...#"],
+    'O': [".###.", "#...#", "#...#", "#...#", "#...#", ".###."],
+    'P': ["####.", "#...#", "####.", "#....", "#....", "#...."],
+    'Q': [".###.", "#...#", "#...#", "#.#.#", "#..#.", ".##.#"],
+    'R': ["####.", "#...#", "####.", "#..#.", "#...#", "#...#"],
+    'S': [".####", "#....", ".###.", "....#", "#...#", ".###."],
+    'T': ["#####", "..#..", "..#..", "..#..", "..#..", "..#.."],
+    'U': ["#...#", "#...#", "#...#", "#...#", "#...#", ".###."],
+    'V': ["#...#", "#...#", "#...#", "#...#", ".#.#.", "..#.."],
+    'W': ["#...#", "#...#", "#...#", "#.#.#", "##.##", "#...#"],
+    'X': ["#...#", ".#.#.", "..#..", "..#..", ".#.#.", "#...#"],
+    'Y': ["#...#", ".#.#.", "..#..", "..#..", "..#..", "..#.."],
+    'Z': ["#####", "...#.", "..#..", ".#...", "#....", "#####"],
+    '[': [".###.", ".#...", ".#...", ".#...", ".###.", "....."],
+    '\\': ["#....", ".#...", "..#..", "...#.", "....#", "....."],
+    ']': [".###.", "...#.", "...#.", "...#.", ".###.", "....."],
+    '_': [".....", ".....", ".....", ".....", ".....", "#####"],
+    'a': [".....", ".###.", "....#", ".####", "#...#", ".####"],
+    'b': ["#....", "#....", "####.", "#...#", "#...#", "####."],
+    'c': [".....", ".###.", "#...#", "#....", "#...#", ".###."],
+    'd': ["....#", "....#", ".####", "#...#", "#...#", ".####"],
+    'e': [".....", ".###.", "#...#", "#####", "#....", ".###."],
+    'f': ["..##.", ".#...", "####.", ".#...", ".#...", ".#..."],
+    'g': [".....", ".####", "#...#", ".####", "....#", ".###."],
+    'h': ["#....", "#....", "####.", "#...#", "#...#", "#...#"],
+    'i': ["..#..", ".....", ".##..", "..#..", "..#..", ".###."],
+    'j': ["...#.", ".....", "...#.", "...#.", "#..#.", ".##.."],
+    'k': ["#....", "#..#.", "#.#..", "##...", "#.#..", "#..#."],
+    'l': [".##..", "..#..", "..#..", "..#..", "..#..", ".###."],
+    'm': [".....", "##.#.", "#.#.#", "#.#.#", "#.#.#", "#.#.#"],
+    'n': [".....", "####.", "#...#", "#...#", "#...#", "#...#"],
+    'o': [".....", ".###.", "#...#", "#...#", "#...#", ".###."],
+    'p': [".....", "####.", "#...#", "####.", "#....", "#...."],
+    'q': [".....", ".####", "#...#", ".####", "....#", "....#"],
+    'r': [".....", "#.##.", "##..#", "#....", "#....", "#...."],
+    's': [".....", ".####", "#....", ".###.", "....#", "####."],
+    't': [".#...", "####.", ".#...", ".#...", ".#...", "..##."],
+    'u': [".....", "#...#", "#...#", "#...#", "#..##", ".##.#"],
+    'v': [".....", "#...#", "#...#", "#...#", ".#.#.", "..#.."],
+    'w': [".....", "#...#", "#...#", "#.#.#", "#.#.#", ".#.#."],
+    'x': [".....", "#...#", ".#.#.", "..#..", ".#.#.", "#...#"],
+    'y': [".....", "#...#", "#...#", ".####", "....#", ".###."],
+    'z': [".....", "#####", "...#.", "..#..", ".#...", "#####"],
+
+    '$': [".####", "#.#..", ".###.", "..#.#", "####.", "..#.."],
+    '%': ["##..#", "##.#.", "..#..", ".#.##", "#..##", "....."],
+    '&': [".#...", "#.#..", ".#...", "#.#.#", "#..#.", ".##.#"],
+    '(': ["..#", ".#.", ".#.", ".#.", ".#.", "..#"],
+    ')': ["#..", ".#.", ".#.", ".#.", ".#.", "#.."],
+    '+': [".....", "..#..", "#####", "..#..", ".....", "....."],
+    ',': ["..", "..", "..", "..", "..", "..", ".#", "#."],
+    ';': ["..", "..", ".#", "..", "..", ".#", ".#", "#."],
+    '=': ["....", "####", "....", "####", "....", "...."],
+    '^': ["..#..", ".#.#.", ".....", ".....", ".....", "....."],
+    '`': ["#.", ".#", "..", "..", "..", ".."],
+    '{': [".##", ".#.", "##.", ".#.", ".#.", ".##"],
+    '|': ["#", "#", "#", "#", "#", "#"],
+    '}': ["##.", ".#.", ".##", ".#.", ".#.", "##."],
+    '~': [".##.#", "#..#.", ".....", ".....", ".....", "....."],
+    '¡': ["#", ".", "#", "#", "#", "#"],
+    '¢': ["..#..", ".###.", "#.#..", "#.#..", ".###.", "..#.."],
+    '£': ["..##.", ".#...", "####.", ".#...", ".#..#", "####."],
+    '¤': [".....", "#...#", ".###.", ".#.#.", ".###.", "#...#"],
+    '¥': ["#...#", ".#.#.", "#####", "..#..", "#####", "..#.."],
+    '¦': ["#", "#", ".", ".", "#", "#"],
+    '§': [".###", "#...", ".##.", ".##.", "...#", "###."],
+    '¨': ["#.#", "...", "...", "...", "...", "..."],
+    '©': [".###.", "#.###", "##..#", "##..#", "#.###", ".###."],
+    'ª': [".##", "#.#", ".##", "###", "...", "..."],
+    '«': ["....", ".#.#", "#.#.", ".#.#", "....", "...."],
+    '¬': ["....", "....", "####", "...#", "....", "...."],
+    '\u00ad': ["...", "...", "###", "...", "...", "..."],
+    '®': [".###.", "###.#", "##.##", "###.#", "##.##", ".###."],
+    '¯': ["####", "....", "....", "....", "....", "...."],
+    '°': [".#.", "#.#", ".#.", "...", "...", "..."],
+    '±': ["..#..", "#####", "..#..", ".....", "#####", "....."],
+    '²': ["##.", "..#", ".#.", "###", "...", "..."],
+    '³': ["###", ".##", "..#", "###", "...", "..."],
+    '´': [".#", "#.", "..", "..", "..", ".."],
+    'µ': ["....", "#..#", "#..#", "#..#", "###.", "#...", "#...", "...."],
+    '¶': [".####", "###.#", "###.#", ".##.#", "..#.#", "..#.#"],
+    '·': [".", ".", "#", ".", ".", "."],
+    '¸': ["..", "..", "..", "..", "..", "..", ".#", "##"],
+    '¹': [".#", "##", ".#", ".#", "..", ".."],
+    'º': [".#.", "#.#", ".#.", "###", "...", "..."],
+    '»': ["....", "#.#.", ".#.#", "#.#.", "....", "...."],
+    '¼': ["#...#", "#..#.", "#.#..", ".#.#.", "#.###", "....#"],
+    '½': ["#...#", "#..#.", "#.##.", ".#..#", "#..#.", "...##"],
+    '¾': ["##..#", ".#.#.", "###..", ".#.#.", "#.###", "....#"],
+    '¿': ["..#..", ".....", "..#..", ".#...", "#...#", ".###."],
+    'Æ': [".####", "#.#..", "####.", "#.#..", "#.#..", "#.###"],
+    'Ð': ["####.", ".#..#", "###.#", ".#..#", ".#..#", "####."],
+    '×': ["...", "#.#", ".#.", "#.#", "...", "..."],
+    'Ø': [".###.", "#..##", "#.#.#", "#.#.#", "##..#", ".###."],
+    'Þ': ["#....", "####.", "#...#", "####.", "#....", "#...."],
+    'ß': [".##.", "#..#", "#.#.", "#..#", "#..#", "#.#."],
+    'æ': [".....", "##.#.", "..#.#", ".####", "#.#..", ".#.##"],
+    'ð': ["...#.", "..###", ".####", "#...#", "#...#", ".###."],
+    '÷': ["..#..", ".....", "#####", ".....", "..#..", "....."],
+    'ø': [".....", ".####", "#..##", "#.#.#", "##..#", "####."],
+    'þ': ["#....", "####.", "#...#", "####.", "#....", "#...."],
+    'ı': [".....", ".....", ".##..", "..#..", "..#..", ".###."],
+}
+
+# Capitals only have row 0 free, lowercase has rows 0 and 1.
+UPPER_ACCENTS = {
+    'grave': [".#..."],
+    'acute': ["...#."],
+    'circumflex': [".###."],
+    'tilde': ["##.##"],
+    'diaeresis': [".#.#."],
+    'ring': ["..#.."],
+}
+LOWER_ACCENTS = {
+    'grave': [".#...", "..#.."],
+    'acute': ["...#.", "..#.."],
+    'circumflex': ["..#..", ".#.#."],
+    'tilde': [".##.#", "#..#."],
+    'diaeresis': [".....", ".#.#."],
+    'ring': [".###.", ".#.#."],
+}
+CEDILLA = "..#.."
+
+COMPOSED = {
+    'À': ('A', 'grave'), 'Á': ('A', 'acute'), 'Â': ('A', 'circumflex'),
+    'Ã': ('A', 'tilde'), 'Ä': ('A', 'diaeresis'), 'Å': ('A', 'ring'),
+    'Ç': ('C', 'cedilla'),
+    'È': ('E', 'grave'), 'É': ('E', 'acute'), 'Ê': ('E', 'circumflex'), 'Ë': ('E', 'diaeresis'),
+    'Ì': ('I', 'grave'), 'Í': ('I', 'acute'), 'Î': ('I', 'circumflex'), 'Ï': ('I', 'diaeresis'),
+    'Ñ': ('N', 'tilde'),
+    'Ò': ('O', 'grave'), 'Ó': ('O', 'acute'), 'Ô': ('O', 'circumflex'),
+    'Õ': ('O', 'tilde'), 'Ö': ('O', 'diaeresis'),
+    'Ù': ('U', 'grave'), 'Ú': ('U', 'acute'), 'Û': ('U', 'circumflex'), 'Ü': ('U', 'diaeresis'),
+    'Ý': ('Y', 'acute'),
+    'à': ('a', 'grave'), 'á': ('a', 'acute'), 'â': ('a', 'circumflex'),
+    'ã': ('a', 'tilde'), 'ä': ('a', 'diaeresis'), 'å': ('a', 'ring'),
+    'ç': ('c', 'cedilla'),
+    'è': ('e', 'grave'), 'é': ('e', 'acute'), 'ê': ('e', 'circumflex'), 'ë': ('e', 'diaeresis'),
+    'ì': ('ı', 'grave'), 'í': ('ı', 'acute'), 'î': ('ı', 'circumflex'),
+    'ï': ('ı', 'diaeresis'),
+    'ñ': ('n', 'tilde'),
+    'ò': ('o', 'grave'), 'ó': ('o', 'acute'), 'ô': ('o', 'circumflex'),
+    'õ': ('o', 'tilde'), 'ö': ('o', 'diaeresis'),
+    'ù': ('u', 'grave'), 'ú': ('u', 'acute'), 'û': ('u', 'circumflex'), 'ü': ('u', 'diaeresis'),
+    'ý': ('y', 'acute'), 'ÿ': ('y', 'diaeresis'),
+}
+
+# No-break space draws like a space.
+ALIASES = {'\u00a0': ' '}
+
+# Pairs whose default gap looks too wide; adjust is added to the advance.
+# Advance adjust in columns. The firmware applies as much of it as it can
+# without the two glyphs' pixels overlapping or touching.
+KERNING = [
+    ('A', 'T', -1), ('A', 'V', -1), ('A', 'Y', -1), ('A', 'W', -1),
+    ('T', 'A', -1), ('V', 'A', -1), ('Y', 'A', -1), ('W', 'A', -1),
+    ('L', 'T', -2), ('L', 'V', -2), ('L', 'Y', -2),
+    ('T', 'a', -2), ('T', 'c', -2), ('T', 'e', -2), ('T', 'o', -2),
+    ('T', 's', -2), ('T', 'u', -1), ('T', 'y', -1),
+    ('Y', 'a', -2), ('Y', 'e', -2), ('Y', 'o', -2),
+    ('V', 'a', -1), ('V', 'e', -1), ('V', 'o', -1),
+    ('F', '.', -1), ('F', ',', -2), ('P', '.', -1), ('P', ',', -2),
+    ('T', '.', -1), ('T', ',', -2), ('V', '.', -1), ('V', ',', -2),
+    ('Y', '.', -1), ('Y', ',', -2), ('r', '.', -1), ('r', ',', -2),
+    ('f', 'o', -1), ('f', 'e', -1), ('f', 'a', -2),
+]
+
+
+def cell(art):
+    """Returns the glyph as HEIGHT rows of equal width."""
+    rows = list(art)
+    if len(rows) == 6:
+        width = len(rows[0])
+        rows = ['.' * width] + rows + ['.' * width]
+    if len(rows) != HEIGHT or len({len(r) for r in rows}) != 1:
+        raise SystemExit('bad glyph art: %r' % (art,))
+    return rows
+
+
+def overlay(rows, top, patterns):
+    out = [list(r) for r in rows]
+    for i, pattern in enumerate(patterns):
+        for x, ch in enumerate(pattern):
+            if ch == '#' and x < len(out[top + i]):
+                out[top + i][x] = '#'
+    return [''.join(r) for r in out]
+
+
+def compose(base, mark):
+    rows = cell(GLYPHS[base])
+    if mark == 'cedilla':
+        return overlay(rows, HEIGHT - 1, [CEDILLA])
+    if base.isupper():
+        return overlay(rows, 0, UPPER_ACCENTS[mark])
+    return overlay(rows, 0, LOWER_ACCENTS[mark])
+
+
+def columns(rows, code_point):
+    width = len(rows[0])
+    masks = []
+    for x in range(width):
+        mask = 0
+        for y in range(HEIGHT):
+            if rows[y][x] == '#':
+                mask |= 1 << y
+        masks.append(mask)
+    if code_point == 0x20:
+        return [0] * SPACE_WIDTH
+    while masks and masks[0] == 0:
+        masks.pop(0)
+    while masks and masks[-1] == 0:
+        masks.pop()
+    return masks
+
+
+def build():
+    table = {}
+    for ch, art in GLYPHS.items():
+        table[ord(ch)] = columns(cell(art), ord(ch))
+    for ch, (base, mark) in COMPOSED.items():
+        table[ord(ch)] = columns(compose(base, mark), ord(ch))
+    for ch, target in ALIASES.items():
+        table[ord(ch)] = table[ord(target)]
+    # The dotless i is only a building block.
+    del table[0x131]
+
+    wide = [chr(cp) for cp, masks in table.items() if len(masks) > MAX_WIDTH]
+    if wide:
+        raise SystemExit('glyphs wider than %d columns: %s' % (MAX_WIDTH, ' '.join(wide)))
+
+    missing = [cp for cp in list(range(0x20, 0x7F)) + list(range(0xA0, 0x100)) if cp not in table]
+    if missing:
+        raise SystemExit('missing glyphs: %s' % ', '.join('U+%04X' % cp for cp in missing))
+
+    code_points = sorted(table)
+    ranges = []
+    for cp in code_points:
+        if ranges and ranges[-1][0] + ranges[-1][1] == cp:
+            ranges[-1][1] += 1
+        else:
+            ranges.append([cp, 1, code_points.index(cp)])
+    glyph_index = {cp: i for i, cp in enumerate(code_points)}
+
+    offsets = []
+    bitmap = []
+    for cp in code_points:
+        offsets.append(len(bitmap))
+        bitmap.extend(table[cp])
+    offsets.append(len(bitmap))
+
+    kerning = sorted((glyph_index[ord(a)], glyph_index[ord(b)], adjust) for a, b, adjust in KERNING)
+
+    blob = bytearray()
+    blob += struct.pack('<BBBBHHH', 1, HEIGHT, SPACING, len(ranges), len(code_points), len(kerning),
+                        glyph_index[ord('?')])
+    for first, count, first_glyph in ranges:
+        blob += struct.pack('<HHH', first, count, first_glyph)
+    for offset in offsets:
+        blob += struct.pack('<H', offset)
+    for left, right, adjust in kerning:
+        blob += struct.pack('<HHb', left, right, adjust)
+    blob += bytes(bitmap)
+    return blob, len(code_points), len(kerning)
+
+
+def main():
+    blob, glyphs, pairs = build()
+    out = sys.stdout
+    out.write('// Generated by tools/build_scroll_font.py; edit the glyph art there.\n')
+    out.write('// %d glyphs (ASCII + Latin-1), %d kerning pairs, %d bytes.\n' % (glyphs, pairs, len(blob)))
+    out.write('#pragma once\n\n#include <stdint.h>\n\n')
+    out.write('static const uint8_t kScrollFont[] = {\n')
+    for i in range(0, len(blob), 16):
+        out.write('  ' + ', '.join('0x%02X' % b for b in blob[i:i + 16]) + ',\n')
+    out.write('};\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Sends a moving rainbow to the matrix over DDP, or queries its size.
+
+The canvas is addressed row by row (x first), so one frame of 6720 RGB
+pixels is 14 packets of up to 480 pixels; the last one sets PUSH.
+
+Run:
+  python3 tools/ddp_sender.py 192.168.1.50 --pixels 6720 --fps 40
+  python3 tools/ddp_sender.py 192.168.1.50 --query
+"""
+
+import argparse
+import colorsys
+import json
+import socket
+import struct
+import sys
+import time
+
+PORT = 4048
+PIXELS_PER_PACKET = 480
+FLAG_VERSION1 = 0x40
+FLAG_REPLY = 0x04
+FLAG_QUERY = 0x02
+FLAG_PUSH = 0x01
+TYPE_RGB8 = 0x0B
+ID_DISPLAY = 1
+ID_CONFIG = 250
+ID_STATUS = 251
+
+
+def header(flags, sequence, data_type, dest, offset, length):
+    return struct.pack(">BBBBIH", flags, sequence, data_type, dest, offset, length)
+
+
+def query(sock, host, timeout):
+    for dest in (ID_STATUS, ID_CONFIG):
+        sock.sendto(header(FLAG_VERSION1 | FLAG_QUERY, 0, 0, dest, 0, 0), (host, PORT))
+        sock.settimeout(timeout)
+        try:
+            payload, _ = sock.recvfrom(1500)
+        except socket.timeout:
+            raise SystemExit("no reply from %s for id %d" % (host, dest))
+        if len(payload) < 10 or not payload[0] & FLAG_REPLY:
+            raise SystemExit("unexpected reply: %r" % payload[:16])
+        length = struct.unpack(">H", payload[8:10])[0]
+        print(json.dumps(json.loads(payload[10:10 + length]), indent=2))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host")
+    parser.add_argument("--pixels", type=int, default=128, help="canvas width * height (default 128)")
+    parser.add_argument("--fps", type=float, default=40.0)
+    parser.add_argument("--frames", type=int, default=0, help="stop after this many frames (0 = forever)")
+    parser.add_argument("--query", action="store_true", help="print the status and config replies and exit")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    if args.query:
+        sock.bind(("", PORT))
+        query(sock, args.host, 1.0)
+        return
+
+    sequence = 1
+    period = 1.0 / args.fps
+    next_frame = time.monotonic()
+    started = next_frame
+    frame = 0
+    while args.frames == 0 or frame < args.frames:
+        pixels = bytearray(args.pixels * 3)
+        for i in range(args.pixels):
+            r, g, b = colorsys.hsv_to_rgb(((i / args.pixels) + frame / 200.0) % 1.0, 1.0, 1.0)
+            pixels[i * 3:i * 3 + 3] = bytes((int(r * 255), int(g * 255), int(b * 255)))
+        for first in range(0, args.pixels, PIXELS_PER_PACKET):
+            chunk = bytes(pixels[first * 3:(first + PIXELS_PER_PACKET) * 3])
+            last = first + PIXELS_PER_PACKET >= args.pixels
+            flags = FLAG_VERSION1 | (FLAG_PUSH if last else 0)
+            sock.sendto(header(flags, sequence, TYPE_RGB8, ID_DISPLAY, first * 3, len(chunk)) + chunk,
+                        (args.host, PORT))
+            sequence = 1 if sequence == 15 else sequence + 1
+        frame += 1
+        if frame % int(max(args.fps, 1)) == 0:
+            elapsed = time.monotonic() - started
+            sys.stderr.write("%d frames, %.1f fps\n" % (frame, frame / elapsed))
+        next_frame += period
+        delay = next_frame - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+        else:
+            next_frame = time.monotonic()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""Sends a moving rainbow to the matrix over E1.31 (sACN) unicast.
+
+Each frame is split into universes of 170 RGB LEDs starting at --universe,
+the same order the firmware maps them onto its outputs. With --sync the
+data packets carry a sync address and the frame is only shown when the
+following sync packet arrives.
+
+Run: python3 tools/e131_sender.py 192.168.1.50 --leds 6720 --fps 40 [--sync]
+"""
+
+import argparse
+import colorsys
+import socket
+import struct
+import sys
+import time
+import uuid
+
+PORT = 5568
+LEDS_PER_UNIVERSE = 170
+ACN_PACKET_ID = b"ASC-E1.17\x00\x00\x00"
+VECTOR_ROOT_DATA = 0x00000004
+VECTOR_ROOT_EXTENDED = 0x00000008
+VECTOR_FRAMING_DATA = 0x00000002
+VECTOR_FRAMING_SYNC = 0x00000001
+
+
+def flags_length(length):
+    return 0x7000 | length
+
+
+def root_layer(cid, vector, payload_length):
+    body = struct.pack(">HH12s", 0x0010, 0x0000, ACN_PACKET_ID)
+    body += struct.pack(">HI16s", flags_length(22 + payload_length), vector, cid)
+    return body
+
+
+def data_packet(cid, source, universe, sequence, sync_address, channels):
+    dmp = struct.pack(">HBBHHH", flags_length(10 + 1 + len(channels)), 0x02, 0xA1, 0, 1, 1 + len(channels))
+    dmp += b"\x00" + channels
+    framing = struct.pack(">HI64sBHBBH", flags_length(77 + len(dmp)), VECTOR_FRAMING_DATA, source, 100,
+                          sync_address, sequence, 0, universe)
+    return root_layer(cid, VECTOR_ROOT_DATA, len(framing) + len(dmp)) + framing + dmp
+
+
+def sync_packet(cid, sequence, sync_address):
+    framing = struct.pack(">HIBHH", flags_length(11), VECTOR_FRAMING_SYNC, sequence, sync_address, 0)
+    return root_layer(cid, VECTOR_ROOT_EXTENDED, len(framing)) + framing
+
+
+def rainbow(leds, phase):
+    out = bytearray(leds * 3)
+    for i in range(leds):
+        r, g, b = colorsys.hsv_to_rgb(((i / leds) + phase) % 1.0, 1.0, 1.0)
+        out[i * 3:i * 3 + 3] = bytes((int(r * 255), int(g * 255), int(b * 255)))
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host")
+    parser.add_argument("--universe", type=int, default=1, help="first universe (default 1)")
+    parser.add_argument("--leds", type=int, default=128, help="total LEDs (default 128)")
+    parser.add_argument("--fps", type=float, default=40.0)
+    parser.add_argument("--frames", type=int, default=0, help="stop after this many frames (0 = forever)")
+    parser.add_argument("--sync", action="store_true", help="present frames with sync packets")
+    args = parser.parse_args()
+
+    universes = (args.leds + LEDS_PER_UNIVERSE - 1) // LEDS_PER_UNIVERSE
+    sync_address = args.universe + universes if args.sync else 0
+    cid = uuid.uuid4().bytes
+    source = b"e131_sender.py"
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sequences = [0] * universes
+    sync_sequence = 0
+    period = 1.0 / args.fps
+    next_frame = time.monotonic()
+    frame = 0
+    started = next_frame
+
+    while args.frames == 0 or frame < args.frames:
+        pixels = rainbow(args.leds, frame / 200.0)
+        for i in range(universes):
+            channels = pixels[i * LEDS_PER_UNIVERSE * 3:(i + 1) * LEDS_PER_UNIVERSE * 3]
+            sock.sendto(data_packet(cid, source, args.universe + i, sequences[i], sync_address, channels),
+                        (args.host, PORT))
+            sequences[i] = (sequences[i] + 1) & 0xFF
+        if args.sync:
+            sock.sendto(sync_packet(cid, sync_sequence, sync_address), (args.host, PORT))
+            sync_sequence = (sync_sequence + 1) & 0xFF
+        frame += 1
+        if frame % int(max(args.fps, 1)) == 0:
+            elapsed = time.monotonic() - started
+            sys.stderr.write("%d frames, %.1f fps, %d universes\n" % (frame, frame / elapsed, universes))
+        next_frame += period
+        delay = next_frame - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+        else:
+            next_frame = time.monotonic()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""Loads the web server with concurrent clients and reports req/s and latency.
+
+Each client thread sends GET requests back to back on its own connection,
+reusing it while the server keeps it open and reconnecting when it does
+not. Run it against two firmware builds to compare them. With --etag each
+client revalidates with the last ETag it got, like a browser polling.
+
+Run: python3 tools/http_bench.py 192.168.1.50 --clients 8 --seconds 10 [--path /api/state] [--etag]
+"""
+
+import argparse
+import http.client
+import threading
+import time
+
+
+def percentile(values, fraction):
+    if not values:
+        return 0.0
+    index = min(len(values) - 1, int(round(fraction * (len(values) - 1))))
+    return values[index]
+
+
+def client(host, port, path, etag_mode, deadline, latencies, counters, lock):
+    conn = None
+    local = []
+    errors = 0
+    connects = 0
+    body_bytes = 0
+    not_modified = 0
+    etag = None
+    while time.monotonic() < deadline:
+        if conn is None:
+            conn = http.client.HTTPConnection(host, port, timeout=5)
+            connects += 1
+        started = time.monotonic()
+        try:
+            headers = {"If-None-Match": etag} if etag_mode and etag else {}
+            conn.request("GET", path, headers=headers)
+            response = conn.getresponse()
+            body_bytes += len(response.read())
+            if response.status == 304:
+                not_modified += 1
+            elif response.status != 200:
+                errors += 1
+            else:
+                etag = response.getheader("ETag")
+            local.append(time.monotonic() - started)
+            if response.will_close:
+                conn.close()
+                conn = None
+        except (OSError, http.client.HTTPException):
+            errors += 1
+            conn.close()
+            conn = None
+    if conn is not None:
+        conn.close()
+    with lock:
+        latencies.extend(local)
+        counters["errors"] += errors
+        counters["connects"] += connects
+        counters["bytes"] += body_bytes
+        counters["not_modified"] += not_modified
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--path", default="/api/state")
+    parser.add_argument("--clients", type=int, default=8)
+    parser.add_argument("--seconds", type=float, default=10.0)
+    parser.add_argument("--etag", action="store_true", help="send If-None-Match with the last ETag")
+    args = parser.parse_args()
+
+    latencies = []
+    counters = {"errors": 0, "connects": 0, "bytes": 0, "not_modified": 0}
+    lock = threading.Lock()
+    started = time.monotonic()
+    deadline = started + args.seconds
+    threads = [threading.Thread(target=client,
+                                args=(args.host, args.port, args.path, args.etag, deadline, latencies, counters, lock))
+               for _ in range(args.clients)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.monotonic() - started
+
+    latencies.sort()
+    print("%s%s, %d clients, %.1f s" % (args.host, args.path, args.clients, elapsed))
+    print("requests %d (%.1f req/s), errors %d, connections %d" %
+          (len(latencies), len(latencies) / elapsed, counters["errors"], counters["connects"]))
+    print("body bytes/request %.0f, not modified %d" %
+          (counters["bytes"] / max(len(latencies), 1), counters["not_modified"]))
+    print("latency ms: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f" %
+          (percentile(latencies, 0.50) * 1000, percentile(latencies, 0.90) * 1000,
+           percentile(latencies, 0.99) * 1000, (latencies[-1] if latencies else 0.0) * 1000))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Streams a moving rainbow to the matrix over USB serial (Adalight or TPM2).
+
+The board's USB port is CDC-ACM, so the baud rate does not matter and the
+device file is written directly (no pyserial needed). Pixels run row by row
+over the canvas, like DDP. Enable the receiver first with
+GET /api/matrix?serial=1.
+
+Run: python3 tools/serial_sender.py /dev/ttyACM0 --pixels 2048 --fps 60 [--tpm2]
+"""
+
+import argparse
+import colorsys
+import os
+import sys
+import termios
+import time
+import tty
+
+
+def adalight_frame(pixels):
+    count = len(pixels) // 3 - 1
+    hi, lo = count >> 8, count & 0xFF
+    return b"Ada" + bytes((hi, lo, hi ^ lo ^ 0x55)) + pixels
+
+
+def tpm2_frame(pixels):
+    return bytes((0xC9, 0xDA, len(pixels) >> 8, len(pixels) & 0xFF)) + pixels + b"\x36"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="serial device, e.g. /dev/ttyACM0")
+    parser.add_argument("--pixels", type=int, default=128, help="canvas width * height (default 128)")
+    parser.add_argument("--fps", type=float, default=60.0)
+    parser.add_argument("--frames", type=int, default=0, help="stop after this many frames (0 = forever)")
+    parser.add_argument("--tpm2", action="store_true", help="send TPM2 instead of Adalight")
+    args = parser.parse_args()
+    if args.tpm2 and args.pixels * 3 > 0xFFFF:
+        raise SystemExit("TPM2 frames hold at most 21845 pixels")
+
+    fd = os.open(args.port, os.O_WRONLY | os.O_NOCTTY)
+    if os.isatty(fd):
+        tty.setraw(fd)
+        termios.tcflush(fd, termios.TCOFLUSH)
+    encode = tpm2_frame if args.tpm2 else adalight_frame
+    period = 1.0 / args.fps
+    next_frame = time.monotonic()
+    started = next_frame
+    frame = 0
+    try:
+        while args.frames == 0 or frame < args.frames:
+            pixels = bytearray(args.pixels * 3)
+            for i in range(args.pixels):
+                r, g, b = colorsys.hsv_to_rgb(((i / args.pixels) + frame / 200.0) % 1.0, 1.0, 1.0)
+                pixels[i * 3:i * 3 + 3] = bytes((int(r * 255), int(g * 255), int(b * 255)))
+            data = encode(bytes(pixels))
+            while data:
+                data = data[os.write(fd, data):]
+            frame += 1
+            if frame % int(max(args.fps, 1)) == 0:
+                elapsed = time.monotonic() - started
+                sys.stderr.write("%d frames, %.1f fps\n" % (frame, frame / elapsed))
+            next_frame += period
+            delay = next_frame - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            else:
+                next_frame = time.monotonic()
+    finally:
+        os.close(fd)
+
+
+if __name__ == "__main__":
+    main()